@@ -6,6 +6,15 @@
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/chassis/trackingWheel.hpp" // IWYU pragma: keep
 #include "lemlib/logger/logger.hpp" // IWYU pragma: keep
+#include "lemlib/periodic.hpp" // IWYU pragma: keep
+#include "lemlib/mechanisms/ringClassifier.hpp" // IWYU pragma: keep
+#include "lemlib/mechanisms/colorSort.hpp" // IWYU pragma: keep
+#include "lemlib/mechanisms/jamDetector.hpp" // IWYU pragma: keep
+#include "lemlib/mechanisms/ringInventory.hpp" // IWYU pragma: keep
+#include "lemlib/mechanisms/arm.hpp" // IWYU pragma: keep
+#include "lemlib/taskMonitor.hpp" // IWYU pragma: keep
+#include "lemlib/macro.hpp" // IWYU pragma: keep
+#include "lemlib/controllerBindings.hpp" // IWYU pragma: keep
 
 // using to shorten lemlib::AngularDirection to just AngularDirection
 using lemlib::AngularDirection;
@@ -0,0 +1,127 @@
+#pragma once
+
+namespace lemlib {
+/**
+ * @brief Change in every odometry sensor over one calibration segment
+ *
+ * Tracking wheel and drivetrain distances are what the wheels report with their configured diameter, so they are off
+ * by however wrong the diameter is. Sensors that don't exist are left at 0.
+ */
+struct CalibrationSegment {
+        float vertical1 = 0;
+        float vertical2 = 0;
+        float horizontal1 = 0;
+        float horizontal2 = 0;
+        /** left side of the drivetrain, in inches */
+        float left = 0;
+        /** right side of the drivetrain, in inches */
+        float right = 0;
+        /** change in heading measured by the IMU, in radians, clockwise positive */
+        float heading = 0;
+};
+
+/**
+ * @brief Calibrated values of a single wheel
+ */
+struct WheelCalibration {
+        /** false if the segments don't say enough about the wheel to solve for it */
+        bool valid = false;
+        /** true diameter as a fraction of the configured diameter */
+        float scale = 1;
+        /** offset from the tracking center, same as lemlib::TrackingWheel, using the calibrated diameter */
+        float offset = 0;
+        /** root mean square error of the fit, in inches. Large values mean the wheel slipped or the data is bad */
+        float error = 0;
+};
+
+/**
+ * @brief Result of an odometry calibration
+ */
+struct CalibrationResult {
+        WheelCalibration vertical1;
+        WheelCalibration vertical2;
+        /** horizontal wheels never roll a known distance, so only their offset is solved and the scale stays 1 */
+        WheelCalibration horizontal1;
+        WheelCalibration horizontal2;
+        /** the drivetrain, as if it were a single wheel between the two sides */
+        WheelCalibration drive;
+        /** effective track width, using the calibrated drive wheel diameter */
+        float trackWidth = 0;
+};
+
+/**
+ * @brief Least squares solver for tracking wheel offsets, wheel diameters and track width
+ *
+ * The robot drives straight segments of a known length and spins in place, with the IMU measuring how far it turned.
+ * A wheel with true diameter scale s and offset o that reports r over a segment of length L where the robot turned by
+ * t must satisfy r * s + t * o = L, where L is 0 for a spin. That is linear in s and o, so every segment adds a row to
+ * an ordinary least squares problem. The drivetrain's track width comes from spins, where the difference between the
+ * two sides is the track width times the turn.
+ *
+ * Only running sums are kept, so adding segments never allocates and the solver works the same on the brain, on logged
+ * data and on synthetic data.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::OdomCalibration calibration;
+ * // robot drove 48 inches forward, turning 0.01 radians on the way
+ * calibration.addStraight({48.3, 48.4, 0.1, 0, 0, 48.9, 49.0, 0.01}, 48);
+ * // robot spun one full turn clockwise
+ * calibration.addSpin({28.7, -28.6, 31.4, 0, 0, 32.9, -32.6, 6.283});
+ * lemlib::CalibrationResult result = calibration.solve();
+ * @endcode
+ */
+class OdomCalibration {
+    public:
+        /**
+         * @brief Add a segment where the robot drove straight
+         *
+         * @param segment change in every sensor over the segment
+         * @param distance true distance the robot drove, in inches. Negative if it drove backwards
+         */
+        void addStraight(const CalibrationSegment& segment, float distance);
+        /**
+         * @brief Add a segment where the robot spun in place
+         *
+         * @param segment change in every sensor over the segment
+         */
+        void addSpin(const CalibrationSegment& segment);
+        /**
+         * @brief Forget every segment
+         */
+        void clear();
+        /**
+         * @brief Solve for the calibrated values of every sensor
+         *
+         * @return CalibrationResult
+         */
+        CalibrationResult solve() const;
+    private:
+        /** running sums of the least squares problem r * s + t * o = L for one wheel */
+        class WheelFit {
+            public:
+                void add(float reading, float turn, float distance);
+                WheelCalibration solve() const;
+                WheelCalibration solveOffset() const;
+            private:
+                double rr = 0;
+                double rt = 0;
+                double tt = 0;
+                double rl = 0;
+                double tl = 0;
+                double ll = 0;
+                int count = 0;
+        };
+
+        void add(const CalibrationSegment& segment, float distance);
+
+        WheelFit vertical1;
+        WheelFit vertical2;
+        WheelFit horizontal1;
+        WheelFit horizontal2;
+        WheelFit drive;
+        // track width fit, difference between the sides against the turn
+        double sideTurn = 0;
+        double turnTurn = 0;
+};
+} // namespace lemlib
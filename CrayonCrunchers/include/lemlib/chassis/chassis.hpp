@@ -1,11 +1,20 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include "pros/rtos.hpp"
 #include "pros/imu.hpp"
 #include "lemlib/asset.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
+#include "lemlib/chassis/odomFilter.hpp"
+#include "lemlib/chassis/calibration.hpp"
 #include "lemlib/pose.hpp"
 #include "lemlib/pid.hpp"
+#include "lemlib/periodic.hpp"
+#include "lemlib/motionProfile.hpp"
 #include "lemlib/exitcondition.hpp"
 #include "lemlib/driveCurve.hpp"
 
@@ -26,6 +35,8 @@ class OdomSensors {
          * @param horizontal1 pointer to the first horizontal tracking wheel
          * @param horizontal2 pointer to the second horizontal tracking wheel
          * @param imu pointer to the IMU
+         * @param mode how odometry combines the sensors. CLASSIC by default
+         * @param ekfSettings noise parameters of the filter, only used in EKF mode
          *
          * @b Example
          * @code {.cpp}
@@ -39,14 +50,30 @@ class OdomSensors {
          *                     nullptr, // no second horizontal tracking wheel, set to nullptr
          *                     &imu); // IMU
          * @endcode
+         *
+         * In EKF mode every sensor is used, along with the drivetrain motor encoders, instead of only the best one
+         * for each axis
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::OdomSensors sensors(&vertical1, // first vertical tracking wheel
+         *                     &vertical2, // second vertical tracking wheel
+         *                     &horizontal1, // horizontal tracking wheel
+         *                     nullptr, // no second horizontal tracking wheel, set to nullptr
+         *                     &imu, // IMU
+         *                     lemlib::OdomMode::EKF); // fuse all of them
+         * @endcode
          */
         OdomSensors(TrackingWheel* vertical1, TrackingWheel* vertical2, TrackingWheel* horizontal1,
-                    TrackingWheel* horizontal2, pros::Imu* imu);
+                    TrackingWheel* horizontal2, pros::Imu* imu, OdomMode mode = OdomMode::CLASSIC,
+                    EkfSettings ekfSettings = EkfSettings());
         TrackingWheel* vertical1;
         TrackingWheel* vertical2;
         TrackingWheel* horizontal1;
         TrackingWheel* horizontal2;
         pros::Imu* imu;
+        OdomMode mode;
+        EkfSettings ekfSettings;
 };
 
 /**
@@ -110,6 +137,61 @@ class ControllerSettings {
         float slew;
 };
 
+/**
+ * @brief class containing the limits and feedforward gains for profiled motions
+ */
+class ProfileSettings {
+    public:
+        /**
+         * @brief ProfileSettings constructor
+         *
+         * Profiled motions follow a lemlib::MotionProfile within these limits. The motors are driven with
+         * kS + kV * velocity + kA * acceleration from the profile, and the lateral controller only corrects how far
+         * the robot is from where the profile says it should be. Feedforward is in motor power, from -127 to 127
+         * Leave maxVelocity at 0 to disable profiled motions
+         *
+         * @param maxVelocity maximum velocity, in inches per second
+         * @param maxAcceleration maximum acceleration, in inches per second squared
+         * @param maxJerk maximum jerk, in inches per second cubed. 0 for trapezoidal profiles
+         * @param kS power needed to start the robot moving
+         * @param kV power per inch per second of velocity
+         * @param kA power per inch per second squared of acceleration
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::ProfileSettings profileSettings(60, // maximum velocity, in inches per second
+         *                                         120, // maximum acceleration, in inches per second squared
+         *                                         600, // maximum jerk, in inches per second cubed
+         *                                         5, // static feedforward (kS)
+         *                                         1.8, // velocity feedforward (kV)
+         *                                         0.2); // acceleration feedforward (kA)
+         * @endcode
+         */
+        ProfileSettings(float maxVelocity = 0, float maxAcceleration = 0, float maxJerk = 0, float kS = 0,
+                        float kV = 0, float kA = 0)
+            : maxVelocity(maxVelocity),
+              maxAcceleration(maxAcceleration),
+              maxJerk(maxJerk),
+              kS(kS),
+              kV(kV),
+              kA(kA) {}
+
+        /**
+         * @brief Get the feedforward power for a point on a profile
+         *
+         * @param state the point on the profile
+         * @return float motor power
+         */
+        float feedforward(const MotionProfile::State& state) const;
+
+        float maxVelocity;
+        float maxAcceleration;
+        float maxJerk;
+        float kS;
+        float kV;
+        float kA;
+};
+
 /**
  * @brief class containing constants for a drivetrain
  */
@@ -232,6 +314,33 @@ enum class DriveSide {
     RIGHT /** lock the right side of the drivetrain */
 };
 
+/**
+ * @brief Enum class MarkerTrigger
+ *
+ * What a marker added with Chassis::addMarker waits for before it runs
+ */
+enum class MarkerTrigger {
+    DISTANCE, /** distance traveled, in the same units as Chassis::waitUntil */
+    FRACTION, /** fraction of the motion done, from 0 to 1 */
+    TIME /** time since the motion started, in milliseconds */
+};
+
+/**
+ * @brief How long tasks waiting on the chassis took to wake up
+ *
+ * Latency is measured from the update where the motion saw the wait was over to when the waiting task ran again
+ */
+struct WaitLatency {
+        /** number of waits that were woken by a motion */
+        int count = 0;
+        /** latency of the last wait, in microseconds */
+        uint32_t last = 0;
+        /** longest latency, in microseconds */
+        uint32_t max = 0;
+        /** sum of every latency, in microseconds. Divide by count for the mean */
+        uint64_t total = 0;
+};
+
 /**
  * @brief Parameters for Chassis::swingToPoint
  *
@@ -300,6 +409,11 @@ struct MoveToPoseParams {
         /** distance between the robot and target point where the movement will exit. Only has an effect if minSpeed is
          * non-zero.*/
         float earlyExitRange = 0;
+        /** whether to follow a motion profile with feedforward, using the chassis ProfileSettings. False by default */
+        bool profiled = false;
+        /** if another motion is queued by the time the robot gets close to the target, hand over to it without slowing
+         * down. False by default */
+        bool blend = false;
 };
 
 /**
@@ -321,6 +435,11 @@ struct MoveToPointParams {
         /** distance between the robot and target point where the movement will exit. Only has an effect if minSpeed is
          * non-zero.*/
         float earlyExitRange = 0;
+        /** whether to follow a motion profile with feedforward, using the chassis ProfileSettings. False by default */
+        bool profiled = false;
+        /** if another motion is queued by the time the robot gets close to the target, hand over to it without slowing
+         * down. False by default */
+        bool blend = false;
 };
 
 // default drive curve
@@ -340,12 +459,13 @@ class Chassis {
          * @param sensors sensors to be used for odometry
          * @param throttleCurve curve applied to throttle input during driver control
          * @param turnCurve curve applied to steer input during driver control
+         * @param profileSettings limits and feedforward gains for profiled motions. Disabled by default
          *
          * @example main.cpp
          */
         Chassis(Drivetrain drivetrain, ControllerSettings linearSettings, ControllerSettings angularSettings,
                 OdomSensors sensors, DriveCurve* throttleCurve = &defaultDriveCurve,
-                DriveCurve* steerCurve = &defaultDriveCurve);
+                DriveCurve* steerCurve = &defaultDriveCurve, ProfileSettings profileSettings = ProfileSettings());
         /**
          * @brief Calibrate the chassis sensors. THis should be called in the initialize function
          *
@@ -368,6 +488,31 @@ class Chassis {
          * @endcode
          */
         void calibrate(bool calibrateIMU = true);
+        /**
+         * @brief Measure the tracking wheel offsets and diameters and the track width of the drivetrain
+         *
+         * The robot drives straight segments, alternating forwards and backwards, then spins in place, alternating
+         * directions. After each straight segment the controller shows the distance the robot was told to drive. Measure
+         * how far it actually drove, correct the number with the arrow buttons (up and down for 0.1", left and right for
+         * 1") and press A. The offsets, diameters and track width are then solved with lemlib::OdomCalibration and
+         * printed to the terminal, along with every segment so the solve can be repeated on a computer.
+         *
+         * Needs an IMU, and should be called after Chassis::calibrate. Give the robot room to drive the full distance.
+         *
+         * @param distance length of each straight segment, in inches. 48 by default
+         * @param straights number of straight segments. 4 by default
+         * @param spins number of spins, each two full turns. 4 by default
+         * @return CalibrationResult the calibrated values. Invalid if there is no IMU
+         *
+         * @b Example
+         * @code {.cpp}
+         * void opcontrol() {
+         *     // calibrate odom in the pits by pressing B
+         *     if (controller.get_digital_new_press(DIGITAL_B)) chassis.calibrateOdom();
+         * }
+         * @endcode
+         */
+        CalibrationResult calibrateOdom(float distance = 48, int straights = 4, int spins = 4);
         /**
          * @brief Set the pose of the chassis
          *
@@ -431,6 +576,7 @@ class Chassis {
          * @brief Wait until the robot has traveled a certain distance along the path
          *
          * @note Units are in inches if current motion is moveToPoint, moveToPose or follow, degrees for everything else
+         * @note Waits on the motion queued last, so it first waits for the motions ahead of it to finish
          *
          * @param dist the distance the robot needs to travel before returning
          *
@@ -455,6 +601,8 @@ class Chassis {
         /**
          * @brief Wait until the robot has completed the path
          *
+         * @note Waits for every motion queued so far
+         *
          * @b Example
          * @code {.cpp}
          * // move the robot to x = 20, y = 15, and face heading 90
@@ -466,6 +614,78 @@ class Chassis {
          * @endcode
          */
         void waitUntilDone();
+        /**
+         * @brief Wait until a condition is true
+         *
+         * The running motion checks the condition every time it updates and wakes the waiting task as soon as it is
+         * true. While no motion is running, the waiting task checks it itself every 10ms.
+         *
+         * @note The condition is called from the motion's task, so it has to be quick and can't wait on anything
+         *
+         * @param condition function that returns true once the wait is over
+         * @param timeout longest time to wait, in milliseconds
+         * @return true the condition was met
+         * @return false the wait timed out
+         *
+         * @b Example
+         * @code {.cpp}
+         * chassis.moveToPose(20, 15, 90, 4000);
+         * // wait until the robot has turned past 45 degrees
+         * chassis.waitUntil([] { return chassis.getPose().theta > 45; }, 2000);
+         * @endcode
+         */
+        bool waitUntil(std::function<bool()> condition, int timeout);
+        /**
+         * @brief Wait until the robot is within a distance of a point
+         *
+         * @param x x location of the point
+         * @param y y location of the point
+         * @param radius how close the robot has to be, in inches
+         * @param timeout longest time to wait, in milliseconds
+         * @return true the robot got close enough
+         * @return false the wait timed out
+         *
+         * @b Example
+         * @code {.cpp}
+         * chassis.moveToPose(20, 15, 90, 4000);
+         * // start the intake once the robot is within 6 inches of the ring
+         * chassis.waitUntilNear(20, 15, 6, 4000);
+         * intake.move(127);
+         * @endcode
+         */
+        bool waitUntilNear(float x, float y, float radius, int timeout);
+        /**
+         * @brief Get how long tasks waiting on motions took to wake up
+         *
+         * @return WaitLatency
+         */
+        WaitLatency getWaitLatency();
+        /**
+         * @brief Run a function part way through the motion queued last
+         *
+         * The marker is checked by the motion itself every time it updates, so the function runs on the same loop
+         * the trigger is reached, without blocking the task that queued the motion. Markers that were never reached
+         * run when the motion ends, the same way waitUntil returns when the motion ends early. If the motion has
+         * already ended, the function runs straight away.
+         *
+         * @note The function runs in the motion's task, so it has to be quick. Don't delay or wait on motions in it
+         * @note For FRACTION markers, turns measure the angle left to the target and moveToPoint and moveToPose the
+         * straight line distance left to it, so a curved moveToPose reaches each fraction a little late
+         *
+         * @param trigger what the marker waits for
+         * @param value distance, fraction or time to run the function at
+         * @param callback the function to run
+         *
+         * @b Example
+         * @code {.cpp}
+         * chassis.moveToPose(20, 25, 116, 3000, {.forwards = false});
+         * // clamp the goal 38 inches in
+         * chassis.addMarker(lemlib::MarkerTrigger::DISTANCE, 38, [] { latch.set_value(true); });
+         * // start the intake 3/4 of the way there
+         * chassis.addMarker(lemlib::MarkerTrigger::FRACTION, 0.75, [] { intake.move(127); });
+         * @endcode
+         */
+        void addMarker(MarkerTrigger trigger, float value, std::function<void()> callback);
         /**
          * @brief Sets the brake mode of the drivetrain motors
          *
@@ -881,6 +1101,55 @@ class Chassis {
          * @endcode
          */
         bool isInMotion() const;
+        /**
+         * @brief Get the number of motions waiting behind the running one
+         *
+         * @return int
+         *
+         * @b Example
+         * @code {.cpp}
+         * chassis.setMotionQueueSize(4);
+         * chassis.moveToPoint(0, 24, 2000);
+         * chassis.moveToPoint(24, 24, 2000);
+         * // returns 1. The first motion is running and the second is waiting
+         * chassis.getQueuedMotions();
+         * @endcode
+         */
+        int getQueuedMotions();
+        /**
+         * @brief Set how many async motions can wait in the queue before the next one blocks the task that called it
+         *
+         * By default this is 0, so an async motion blocks until every motion ahead of it is done, like stock LemLib.
+         * Code after it then runs as the motion starts. With a larger queue, a route can queue several motions at once
+         * and carry on, and motions with the blend parameter can hand over to the next one without stopping.
+         *
+         * @param size the number of motions, up to MAX_QUEUED_MOTIONS
+         *
+         * @b Example
+         * @code {.cpp}
+         * // queue the whole skills route up front
+         * chassis.setMotionQueueSize(lemlib::Chassis::MAX_QUEUED_MOTIONS);
+         * chassis.moveToPoint(0, 24, 2000, {.blend = true});
+         * chassis.moveToPoint(24, 48, 2000, {.blend = true});
+         * chassis.moveToPoint(48, 48, 2000);
+         * // wait for all three
+         * chassis.waitUntilDone();
+         * @endcode
+         */
+        void setMotionQueueSize(int size);
+        /**
+         * @brief Cancel every queued motion, but let the running one finish
+         *
+         * @b Example
+         * @code {.cpp}
+         * chassis.setMotionQueueSize(4);
+         * chassis.moveToPoint(0, 24, 2000);
+         * chassis.moveToPoint(24, 24, 2000);
+         * // the robot still drives to (0, 24), but never to (24, 24)
+         * chassis.clearMotionQueue();
+         * @endcode
+         */
+        void clearMotionQueue();
         /**
          * @brief Resets the x and y position of the robot
          * without interfering with the heading.
@@ -909,23 +1178,70 @@ class Chassis {
          * @warning Do not interact with these unless you know what you are doing
          */
         PID angularPID;
+        /** most motions that can wait in the queue behind the running one */
+        static constexpr int MAX_QUEUED_MOTIONS = 8;
+        /** most markers that can be waiting to run, across every queued motion */
+        static constexpr int MAX_MARKERS = 16;
+        /** most tasks that can wait on the chassis at once */
+        static constexpr int MAX_WAITERS = 4;
     protected:
         /**
-         * @brief Indicates that this motion is queued and blocks current task until this motion reaches front of queue
+         * @brief Take a place at the back of the motion queue. Blocks while the queue is full
+         *
+         * @return uint32_t ticket of the motion, which starts once every earlier ticket has ended
+         */
+        uint32_t queueMotion();
+        /**
+         * @brief Block the current task until it is the turn of a queued motion, then run the motion on it
+         *
+         * @param ticket ticket from queueMotion
+         * @return true the motion should run, and endMotion must be called when it's done
+         * @return false the motion was cancelled
+         */
+        bool waitForMotion(uint32_t ticket);
+        /**
+         * @brief Block the task that queued an async motion while too many motions are waiting ahead of it
+         *
+         * @param ticket ticket from queueMotion
          */
-        void requestMotionStart();
+        void waitForQueue(uint32_t ticket);
         /**
-         * @brief Dequeues this motion and permits queued task to run
+         * @brief Queue a motion from the current task and wait for its turn. Returns straight away if the current task
+         * was started for a queued motion
+         *
+         * @return true the motion should run, and endMotion must be called when it's done
+         * @return false the motion was cancelled
+         */
+        bool requestMotionStart();
+        /**
+         * @brief Dequeues this motion and starts the next one
          */
         void endMotion();
+        /**
+         * @brief Run the markers of the running motion that have been reached and wake the tasks whose wait is over.
+         * Motions call this every update
+         *
+         * @param remaining how far the motion still has to go, in the same units as distTraveled
+         */
+        void updateMarkers(float remaining);
 
         bool motionRunning = false;
-        bool motionQueued = false;
+        /** how many motions can be queued before an async motion blocks its caller */
+        int motionQueueSize = 0;
+        /** lateral power the previous motion ended with, if it blended into the one running now */
+        float entrySpeed = 0;
+        /** lateral power to hand to the next motion. Set by a motion that blends into the next one */
+        float exitSpeed = 0;
 
-        float distTraveled = 0;
+        /** atomic, since tasks waiting on the chassis read it while the motion writes it */
+        std::atomic<float> distTraveled = 0;
+        /** runs motions every 10 ms. Created when the first motion starts, since the chassis is usually a global
+         * and a loop can't be made before PROS has started. Restarted when a motion starts */
+        std::unique_ptr<PeriodicLoop> motionLoop;
 
         ControllerSettings lateralSettings;
         ControllerSettings angularSettings;
+        ProfileSettings profileSettings;
         Drivetrain drivetrain;
         OdomSensors sensors;
         DriveCurve* throttleCurve;
@@ -936,6 +1252,60 @@ class Chassis {
         ExitCondition angularLargeExit;
         ExitCondition angularSmallExit;
     private:
+        // the motion queue. Every motion gets a ticket in the order it was queued, and tickets run in order
+        size_t queueSlot(uint32_t ticket) const { return ticket % motionTasks.size(); }
+        int queuedMotions() const;
+
         pros::Mutex mutex;
+        uint32_t nextTicket = 0;
+        // written under the mutex, and atomic so waits can check them without it
+        std::atomic<uint32_t> runningTicket = 0; // the running ticket, or nextTicket if nothing is running
+        uint32_t cancelledTicket = 0; // tickets before this one that haven't run yet were cancelled
+        std::array<pros::task_t, MAX_QUEUED_MOTIONS + 1> motionTasks {}; // task waiting to run each ticket
+        std::array<pros::task_t, MAX_QUEUED_MOTIONS + 1> callerTasks {}; // task that queued each async ticket
+        std::atomic<pros::task_t> motionOwner = nullptr; // task running the current motion
+        uint32_t motionStartTime = 0; // when the current motion started, in milliseconds
+
+        struct Marker {
+                uint32_t ticket;
+                MarkerTrigger trigger;
+                float value;
+                std::function<void()> callback;
+        };
+
+        /**
+         * @brief Take the markers of a motion out of the list and run them
+         *
+         * @param ticket the motion
+         * @param all run every marker of the motion, not only the ones that have been reached
+         * @param fraction fraction of the motion done
+         */
+        void runMarkers(uint32_t ticket, bool all, float fraction);
+        std::array<Marker, MAX_MARKERS> markers {};
+        int markerCount = 0;
+
+        struct Waiter {
+                pros::task_t task = nullptr;
+                const std::function<bool()>* condition = nullptr;
+                std::atomic<bool> signalled = false; // polled by the waiting task without the wait mutex
+                uint64_t signalTime = 0; // when the wait was found to be over, in microseconds
+        };
+
+        /**
+         * @brief Block the current task until a condition is true, woken by signalWaiters
+         *
+         * @param condition function that returns true once the wait is over
+         * @param timeout longest time to wait, in milliseconds. TIMEOUT_MAX to wait forever
+         * @return true the condition was met
+         */
+        bool wait(const std::function<bool()>& condition, uint32_t timeout);
+        /**
+         * @brief Wake the tasks whose wait is over
+         */
+        void signalWaiters();
+        pros::Mutex waitMutex;
+        std::array<Waiter, MAX_WAITERS> waiters {};
+        std::atomic<int> waiterCount = 0; // checked without the wait mutex, by every motion update
+        WaitLatency waitLatency;
 };
 } // namespace lemlib
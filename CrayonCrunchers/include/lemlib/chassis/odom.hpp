@@ -1,9 +1,38 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/pose.hpp"
+#include "lemlib/chassis/poseHistory.hpp"
+#include "lemlib/chassis/sensorMonitor.hpp"
 
 namespace lemlib {
+/**
+ * @brief Pose, speed and time of a single odometry update, read together
+ */
+struct PoseSnapshot {
+        /** the pose of the robot */
+        Pose pose;
+        /** the global speed of the robot */
+        Pose speed;
+        /** time the pose was calculated at, in milliseconds */
+        uint32_t timestamp;
+};
+
+/**
+ * @brief Fault of each odometry sensor
+ *
+ * A faulty sensor has been swapped for the drivetrain encoders, or dropped if there is nothing to replace it with
+ */
+struct OdomHealth {
+        SensorFault vertical1;
+        SensorFault vertical2;
+        SensorFault horizontal1;
+        SensorFault horizontal2;
+        SensorFault imu;
+};
+
 /**
  * @brief Set the sensors to be used for odometry
  *
@@ -11,6 +40,15 @@ namespace lemlib {
  * @param drivetrain drivetrain to be used
  */
 void setSensors(lemlib::OdomSensors sensors, lemlib::Drivetrain drivetrain);
+/**
+ * @brief Get the fault of each odometry sensor
+ *
+ * Every sensor is checked each update for disconnects, stuck readings and readings that disagree with the
+ * drivetrain encoders
+ *
+ * @return OdomHealth
+ */
+OdomHealth getOdomHealth();
 /**
  * @brief Get the pose of the robot
  *
@@ -25,6 +63,27 @@ Pose getPose(bool radians = false);
  * @param radians true if theta is in radians, false if in degrees. False by default
  */
 void setPose(Pose pose, bool radians = false);
+/**
+ * @brief Get the pose, speed and timestamp of the latest odometry update in one consistent read
+ *
+ * Safe to call from any task. It never blocks odometry, and never returns a pose made up of two different updates
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return PoseSnapshot
+ */
+PoseSnapshot getPoseSnapshot(bool radians = false);
+/**
+ * @brief Get the pose of the robot at a point in the recent past
+ *
+ * Useful for latency compensation, when a sensor reading describes where the robot was rather than where it is.
+ * Interpolates between odometry updates, and only goes back PoseHistory::CAPACITY updates
+ *
+ * @param time the time, in milliseconds, as returned by pros::millis()
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return std::optional<Pose> the pose, or std::nullopt if the time is older than the history or before the last
+ * call to setPose
+ */
+std::optional<Pose> getPoseAt(uint32_t time, bool radians = false);
 /**
  * @brief Get the speed of the robot
  *
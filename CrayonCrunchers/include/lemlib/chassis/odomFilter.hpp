@@ -0,0 +1,149 @@
+#pragma once
+
+#include "lemlib/matrix.hpp"
+#include "lemlib/pose.hpp"
+
+namespace lemlib {
+/**
+ * @brief How odometry combines its sensors
+ */
+enum class OdomMode {
+    /** use the best available sensor for each axis, like stock LemLib */
+    CLASSIC,
+    /** fuse every sensor with an extended kalman filter */
+    EKF
+};
+
+/**
+ * @brief class containing the noise parameters of the odometry kalman filter
+ */
+class EkfSettings {
+    public:
+        /**
+         * @brief EkfSettings constructor
+         *
+         * Sensor noise is the standard deviation of a single odom update's reading, so it is independent of how far
+         * the robot moves. A sensor with less noise is trusted more. Acceleration noise is how quickly the filter
+         * expects the robot's speed to change, so it should be roughly the largest acceleration the robot can reach.
+         *
+         * @param verticalNoise noise of a vertical tracking wheel, in inches
+         * @param horizontalNoise noise of a horizontal tracking wheel, in inches
+         * @param driveNoise noise of the drivetrain motor encoders, in inches. Should be larger than the tracking
+         * wheels, since powered wheels slip
+         * @param imuNoise noise of the IMU, in radians
+         * @param forwardAccel forward acceleration noise, in inches per second squared
+         * @param lateralAccel sideways acceleration noise, in inches per second squared
+         * @param angularAccel angular acceleration noise, in radians per second squared
+         *
+         * @b Example
+         * @code {.cpp}
+         * // trust the IMU less than the default
+         * lemlib::EkfSettings ekfSettings(0.005, 0.005, 0.1, 0.005);
+         * @endcode
+         */
+        EkfSettings(float verticalNoise = 0.005, float horizontalNoise = 0.005, float driveNoise = 0.1,
+                    float imuNoise = 0.0002, float forwardAccel = 200, float lateralAccel = 50,
+                    float angularAccel = 40);
+
+        float verticalNoise;
+        float horizontalNoise;
+        float driveNoise;
+        float imuNoise;
+        float forwardAccel;
+        float lateralAccel;
+        float angularAccel;
+};
+
+/**
+ * @brief Extended kalman filter for odometry
+ *
+ * The state is the global pose of the robot plus its forward, sideways and angular velocity. Each odom update the
+ * velocities are predicted to stay the same, corrected with every sensor reading, then integrated into the pose.
+ * Readings only have to be a distance or angle travelled since the last update, so the filter knows nothing about the
+ * devices themselves and can be driven by logged or synthetic data.
+ *
+ * Every matrix has a fixed size and the filter never allocates.
+ */
+class OdomFilter {
+    public:
+        /** number of values in the state */
+        static constexpr size_t STATES = 6;
+        /** index of each value in the state */
+        enum State { X, Y, THETA, FORWARD, LATERAL, OMEGA };
+
+        /**
+         * @brief Construct a new OdomFilter
+         *
+         * @param settings noise parameters
+         */
+        OdomFilter(EkfSettings settings = EkfSettings());
+
+        /**
+         * @brief Set the pose of the robot. The velocity estimate is kept
+         *
+         * @param pose the pose, theta in radians
+         */
+        void setPose(Pose pose);
+        /**
+         * @brief Start an update by predicting the velocity of the robot
+         *
+         * @param dt time since the last update, in seconds
+         */
+        void predict(float dt);
+        /**
+         * @brief Correct the prediction with the distance a vertical wheel travelled since the last update
+         *
+         * @param delta distance travelled, in inches
+         * @param offset offset of the wheel from the tracking center, same as lemlib::TrackingWheel
+         * @param noise standard deviation of the reading, in inches
+         */
+        void fuseVertical(float delta, float offset, float noise);
+        /**
+         * @brief Correct the prediction with the distance a horizontal wheel travelled since the last update
+         *
+         * @param delta distance travelled, in inches
+         * @param offset offset of the wheel from the tracking center, same as lemlib::TrackingWheel
+         * @param noise standard deviation of the reading, in inches
+         */
+        void fuseHorizontal(float delta, float offset, float noise);
+        /**
+         * @brief Correct the prediction with how far the robot turned since the last update
+         *
+         * @param delta change in heading, in radians, clockwise positive
+         * @param noise standard deviation of the reading, in radians
+         */
+        void fuseHeading(float delta, float noise);
+        /**
+         * @brief Finish an update by moving the pose by the corrected velocity
+         */
+        void integrate();
+
+        /**
+         * @brief Get the estimated pose
+         *
+         * @return Pose theta in radians
+         */
+        Pose getPose() const;
+        /**
+         * @brief Get the estimated local velocity
+         *
+         * @return Pose sideways velocity, forward velocity and angular velocity, in inches and radians per second
+         */
+        Pose getLocalSpeed() const;
+        /**
+         * @brief Get the covariance of the estimate
+         *
+         * @return const Matrix<STATES, STATES>&
+         */
+        const Matrix<STATES, STATES>& getCovariance() const { return covariance; }
+
+        EkfSettings settings;
+    private:
+        /** correct the state with a reading that is a linear combination of the state */
+        void fuse(const Matrix<1, STATES>& h, float reading, float noise);
+
+        Vector<STATES> state;
+        Matrix<STATES, STATES> covariance;
+        float dt = 0;
+};
+} // namespace lemlib
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include "lemlib/pose.hpp"
+#include "lemlib/seqlock.hpp"
+
+namespace lemlib {
+/**
+ * @brief Fixed size history of timestamped poses
+ *
+ * Keeps the most recent poses in a ring buffer so you can look up where the robot was at some point in the past,
+ * for example when a sensor reading arrives late. Never allocates after construction.
+ *
+ * Lookups never block the task adding poses. Each slot is a SeqLock, and the number of poses ever added is published
+ * after the slot is written, so a lookup only sees finished poses. A lookup that finds a slot overwritten under it,
+ * because it fell a whole buffer behind, starts again.
+ */
+class PoseHistory {
+    public:
+        /** number of poses kept. Just over 2.5 seconds of history at the 10 ms odom rate */
+        static constexpr size_t CAPACITY = 256;
+
+        /**
+         * @brief Add a pose to the history, dropping the oldest one if the history is full
+         *
+         * @param pose the pose
+         * @param time when the robot was at the pose, in milliseconds. Must not be older than the last pose added
+         * @return true the pose was added
+         * @return false another task was adding a pose, nothing was added
+         */
+        bool push(const Pose& pose, uint32_t time);
+        /**
+         * @brief Remove every pose from the history, and start it again from a pose
+         *
+         * @param pose the pose
+         * @param time when the robot was at the pose, in milliseconds
+         * @return true the history was reset
+         * @return false another task was adding a pose, nothing changed
+         */
+        bool reset(const Pose& pose, uint32_t time);
+        /**
+         * @brief Get the pose of the robot at a point in time
+         *
+         * Interpolates between the two poses either side of the time. Looking up a time newer than the latest pose
+         * returns the latest pose. Takes O(log n) time.
+         *
+         * @param time the time, in milliseconds
+         * @return std::optional<Pose> the pose, or std::nullopt if the time is older than the history
+         */
+        std::optional<Pose> get(uint32_t time) const;
+        /**
+         * @brief Get the number of poses in the history
+         *
+         * @return size_t
+         */
+        size_t size() const;
+    private:
+        struct Sample {
+                Pose pose = Pose(0, 0, 0);
+                uint32_t time = 0;
+                uint32_t index = 0; // how many poses were added before this one, to tell if the slot was overwritten
+        };
+
+        template <size_t... I> static std::array<SeqLock<Sample>, CAPACITY> makeSlots(std::index_sequence<I...>) {
+            return {((void)I, SeqLock<Sample>(Sample {}))...};
+        }
+
+        /**
+         * @brief Write a pose into the next slot. Only call while holding the writing flag
+         *
+         * @return uint32_t the index of the pose
+         */
+        uint32_t write(const Pose& pose, uint32_t time);
+        /**
+         * @brief Get a sample by index
+         *
+         * @return std::optional<Sample> the sample, or std::nullopt if it has been overwritten
+         */
+        std::optional<Sample> at(uint32_t index) const;
+        /**
+         * @brief Look up a pose once
+         *
+         * @param time the time, in milliseconds
+         * @param pose set to the pose, or std::nullopt if the time is older than the history
+         * @return false a sample was overwritten during the lookup, and it has to start again
+         */
+        bool find(uint32_t time, std::optional<Pose>& pose) const;
+
+        std::array<SeqLock<Sample>, CAPACITY> slots = makeSlots(std::make_index_sequence<CAPACITY>());
+        // index of the oldest pose since the last reset
+        std::atomic<uint32_t> first = 0;
+        // number of poses ever added
+        std::atomic<uint32_t> next = 0;
+        // set while a task is adding a pose, so two tasks never write the same slot
+        std::atomic<bool> writing = false;
+};
+} // namespace lemlib
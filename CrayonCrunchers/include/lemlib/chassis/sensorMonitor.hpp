@@ -0,0 +1,95 @@
+#pragma once
+
+namespace lemlib {
+/**
+ * @brief Ways an odometry sensor can fail
+ */
+enum class SensorFault {
+    /** the sensor is working */
+    NONE,
+    /** the sensor returned an error or an impossible reading, usually because it was unplugged */
+    DISCONNECTED,
+    /** the sensor's reading froze while the drivetrain was moving */
+    STUCK,
+    /** the sensor kept moving, but not the way the drivetrain did */
+    DISAGREES
+};
+
+/**
+ * @brief Get the name of a sensor fault, for logging
+ *
+ * @param fault the fault
+ * @return const char*
+ */
+const char* toString(SensorFault fault);
+
+/**
+ * @brief Watches an odometry sensor for faults by comparing it with the drivetrain motor encoders
+ *
+ * Disconnects are caught on the first bad reading. Everything else has to last: a stuck sensor's reading has to stay
+ * exactly the same for STUCK_READINGS while the robot moves and the drivetrain moves far enough, and disagreeing
+ * sensors are judged over windows of readings and have to fail two windows in a row. That way the drive wheels
+ * slipping against a wall or a couple of stale reads aren't mistaken for a fault.
+ *
+ * A faulted sensor keeps being watched, and the fault clears once it agrees with the drivetrain for two windows in a
+ * row, so a sensor that was only wrong for a moment, or got plugged back in, is used again.
+ */
+class SensorMonitor {
+    public:
+        /** number of readings in a window. Half a second at the 10 ms odom rate */
+        static constexpr int WINDOW = 50;
+        /** number of readings a stuck sensor stays frozen for. A tenth of a second, several times a few stale reads */
+        static constexpr int STUCK_READINGS = 10;
+
+        /**
+         * @brief Construct a new SensorMonitor
+         *
+         * @param maxDelta largest change possible between two readings. Anything larger is treated as a disconnect
+         * @param stuckTravel how far the drivetrain has to move while the reading stays exactly the same before the sensor
+         * counts as stuck
+         * @param minTravel how far the drivetrain has to move in a window before the sensor is judged
+         * @param tolerance how far the sensor can be from the drivetrain over a window, on top of half the distance
+         * the drivetrain moved
+         */
+        SensorMonitor(float maxDelta, float stuckTravel, float minTravel, float tolerance);
+
+        /**
+         * @brief Check the next reading of the sensor
+         *
+         * @param delta change in the sensor's reading since the last update
+         * @param expected change the drivetrain encoders say the sensor should have seen
+         * @param moving whether the robot is moving. Readings while it isn't are ignored, apart from disconnects
+         * @return SensorFault the fault, if the sensor has failed and not recovered yet
+         */
+        SensorFault update(float delta, float expected, bool moving);
+        /**
+         * @brief Clear the fault and start watching again
+         */
+        void reset();
+        /**
+         * @brief Get the fault of the sensor
+         *
+         * @return SensorFault
+         */
+        SensorFault getFault() const { return fault; }
+    private:
+        /**
+         * @brief Start a new window
+         */
+        void clearWindow();
+
+        const float maxDelta;
+        const float stuckTravel;
+        const float minTravel;
+        const float tolerance;
+
+        SensorFault fault = SensorFault::NONE;
+        int streak = 0; // windows in a row that disagreed, or agreed once faulted
+        float stillTravel = 0; // distance the drivetrain moved since the reading last changed
+        int stillReadings = 0; // readings the drive motors turned for since the reading last changed
+        float travel = 0; // total change of the sensor this window
+        float expectedTravel = 0;
+        float drivetrainTravel = 0; // total distance the drivetrain moved this window, ignoring direction
+        int readings = 0;
+};
+} // namespace lemlib
@@ -167,6 +167,22 @@ class TrackingWheel {
          * @endcode
          */
         float getOffset();
+        /**
+         * @brief Get the configured diameter of the tracking wheel
+         *
+         * @return float diameter in inches
+         *
+         * @b Example
+         * @code {.cpp}
+         * void initialize() {
+         *     // create a tracking wheel with a new 2.75" omniwheel
+         *     lemlib::TrackingWheel exampleTrackingWheel(&exampleEncoder, lemlib::Omniwheel::NEW_275, 0.5);
+         *     // this prints the diameter of the new 2.75" omniwheel to the terminal
+         *     std::cout << "diameter: " << exampleTrackingWheel.getDiameter() << std::endl;
+         * }
+         * @endcode
+         */
+        float getDiameter();
         /**
          * @brief Get the type of tracking wheel
          *
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+#include "pros/misc.hpp"
+
+namespace lemlib {
+/**
+ * @brief The channels of a controller that are used, read at once
+ */
+struct ControllerSnapshot {
+        /** number of buttons */
+        static constexpr int BUTTONS = 12;
+
+        /** when the controller was read, in milliseconds */
+        uint32_t time = 0;
+        /** joystick positions, from -127 to 127, indexed by pros::controller_analog_e_t. 0 if not read */
+        std::array<int32_t, 4> analog {};
+        /** buttons held, a bit per button from DIGITAL_L1. Buttons not read are never held */
+        uint16_t held = 0;
+        /** buttons that went down since the read before */
+        uint16_t pressed = 0;
+        /** buttons that came up since the read before */
+        uint16_t released = 0;
+
+        /**
+         * @brief Get the bit of a button
+         *
+         * @param button the button
+         * @return uint16_t
+         */
+        static uint16_t bit(pros::controller_digital_e_t button) {
+            return uint16_t(1u << (button - pros::E_CONTROLLER_DIGITAL_L1));
+        }
+
+        bool isHeld(pros::controller_digital_e_t button) const { return held & bit(button); }
+
+        bool isPressed(pros::controller_digital_e_t button) const { return pressed & bit(button); }
+
+        bool isReleased(pros::controller_digital_e_t button) const { return released & bit(button); }
+
+        int32_t get(pros::controller_analog_e_t channel) const { return analog[channel]; }
+};
+
+/**
+ * @brief When a binding runs its action
+ */
+enum class Trigger {
+    /** once, when the button goes down */
+    PRESS,
+    /** once, when the button comes up */
+    RELEASE,
+    /** every update, with whether the button is held */
+    HOLD,
+    /** when the button goes down, with the state it flipped to */
+    TOGGLE,
+    /** when the button goes down a second time soon after the first */
+    DOUBLE_TAP
+};
+
+/**
+ * @brief A button, when it triggers, and what it does
+ */
+class Binding {
+    public:
+        /**
+         * @brief Construct a new Binding for a trigger that doesn't pass a state, PRESS, RELEASE or DOUBLE_TAP
+         *
+         * @param button the button
+         * @param trigger when it triggers
+         * @param action what it does
+         */
+        Binding(pros::controller_digital_e_t button, Trigger trigger, std::function<void()> action)
+            : button(button),
+              trigger(trigger),
+              action([action](bool) { action(); }) {}
+
+        /**
+         * @brief Construct a new Binding for a trigger that passes a state, HOLD or TOGGLE
+         *
+         * @param button the button
+         * @param trigger when it triggers
+         * @param action what it does, given whether the button is held, or the state it toggled to
+         * @param initial state a TOGGLE starts in
+         */
+        Binding(pros::controller_digital_e_t button, Trigger trigger, std::function<void(bool)> action,
+                bool initial = false)
+            : button(button),
+              trigger(trigger),
+              action(action),
+              state(initial) {}
+
+        pros::controller_digital_e_t button;
+        Trigger trigger;
+        std::function<void(bool)> action;
+        bool state = false; // the state of a TOGGLE
+        uint32_t lastPress = 0; // when the button last went down, for a DOUBLE_TAP
+};
+
+/**
+ * @brief Reads a controller once per update, and runs the actions bound to its buttons
+ *
+ * Each bound button, and each joystick and extra button the loop uses, is read once, into a snapshot, and every
+ * binding is checked against it, so a button bound twice, or also read by the loop, isn't read from the controller
+ * twice. Nothing else is read, since every read takes time. Presses and releases are found by comparing
+ * snapshots, so they don't depend on pros::Controller::get_digital_new_press. A button can have several bindings, and
+ * a DOUBLE_TAP's second press also triggers a PRESS on the same button.
+ *
+ * Bindings run in the order they are declared, in the task calling update.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::ControllerBindings controls(&controller, {
+ *     {DIGITAL_L1, lemlib::Trigger::TOGGLE, [](bool on) { wings.set_value(on); }},
+ *     {DIGITAL_L2, lemlib::Trigger::HOLD, [](bool held) { clamp.set_value(held); }},
+ *     {DIGITAL_UP, lemlib::Trigger::PRESS, [] { macros.start(score); }},
+ * }, {pros::E_CONTROLLER_ANALOG_LEFT_Y, pros::E_CONTROLLER_ANALOG_RIGHT_X});
+ * // in opcontrol
+ * const lemlib::ControllerSnapshot& input = controls.update();
+ * chassis.arcade(input.get(pros::E_CONTROLLER_ANALOG_LEFT_Y), input.get(pros::E_CONTROLLER_ANALOG_RIGHT_X));
+ * @endcode
+ */
+class ControllerBindings {
+    public:
+        /**
+         * @brief Construct a new ControllerBindings
+         *
+         * @param controller the controller
+         * @param bindings what each button does
+         * @param channels joysticks the loop uses. Others read as 0
+         * @param buttons buttons the loop uses that aren't bound. Others that aren't bound are never held
+         * @param doubleTapTime longest between the presses of a double tap, in milliseconds
+         */
+        ControllerBindings(pros::Controller* controller, std::initializer_list<Binding> bindings,
+                           std::initializer_list<pros::controller_analog_e_t> channels = {},
+                           std::initializer_list<pros::controller_digital_e_t> buttons = {},
+                           uint32_t doubleTapTime = 300);
+
+        /**
+         * @brief Read the controller, and run the bindings it triggers
+         *
+         * @return const ControllerSnapshot& what was read
+         */
+        const ControllerSnapshot& update();
+        /**
+         * @brief Get what was read at the last update
+         *
+         * @return const ControllerSnapshot&
+         */
+        const ControllerSnapshot& getSnapshot() const { return snapshot; }
+        /**
+         * @brief Get the state of the first TOGGLE bound to a button
+         *
+         * @param button the button
+         * @return true the toggle is on
+         * @return false the toggle is off, or there is no toggle on the button
+         */
+        bool isToggled(pros::controller_digital_e_t button) const;
+    private:
+        pros::Controller* controller;
+        std::vector<Binding> bindings;
+        uint32_t doubleTapTime;
+        // what to read, a bit per button like ControllerSnapshot::held, and a bit per joystick channel
+        uint16_t buttonMask = 0;
+        uint8_t channelMask = 0;
+        ControllerSnapshot snapshot;
+};
+} // namespace lemlib
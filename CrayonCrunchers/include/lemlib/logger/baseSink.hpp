@@ -1,6 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
 #include "pros/rtos.hpp"
 
 #define FMT_HEADER_ONLY
@@ -41,6 +46,7 @@ class BaseSink {
          * @param level
          *
          * If messages are logged that are below the lowest level, they will be ignored.
+         * Levels below COMPILED_LEVEL are never shown, since their messages aren't compiled in.
          * The hierarchy of the levels is as follows:
          * - INFO
          * - DEBUG
@@ -55,6 +61,9 @@ class BaseSink {
          * If this is a combined sink, this operation will
          * apply for all the parent sinks.
          *
+         * The format is checked at compile time and the message is formatted straight into a buffer owned by the
+         * sink, so logging doesn't allocate. Messages longer than MAX_MESSAGE_LENGTH are cut short.
+         *
          * @tparam T
          * @param level The level at which to send the message.
          * @param format The format that the message will use. Use "{}" as placeholders.
@@ -68,29 +77,25 @@ class BaseSink {
          */
         template <typename... T> void log(Level level, fmt::format_string<T...> format, T&&... args) {
             if (!sinks.empty()) {
-                for (std::shared_ptr<BaseSink> sink : sinks) { sink->log(level, format, std::forward<T>(args)...); }
+                for (const std::shared_ptr<BaseSink>& sink : sinks) {
+                    sink->log(level, format, std::forward<T>(args)...);
+                }
                 return;
             }
 
-            if (level < lowestLevel) { return; }
-
-            // substitute the user's arguments into the format.
-            std::string messageString = fmt::format(format, std::forward<T>(args)...);
-
-            Message message = Message {.level = level, .time = pros::millis()};
-
-            // get the arguments
-            fmt::dynamic_format_arg_store<fmt::format_context> formattingArgs = getExtraFormattingArgs(message);
+            if (level < COMPILED_LEVEL || level < lowestLevel) { return; }
 
-            formattingArgs.push_back(fmt::arg("time", message.time));
-            formattingArgs.push_back(fmt::arg("level", message.level));
-            formattingArgs.push_back(fmt::arg("message", messageString));
-
-            std::string formattedString = fmt::vformat(logFormat, std::move(formattingArgs));
-            message.message = std::move(formattedString);
-            sendMessage(std::move(message));
+            mutex.take();
+            // substitute the user's arguments into the format
+            const auto result =
+                fmt::format_to_n(messageBuffer.data(), messageBuffer.size(), format, std::forward<T>(args)...);
+            sendFormatted(level, std::string_view(messageBuffer.data(), std::min(result.size, messageBuffer.size())));
+            mutex.give();
         }
 
+        /** longest message that can be logged, in characters */
+        static constexpr size_t MAX_MESSAGE_LENGTH = 256;
+
         /**
          * @brief Log a message at the debug level.
          * If this is a combined sink, this operation will
@@ -100,7 +105,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void debug(fmt::format_string<T...> format, T&&... args) {
-            log(Level::DEBUG, format, std::forward<T>(args)...);
+            if constexpr (Level::DEBUG >= COMPILED_LEVEL) log(Level::DEBUG, format, std::forward<T>(args)...);
         }
 
         /**
@@ -112,7 +117,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void info(fmt::format_string<T...> format, T&&... args) {
-            log(Level::INFO, format, std::forward<T>(args)...);
+            if constexpr (Level::INFO >= COMPILED_LEVEL) log(Level::INFO, format, std::forward<T>(args)...);
         }
 
         /**
@@ -124,7 +129,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void warn(fmt::format_string<T...> format, T&&... args) {
-            log(Level::WARN, format, std::forward<T>(args)...);
+            if constexpr (Level::WARN >= COMPILED_LEVEL) log(Level::WARN, format, std::forward<T>(args)...);
         }
 
         /**
@@ -136,7 +141,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void error(fmt::format_string<T...> format, T&&... args) {
-            log(Level::ERROR, format, std::forward<T>(args)...);
+            if constexpr (Level::ERROR >= COMPILED_LEVEL) log(Level::ERROR, format, std::forward<T>(args)...);
         }
 
         /**
@@ -148,7 +153,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void fatal(fmt::format_string<T...> format, T&&... args) {
-            log(Level::FATAL, format, std::forward<T>(args)...);
+            if constexpr (Level::FATAL >= COMPILED_LEVEL) log(Level::FATAL, format, std::forward<T>(args)...);
         }
     protected:
         /**
@@ -201,9 +206,36 @@ class BaseSink {
          */
         virtual fmt::dynamic_format_arg_store<fmt::format_context> getExtraFormattingArgs(const Message& messageInfo);
     private:
+        /**
+         * @brief Put a formatted message into the sink's format and send it
+         *
+         * @param level
+         * @param text the message, formatted with the user's arguments
+         */
+        void sendFormatted(Level level, std::string_view text);
+
         Level lowestLevel = Level::WARN;
         std::string logFormat;
 
+        // the format split into literal text and fields when it is set, so logging doesn't have to parse it
+        enum class Field { LITERAL, TIME, LEVEL, MESSAGE };
+
+        struct FormatSegment {
+                Field field;
+                // position of literal text in formatLiterals
+                size_t start;
+                size_t length;
+        };
+
+        std::vector<FormatSegment> formatSegments {};
+        std::string formatLiterals;
+        // false if the format uses named arguments from getExtraFormattingArgs, which can only be formatted by fmt
+        bool simpleFormat = true;
+
+        pros::Mutex mutex;
+        std::array<char, MAX_MESSAGE_LENGTH> messageBuffer {};
+        std::array<char, MAX_MESSAGE_LENGTH + 64> outputBuffer {};
+
         std::vector<std::shared_ptr<BaseSink>> sinks {};
 };
 } // namespace lemlib
@@ -1,25 +1,39 @@
 #pragma once
 
-#include <deque>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <functional>
-#include <string>
+#include <string_view>
 
 #include "pros/rtos.hpp"
+#include "lemlib/periodic.hpp"
 
 namespace lemlib {
 /**
  * @brief A buffer implementation
  *
- * Asynchronously processes a backlog of strings at a given rate. The strings are processed in a first in last out
- * order.
+ * Asynchronously processes a backlog of strings at a given rate. Every task that pushes gets its own fixed size ring
+ * of preallocated slots, with a single producer and a single consumer, so pushing never blocks or allocates. Strings
+ * from one task are processed in the order they were pushed. The buffer's task takes one string per period from the
+ * rings in turn, and gives a ring back once it is empty so tasks that have ended don't hold on to one.
  */
 class Buffer {
     public:
+        /** longest string a slot holds. Fits the longest message a sink sends, plus terminal escape codes */
+        static constexpr size_t SLOT_SIZE = 384;
+        /** strings each task can have waiting before the buffer drops them */
+        static constexpr size_t SLOTS = 16;
+        /** tasks that can have strings waiting at once */
+        static constexpr size_t PRODUCERS = 8;
+
         /**
          * @brief Construct a new Buffer object
          *
+         * @param bufferFunc the function applied to each string
+         * @param name name of the buffer's task. Has to outlive the buffer
          */
-        Buffer(std::function<void(const std::string&)> bufferFunc);
+        Buffer(std::function<void(std::string_view)> bufferFunc, const char* name = "buffer");
 
         /**
          * @brief Destroy the Buffer object
@@ -31,11 +45,15 @@ class Buffer {
         Buffer& operator=(const Buffer&) = delete;
 
         /**
-         * @brief Push to the buffer
+         * @brief Push to the buffer. Never blocks
+         *
+         * Strings longer than SLOT_SIZE are cut short.
          *
          * @param bufferData
+         * @return true the string was pushed
+         * @return false the string was dropped, because the task's ring was full or every ring was taken
          */
-        void pushToBuffer(const std::string& bufferData);
+        bool pushToBuffer(std::string_view bufferData);
 
         /**
          * @brief Set the rate of the sink
@@ -44,29 +62,73 @@ class Buffer {
          */
         void setRate(uint32_t rate);
 
+        /**
+         * @brief Set how many strings are processed each period. 1 by default
+         *
+         * @param burst
+         */
+        void setBurst(size_t burst);
+
         /**
          * @brief Check to see if the internal buffer is empty
          *
          */
         bool buffersEmpty();
+
+        /**
+         * @brief Get the number of strings dropped because the buffer was full
+         *
+         */
+        uint32_t getDropped() const;
+
+        /**
+         * @brief Get the number of strings that were cut short to fit in a slot
+         *
+         */
+        uint32_t getTruncated() const;
     private:
         /**
-         * @brief The function that will be run inside of the buffer's task.
+         * @brief The function that will be run inside of the buffer's task, once per period.
+         *
+         */
+        void drain();
+
+        struct Slot {
+                uint16_t length;
+                std::array<char, SLOT_SIZE> data;
+        };
+
+        // written by one task and read by the buffer's task
+        struct Ring {
+                // task handle of the producer, with the low bit set while it is pushing. 0 if the ring is free
+                std::atomic<uintptr_t> owner {0};
+                // next slot to read, only written by the buffer's task
+                std::atomic<uint32_t> head {0};
+                // next slot to write, only written by the producer
+                std::atomic<uint32_t> tail {0};
+                std::array<Slot, SLOTS> slots;
+        };
+
+        /**
+         * @brief Find the current task's ring, or claim a free one, and mark it busy
          *
+         * @return Ring* nullptr if every ring is taken, or the buffer's task is checking this task's ring
          */
-        void taskLoop();
+        Ring* acquireRing();
 
         /**
          * @brief The function that will be applied to each string in the buffer when it is removed.
          *
          */
-        std::function<void(std::string)> bufferFunc;
+        std::function<void(std::string_view)> bufferFunc;
 
-        std::deque<std::string> buffer = {};
+        std::array<Ring, PRODUCERS> rings;
+        size_t nextRing = 0;
+        std::atomic<uint32_t> dropped {0};
+        std::atomic<uint32_t> truncated {0};
 
-        pros::Mutex mutex;
-        pros::Task task;
+        size_t burst = 1;
 
-        uint32_t rate;
+        PeriodicTask task;
 };
 } // namespace lemlib
@@ -9,18 +9,25 @@
 #include "lemlib/logger/baseSink.hpp"
 #include "lemlib/logger/infoSink.hpp"
 #include "lemlib/logger/telemetrySink.hpp"
+#include "lemlib/logger/recorderSink.hpp"
 
 namespace lemlib {
 
 /**
  * @brief Get the info sink.
- * @return std::shared_ptr<InfoSink>
+ * @return const std::shared_ptr<InfoSink>&
  */
-std::shared_ptr<InfoSink> infoSink();
+const std::shared_ptr<InfoSink>& infoSink();
 
 /**
  * @brief Get the telemetry sink.
- * @return std::shared_ptr<TelemetrySink>
+ * @return const std::shared_ptr<TelemetrySink>&
  */
-std::shared_ptr<TelemetrySink> telemetrySink();
+const std::shared_ptr<TelemetrySink>& telemetrySink();
+
+/**
+ * @brief Get the recorder sink.
+ * @return const std::shared_ptr<RecorderSink>&
+ */
+const std::shared_ptr<RecorderSink>& recorderSink();
 } // namespace lemlib
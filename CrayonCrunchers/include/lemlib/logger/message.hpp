@@ -1,6 +1,6 @@
 #pragma once
 
-#include <string>
+#include <string_view>
 #include <cstdint>
 
 namespace lemlib {
@@ -10,13 +10,28 @@ namespace lemlib {
  */
 enum class Level { INFO, DEBUG, WARN, ERROR, FATAL };
 
+// 0 INFO, 1 DEBUG, 2 WARN, 3 ERROR, 4 FATAL. Set by the Makefile
+#ifndef LEMLIB_LOG_LEVEL
+#define LEMLIB_LOG_LEVEL 0
+#endif
+
+static_assert(LEMLIB_LOG_LEVEL >= 0 && LEMLIB_LOG_LEVEL <= 4, "LEMLIB_LOG_LEVEL must be between 0 and 4");
+
+/**
+ * @brief Lowest level compiled into the program
+ *
+ * Messages under it compile to nothing: the call, the formatting and the code fmt generates for it are left out, so
+ * they cost no time or space. Their arguments are still evaluated. Set it with LEMLIB_LOG_LEVEL
+ */
+constexpr Level COMPILED_LEVEL = static_cast<Level>(LEMLIB_LOG_LEVEL);
+
 /**
  * @brief A loggable message
  *
  */
 struct Message {
-        /* The message */
-        std::string message;
+        /* The message. Only valid until the sink that got it returns */
+        std::string_view message;
 
         /** The level of the message */
         Level level;
@@ -29,7 +44,7 @@ struct Message {
  * @brief Format a level
  *
  * @param level
- * @return std::string
+ * @return std::string_view
  */
-std::string format_as(Level level);
+std::string_view format_as(Level level);
 } // namespace lemlib
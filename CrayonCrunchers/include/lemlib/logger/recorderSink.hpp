@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+
+#include "lemlib/logger/baseSink.hpp"
+#include "lemlib/logger/buffer.hpp"
+#include "lemlib/logger/telemetryFrame.hpp"
+#include "lemlib/periodic.hpp"
+
+namespace lemlib {
+/**
+ * @brief Sink for recording telemetry to the microSD card
+ *
+ * Records the same binary frames as the binary mode of TelemetrySink, so there is data from matches where the robot
+ * isn't tethered. Frames are copied into large chunks, and a low priority task writes full chunks to the card, so
+ * sending never blocks or waits on the card. If the card falls too far behind, frames are dropped and counted.
+ *
+ * Every recording goes in a new file, /usd/rec_000.bin, /usd/rec_001.bin and so on, which starts with the definition
+ * of every channel. Once every name up to rec_999.bin is taken, recording stops with an error rather than write over
+ * a file. Messages logged to the sink are recorded on LOG_CHANNEL. Decode the files with sim/app/telemetry_decode.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * lemlib::recorderSink()->start();
+ * lemlib::recorderSink()->defineChannel(1, "temperature", {"motor1", "motor2"});
+ * lemlib::recorderSink()->send(1, motor1.get_temperature(), motor2.get_temperature());
+ * lemlib::recorderSink()->warn("auton {} started", route);
+ * // the next frames go in a new file
+ * lemlib::recorderSink()->rotate();
+ * @endcode
+ */
+class RecorderSink : public BaseSink {
+    public:
+        /** highest channel ID that can be defined, plus one */
+        static constexpr size_t MAX_CHANNELS = 16;
+        /** channel logged messages are recorded on, with the fields level and message */
+        static constexpr uint8_t LOG_CHANNEL = MAX_CHANNELS - 1;
+        /** bytes written to the card at once. A multiple of the card's sector size */
+        static constexpr size_t CHUNK_SIZE = 8192;
+        /** chunks that can wait for the card, about 4 seconds of telemetry at 100 Hz */
+        static constexpr size_t CHUNKS = 8;
+        /** size of a card sector. Writes are padded to it so they stay on sector boundaries */
+        static constexpr size_t SECTOR_SIZE = 512;
+        /** longest a partly full chunk waits before it is written anyway, in milliseconds */
+        static constexpr uint32_t FLUSH_PERIOD = 1000;
+        /** size at which a file is ended and the next one started */
+        static constexpr size_t MAX_FILE_SIZE = 16 * 1024 * 1024;
+        /** number of file names, rec_000.bin to rec_999.bin */
+        static constexpr int MAX_FILES = 1000;
+
+        /**
+         * @brief Construct a new Recorder Sink object
+         */
+        RecorderSink();
+        /**
+         * @brief Start recording. Creates the recorder's tasks the first time
+         *
+         * @param directory where to put the files, ending in a slash
+         * @return true recording
+         * @return false there is no microSD card
+         */
+        bool start(const char* directory = "/usd/");
+        /**
+         * @brief Whether the sink is recording
+         */
+        bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+        /**
+         * @brief End the current file. Frames sent after this go in a new one
+         *
+         * Call it when a match starts, so every match gets its own file. Waits for the recorder to catch up if the
+         * calling task just sent more than it could queue.
+         *
+         * @return true the file will be ended
+         * @return false the sink isn't recording, or the recorder stayed too far behind
+         */
+        bool rotate();
+        /**
+         * @brief Write what has been recorded so far to the card, without waiting for the chunk to fill
+         *
+         * Waits for the recorder to catch up if the calling task just sent more than it could queue, so a flush right
+         * after a burst of messages isn't lost.
+         *
+         * @return true what has been recorded will be written
+         * @return false the sink isn't recording, or the recorder stayed too far behind
+         */
+        bool flush();
+        /**
+         * @brief Name a channel and its fields, so the decoder can name its columns
+         *
+         * Definitions are written at the start of every file. Define channels before sending on them from other tasks.
+         *
+         * @param channel channel ID, from 1 to MAX_CHANNELS - 2
+         * @param name name of the channel
+         * @param fields name of every field, in the order they are sent
+         */
+        void defineChannel(uint8_t channel, std::string_view name, std::initializer_list<std::string_view> fields);
+        /**
+         * @brief Record values on a channel as a binary frame. Does nothing unless recording
+         *
+         * Never blocks or allocates, and ignores the lowest level of the sink.
+         *
+         * @param channel channel ID
+         * @param values floats, integers, bools or strings
+         */
+        template <typename... T> void send(uint8_t channel, const T&... values) {
+            if (!isRecording()) return;
+            TelemetryFrame frame(channel, pros::millis());
+            (frame.add(values), ...);
+            sendFrame(frame);
+        }
+        /**
+         * @brief Get the number of frames dropped because the recorder fell behind
+         */
+        uint32_t getDropped() const;
+        /**
+         * @brief Get the number of bytes written to the card
+         */
+        uint32_t getBytesWritten() const;
+    private:
+        // sent through the buffer in order with the frames. Frames are always longer than one byte
+        enum class Command : char { FLUSH = 'f', ROTATE = 'r' };
+        // times a command is retried while the calling task's ring is full, a period of the buffer's task apart
+        static constexpr int COMMAND_RETRIES = 20;
+
+        struct Chunk {
+                alignas(4) std::array<uint8_t, CHUNK_SIZE> data;
+                size_t size;
+                // close the file once the chunk is written
+                bool endsFile;
+        };
+
+        /**
+         * @brief Record the given message on LOG_CHANNEL
+         *
+         * @param message
+         */
+        void sendMessage(const Message& message) override;
+        /**
+         * @brief Push a command to the buffer, retrying while the calling task's ring is full
+         *
+         * @param command
+         * @return true the command was pushed
+         */
+        bool pushCommand(Command command);
+        /**
+         * @brief Encode a frame and push it to the buffer
+         *
+         * @param frame
+         */
+        void sendFrame(const TelemetryFrame& frame);
+        /**
+         * @brief Copy a frame or run a command from the buffer. Runs on the buffer's task
+         *
+         * @param data
+         */
+        void record(std::string_view data);
+        /**
+         * @brief Give the chunk being filled to the writer. Runs on the buffer's task
+         *
+         * @param endsFile
+         */
+        void handOver(bool endsFile);
+        /**
+         * @brief Write every chunk given to the writer so far to the card. Runs on the writer's task, once per period
+         */
+        void writePending();
+        /**
+         * @brief Open the next free file and write the channel definitions to it. Stops recording if every name is taken
+         */
+        void openFile();
+        /**
+         * @brief Encode a channel definition, to be written at the start of every file
+         */
+        void encodeSchema(uint8_t channel, std::string_view name, std::initializer_list<std::string_view> fields);
+
+        std::atomic<bool> recording {false};
+        const char* directory = "/usd/";
+        std::unique_ptr<Buffer> frameBuffer;
+        std::unique_ptr<PeriodicTask> writer;
+
+        std::array<Chunk, CHUNKS> chunks {};
+        // chunks given to the writer, only written by the buffer's task
+        std::atomic<uint32_t> filled {0};
+        // chunks the writer is done with, only written by the writer
+        std::atomic<uint32_t> written {0};
+        // only used by the buffer's task
+        size_t fill = 0;
+        uint32_t chunkStart = 0;
+        bool endPending = false;
+
+        // only used by the writer
+        FILE* file = nullptr;
+        int fileIndex = 0;
+        size_t fileSize = 0;
+        // the channel definitions, copied out so the card is written without holding schemaMutex
+        std::array<uint8_t, MAX_CHANNELS * TelemetryFrame::MAX_ENCODED_SIZE> header {};
+
+        std::atomic<uint32_t> dropped {0};
+        std::atomic<uint32_t> bytesWritten {0};
+
+        // encoded channel definitions, read by the writer when it opens a file
+        pros::Mutex schemaMutex;
+        std::array<std::array<uint8_t, TelemetryFrame::MAX_ENCODED_SIZE>, MAX_CHANNELS> schemas {};
+        std::array<size_t, MAX_CHANNELS> schemaSizes {};
+};
+} // namespace lemlib
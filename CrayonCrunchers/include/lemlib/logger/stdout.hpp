@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+
 #define FMT_HEADER_ONLY
 #include "fmt/core.h"
 
@@ -22,7 +25,10 @@ class BufferedStdout : public Buffer {
          *
          */
         template <typename... T> void print(fmt::format_string<T...> format, T&&... args) {
-            pushToBuffer(fmt::format(format, std::forward<T>(args)...));
+            // one character more than a slot holds, so pushToBuffer can tell the string was cut short
+            std::array<char, SLOT_SIZE + 1> text;
+            const auto result = fmt::format_to_n(text.data(), text.size(), format, std::forward<T>(args)...);
+            pushToBuffer(std::string_view(text.data(), std::min(result.size, text.size())));
         }
 };
 
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace lemlib {
+/**
+ * @brief Type of a field in a binary telemetry frame
+ */
+enum class TelemetryType : uint8_t {
+    FLOAT = 1, /** 32 bit float */
+    INT = 2, /** 32 bit signed integer */
+    BOOL = 3, /** 1 byte, 0 or 1 */
+    STRING = 4 /** 1 byte length, then the characters */
+};
+
+/**
+ * @brief A binary telemetry frame
+ *
+ * A frame is a channel ID, a timestamp in milliseconds and a list of typed fields, all little endian, followed by a
+ * CRC-16 of everything before it. It is sent COBS encoded and ended with a 0 byte, so a decoder can find frames in a
+ * stream that also has text in it: the text between frames fails the CRC and is skipped.
+ *
+ * Channel 0 describes the other channels. Its fields are the channel ID, the channel name, then the name of every
+ * field, so a decoder can name its columns.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::TelemetryFrame frame(1, pros::millis());
+ * frame.add(pose.x);
+ * frame.add(pose.y);
+ * std::array<uint8_t, lemlib::TelemetryFrame::MAX_ENCODED_SIZE> encoded;
+ * const size_t size = frame.encode(encoded.data());
+ * @endcode
+ */
+class TelemetryFrame {
+    public:
+        /** most bytes of fields a frame can hold */
+        static constexpr size_t MAX_PAYLOAD = 120;
+        /** most bytes an encoded frame can take, including the 0 at the end */
+        static constexpr size_t MAX_ENCODED_SIZE = 1 + 5 + MAX_PAYLOAD + 2 + (5 + MAX_PAYLOAD + 2) / 254 + 1;
+        /** channel that describes the other channels */
+        static constexpr uint8_t SCHEMA_CHANNEL = 0;
+
+        /**
+         * @brief Create a new empty frame
+         *
+         * @param channel ID of the channel the frame belongs to
+         * @param time timestamp, in milliseconds
+         */
+        TelemetryFrame(uint8_t channel, uint32_t time);
+        /**
+         * @brief Add a field to the frame. Fields that don't fit are left out
+         *
+         * @param value a float or double, an integer, a bool or a string up to 255 characters
+         */
+        template <typename T> void add(const T& value) {
+            if constexpr (std::is_same_v<T, bool>) {
+                const uint8_t byte = value;
+                addField(TelemetryType::BOOL, &byte, 1);
+            } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+                const int32_t integer = static_cast<int32_t>(value);
+                addField(TelemetryType::INT, &integer, 4);
+            } else if constexpr (std::is_floating_point_v<T>) {
+                const float number = static_cast<float>(value);
+                addField(TelemetryType::FLOAT, &number, 4);
+            } else {
+                addString(std::string_view(value));
+            }
+        }
+        /**
+         * @brief COBS encode the frame, with its CRC and the 0 that ends it
+         *
+         * @param out where to write the frame, at least MAX_ENCODED_SIZE bytes
+         * @return size_t number of bytes written
+         */
+        size_t encode(uint8_t* out) const;
+        /**
+         * @brief Whether a field was left out because the frame was full
+         */
+        bool isTruncated() const { return truncated; }
+    private:
+        void addField(TelemetryType type, const void* value, size_t size);
+        void addString(std::string_view string);
+
+        // channel, timestamp, then fields
+        std::array<uint8_t, 5 + MAX_PAYLOAD> data {};
+        size_t size = 5;
+        bool truncated = false;
+};
+
+/**
+ * @brief A field of a decoded frame
+ */
+struct TelemetryField {
+        TelemetryType type;
+        float number = 0;
+        int32_t integer = 0;
+        std::string_view string;
+};
+
+/**
+ * @brief A decoded frame
+ */
+struct DecodedTelemetryFrame {
+        uint8_t channel = 0;
+        uint32_t time = 0;
+        int fieldCount = 0;
+        std::array<TelemetryField, TelemetryFrame::MAX_PAYLOAD / 2> fields {};
+};
+
+/**
+ * @brief Decode one frame
+ *
+ * @param encoded the bytes between two 0s in the stream, without the 0s
+ * @param size number of bytes
+ * @param scratch space for the decoded bytes, at least size bytes. Strings in the frame point into it
+ * @param frame where to put the decoded frame
+ * @return true the bytes were a valid frame
+ * @return false they weren't, because of a bad CRC, bad COBS or fields that don't parse
+ */
+bool decodeTelemetryFrame(const uint8_t* encoded, size_t size, uint8_t* scratch, DecodedTelemetryFrame& frame);
+} // namespace lemlib
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+
 #include "lemlib/logger/baseSink.hpp"
+#include "lemlib/logger/buffer.hpp"
+#include "lemlib/logger/telemetryFrame.hpp"
 
 namespace lemlib {
 /**
@@ -10,19 +18,65 @@ namespace lemlib {
  * used for sending data that is not meant to be viewed by the user, but will still be used by something else, like a
  * data visualization tool. Messages sent through this sink will not be cleared from the terminal and not be visible to
  * the user.
+ *
+ * The sink also has a binary mode for streaming data at high rates. Values are sent as typed fields of a
+ * TelemetryFrame instead of text, which takes a fraction of the CPU time and serial bandwidth.
 
  * <h3> Example Usage </h3>
  * @code
  * lemlib::telemetrySink()->setLowestLevel(lemlib::Level::INFO);
  * lemlib::telemetrySink()->info("{},{}", motor1.get_temperature(), motor2.get_temperature());
+ *
+ * // binary telemetry
+ * lemlib::telemetrySink()->setBinary(true);
+ * lemlib::telemetrySink()->defineChannel(1, "temperature", {"motor1", "motor2"});
+ * lemlib::telemetrySink()->send(1, motor1.get_temperature(), motor2.get_temperature());
  * @endcode
  */
 class TelemetrySink : public BaseSink {
     public:
+        /** highest channel ID that can be defined, plus one */
+        static constexpr size_t MAX_CHANNELS = 16;
+
         /**
          * @brief Construct a new Telemetry Sink object
          */
         TelemetrySink();
+        /**
+         * @brief Turn binary telemetry on or off
+         *
+         * Binary frames contain 0 bytes, so turning binary mode on also turns off the PROS stream framing on the
+         * serial port. Capture the raw serial output and decode it with sim/app/telemetry_decode. Text messages are
+         * still sent, and the decoder skips them.
+         *
+         * @param binary
+         */
+        void setBinary(bool binary);
+        /**
+         * @brief Name a channel and its fields, so the decoder can name its columns
+         *
+         * The definition is sent straight away, and again every so often so a decoder that starts late still gets
+         * it. Define channels before sending on them from other tasks.
+         *
+         * @param channel channel ID, from 1 to MAX_CHANNELS - 1
+         * @param name name of the channel
+         * @param fields name of every field, in the order they are sent
+         */
+        void defineChannel(uint8_t channel, std::string_view name, std::initializer_list<std::string_view> fields);
+        /**
+         * @brief Send values on a channel as a binary frame. Does nothing unless binary mode is on
+         *
+         * Never blocks or allocates, and ignores the lowest level of the sink.
+         *
+         * @param channel channel ID
+         * @param values floats, integers, bools or strings
+         */
+        template <typename... T> void send(uint8_t channel, const T&... values) {
+            if (!binary) return;
+            TelemetryFrame frame(channel, pros::millis());
+            (frame.add(values), ...);
+            sendFrame(frame);
+        }
     private:
         /**
          * @brief Log the given message
@@ -30,5 +84,21 @@ class TelemetrySink : public BaseSink {
          * @param message
          */
         void sendMessage(const Message& message) override;
+        /**
+         * @brief Encode a frame and push it, and a channel definition if one is due
+         *
+         * @param frame
+         */
+        void sendFrame(const TelemetryFrame& frame);
+
+        bool binary = false;
+        // frames go out through their own buffer, so they don't wait behind text
+        std::unique_ptr<Buffer> frameBuffer;
+        // encoded channel definitions, sent again in turn
+        std::array<std::array<uint8_t, TelemetryFrame::MAX_ENCODED_SIZE>, MAX_CHANNELS> schemas {};
+        std::array<size_t, MAX_CHANNELS> schemaSizes {};
+        // every task that sends can find a definition due, so the one that moves lastSchemaTime on sends it
+        std::atomic<size_t> nextSchema = 0;
+        std::atomic<uint32_t> lastSchemaTime = 0;
 };
 } // namespace lemlib
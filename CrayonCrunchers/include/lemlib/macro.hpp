@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace lemlib {
+/**
+ * @brief A sequence of steps, run a step at a time by a MacroScheduler
+ *
+ * Each step runs its action once when it starts, then waits for a time, for a condition, or for neither. A macro
+ * claims resources, bit flags the program picks for the motors and pneumatics it drives, so the scheduler knows which
+ * macros can't run together. Actions and conditions run in the task updating the scheduler, and mustn't start or
+ * cancel macros themselves.
+ *
+ * @b Example
+ * @code {.cpp}
+ * constexpr uint32_t ARM = 1 << 0;
+ * constexpr uint32_t CONVEYOR = 1 << 1;
+ * static lemlib::Macro score("score", ARM | CONVEYOR);
+ * score.then([] { ladyBrown.moveTo(lemlib::ArmPreset::SCORE); })
+ *     .waitUntil([] { return ladyBrown.isSettled(); }, 700)
+ *     .then([] { spinConveyor = -1; })
+ *     .wait(300)
+ *     .then([] { spinConveyor = 0; })
+ *     .onCancel([] { spinConveyor = 0; });
+ * @endcode
+ */
+class Macro {
+    public:
+        /**
+         * @brief Construct a new Macro, with no steps
+         *
+         * @param name name of the macro, for logging. Has to outlive the macro
+         * @param resources resources the macro drives, as bit flags
+         * @param priority macros only take resources from macros with the same priority or lower
+         */
+        Macro(const char* name, uint32_t resources, int priority = 0);
+
+        /**
+         * @brief Add a step that runs an action, and moves straight on
+         *
+         * @param action the action
+         * @return Macro& this macro, to add more steps
+         */
+        Macro& then(std::function<void()> action);
+        /**
+         * @brief Add a step that waits for a time
+         *
+         * @param time how long to wait, in milliseconds
+         * @return Macro& this macro, to add more steps
+         */
+        Macro& wait(uint32_t time);
+        /**
+         * @brief Add a step that waits for a condition. Checked once per update, so keep it quick
+         *
+         * @param condition the condition
+         * @param timeout longest to wait, in milliseconds. The macro carries on after it, like a motion timing out
+         * @return Macro& this macro, to add more steps
+         */
+        Macro& waitUntil(std::function<bool()> condition, uint32_t timeout = UINT32_MAX);
+        /**
+         * @brief Set an action to run if the macro is cancelled before it finishes, to leave its resources safe
+         *
+         * @param action the action
+         * @return Macro& this macro
+         */
+        Macro& onCancel(std::function<void()> action);
+
+        const char* getName() const { return name; }
+
+        uint32_t getResources() const { return resources; }
+
+        int getPriority() const { return priority; }
+    private:
+        friend class MacroScheduler;
+
+        struct Step {
+                std::function<void()> action;
+                std::function<bool()> condition;
+                uint32_t timeout;
+        };
+
+        const char* name;
+        uint32_t resources;
+        int priority;
+        std::vector<Step> steps;
+        std::function<void()> cancelAction;
+
+        // where the macro is, while it runs
+        size_t step = 0;
+        bool stepStarted = false;
+        uint32_t stepStart = 0;
+};
+
+/**
+ * @brief Runs macros a step at a time, alongside whatever else the loop calling it does
+ *
+ * update never waits, so a loop that drives the robot keeps its cadence however long the macros take. Two macros
+ * wanting the same resource can't run together. Starting a macro cancels the running ones it shares a resource with,
+ * unless one of them has a higher priority, in which case it doesn't start. Starting a macro that is running starts it
+ * over. Controls the driver works directly should check isFree before driving a resource, and cancel the macros on it
+ * when the driver takes over.
+ *
+ * Not thread safe. Start, cancel and update macros from one task.
+ *
+ * @b Example
+ * @code {.cpp}
+ * static lemlib::MacroScheduler macros;
+ * while (true) {
+ *     chassis.arcade(leftY, rightX);
+ *     if (controller.get_digital_new_press(DIGITAL_UP)) macros.start(score);
+ *     if (macros.isFree(CONVEYOR)) spinConveyor = controller.get_digital(DIGITAL_R2);
+ *     macros.update();
+ *     loop.wait();
+ * }
+ * @endcode
+ */
+class MacroScheduler {
+    public:
+        /** most macros that can run at once */
+        static constexpr size_t MAX_RUNNING = 8;
+
+        /**
+         * @brief Start a macro from its first step. The step runs at the next update
+         *
+         * @param macro the macro. Has to outlive the scheduler
+         * @return true the macro started, cancelling any it shares a resource with
+         * @return false a running macro with a higher priority has one of its resources
+         */
+        bool start(Macro& macro);
+        /**
+         * @brief Cancel a macro, if it is running
+         *
+         * @param macro the macro
+         */
+        void cancel(Macro& macro);
+        /**
+         * @brief Cancel every running macro that drives any of a set of resources
+         *
+         * @param resources the resources, as bit flags
+         */
+        void cancel(uint32_t resources);
+        /**
+         * @brief Cancel every running macro
+         */
+        void cancelAll();
+        /**
+         * @brief Run a step of every running macro, starting steps that are due and finishing macros that are done
+         */
+        void update();
+        /**
+         * @brief Whether a macro is running
+         *
+         * @param macro the macro
+         */
+        bool isRunning(const Macro& macro) const;
+        /**
+         * @brief Whether no running macro drives any of a set of resources
+         *
+         * @param resources the resources, as bit flags
+         */
+        bool isFree(uint32_t resources) const { return (owned & resources) == 0; }
+    private:
+        /**
+         * @brief Stop running a macro, without cancelling it
+         *
+         * @param index index of the macro in running
+         */
+        void remove(size_t index);
+
+        std::array<Macro*, MAX_RUNNING> running {};
+        size_t count = 0;
+        // resources of every running macro
+        uint32_t owned = 0;
+};
+} // namespace lemlib
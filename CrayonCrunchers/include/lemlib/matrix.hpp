@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace lemlib {
+/**
+ * @brief Fixed size matrix of floats
+ *
+ * The size is part of the type, so the storage lives inline and nothing is ever allocated. Meant for the small
+ * matrices used by filters in the odom loop, where a heap allocation every 10 ms is not acceptable.
+ *
+ * @tparam R number of rows
+ * @tparam C number of columns
+ */
+template <size_t R, size_t C> class Matrix {
+    public:
+        /**
+         * @brief Construct a matrix filled with zeros
+         */
+        constexpr Matrix() : data {} {}
+
+        /**
+         * @brief Construct a square matrix with a value along the diagonal and zeros elsewhere
+         *
+         * @param value the value on the diagonal
+         * @return Matrix
+         */
+        static constexpr Matrix diagonal(float value) {
+            static_assert(R == C, "only a square matrix has a diagonal");
+            Matrix result;
+            for (size_t i = 0; i < R; i++) result(i, i) = value;
+            return result;
+        }
+
+        /**
+         * @brief Construct an identity matrix
+         *
+         * @return Matrix
+         */
+        static constexpr Matrix identity() { return diagonal(1); }
+
+        constexpr float& operator()(size_t row, size_t col) { return data[row * C + col]; }
+
+        constexpr float operator()(size_t row, size_t col) const { return data[row * C + col]; }
+
+        constexpr Matrix operator+(const Matrix& other) const {
+            Matrix result;
+            for (size_t i = 0; i < R * C; i++) result.data[i] = data[i] + other.data[i];
+            return result;
+        }
+
+        constexpr Matrix operator-(const Matrix& other) const {
+            Matrix result;
+            for (size_t i = 0; i < R * C; i++) result.data[i] = data[i] - other.data[i];
+            return result;
+        }
+
+        constexpr Matrix operator*(float scalar) const {
+            Matrix result;
+            for (size_t i = 0; i < R * C; i++) result.data[i] = data[i] * scalar;
+            return result;
+        }
+
+        template <size_t K> constexpr Matrix<R, K> operator*(const Matrix<C, K>& other) const {
+            Matrix<R, K> result;
+            for (size_t i = 0; i < R; i++) {
+                for (size_t k = 0; k < C; k++) {
+                    const float a = (*this)(i, k);
+                    if (a == 0) continue; // filter jacobians are mostly zeros
+                    for (size_t j = 0; j < K; j++) result(i, j) += a * other(k, j);
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Get the transpose of the matrix
+         *
+         * @return Matrix<C, R>
+         */
+        constexpr Matrix<C, R> transpose() const {
+            Matrix<C, R> result;
+            for (size_t i = 0; i < R; i++)
+                for (size_t j = 0; j < C; j++) result(j, i) = (*this)(i, j);
+            return result;
+        }
+    private:
+        std::array<float, R * C> data;
+};
+
+/**
+ * @brief Column vector
+ *
+ * @tparam N number of rows
+ */
+template <size_t N> using Vector = Matrix<N, 1>;
+} // namespace lemlib
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "pros/motors.hpp"
+#include "lemlib/exitcondition.hpp"
+#include "lemlib/periodic.hpp"
+#include "lemlib/pid.hpp"
+
+namespace lemlib {
+/**
+ * @brief A named position of an arm
+ */
+enum class ArmPreset {
+    /** down, where it is when the program starts */
+    STOWED,
+    /** raised a little, to catch a ring off the conveyor */
+    PRIMED,
+    /** up, to put the ring on a stake */
+    SCORE,
+    /** run by hand with Arm::move, and held where it was left */
+    MANUAL
+};
+
+/**
+ * @brief Get the name of an arm preset, for logging
+ *
+ * @param preset the preset
+ * @return const char*
+ */
+const char* toString(ArmPreset preset);
+
+/**
+ * @brief class containing constants for an arm
+ */
+class ArmSettings {
+    public:
+        /**
+         * @brief ArmSettings constructor
+         *
+         * Positions are angles of the arm, not the motor, in degrees up from where it is stowed
+         *
+         * @param kP proportional gain, out of 127 per degree
+         * @param kI integral gain
+         * @param kD derivative gain
+         * @param gravity power that holds the arm up when it sticks out level, out of 127
+         * @param gearRatio motor turns per turn of the arm
+         * @param stowedAngle angle of the arm from level when it is stowed, in degrees. Negative is below level
+         * @param primedPosition position of the arm when primed
+         * @param scorePosition position of the arm when scoring
+         * @param tolerance how close to its target the arm has to be to be settled, in degrees
+         * @param settleTime how long the arm has to be close to its target to be settled, in milliseconds
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::ArmSettings armSettings(8, // proportional gain (kP)
+         *                                 0, // integral gain (kI)
+         *                                 30, // derivative gain (kD)
+         *                                 12, // gravity feedforward, out of 127
+         *                                 5, // gear ratio, motor turns per arm turn
+         *                                 -60, // stowed angle, in degrees
+         *                                 22, // primed position, in degrees
+         *                                 150, // score position, in degrees
+         *                                 3, // tolerance, in degrees
+         *                                 100); // settle time, in milliseconds
+         * @endcode
+         */
+        ArmSettings(float kP, float kI, float kD, float gravity, float gearRatio, float stowedAngle,
+                    float primedPosition, float scorePosition, float tolerance, int settleTime)
+            : kP(kP),
+              kI(kI),
+              kD(kD),
+              gravity(gravity),
+              gearRatio(gearRatio),
+              stowedAngle(stowedAngle),
+              primedPosition(primedPosition),
+              scorePosition(scorePosition),
+              tolerance(tolerance),
+              settleTime(settleTime) {}
+
+        float kP;
+        float kI;
+        float kD;
+        float gravity;
+        float gearRatio;
+        float stowedAngle;
+        float primedPosition;
+        float scorePosition;
+        float tolerance;
+        int settleTime;
+};
+
+/**
+ * @brief Holds an arm at one of its presets, moving between them in its own task
+ *
+ * The arm's position comes from its motor's encoder, which is zeroed when the arm starts, so it has to be stowed then,
+ * or once it has been driven against a hard stop with resetPosition. A PID moves it to its target, and a feedforward
+ * holds it up against gravity, strongest when it sticks out level. moveTo returns straight away. Wait for the arm with
+ * waitUntilSettled when something has to happen after it gets there.
+ *
+ * move runs the arm at a power instead, like pros::Motor::move, and holds it where it is once the power is 0. It
+ * doesn't depend on the presets, so use it where they haven't been measured on the robot yet. The arm isn't driven at
+ * all until it is first told to move, so it can be set up by hand after the program starts.
+ *
+ * Everything can be called from any task.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // in initialize
+ * ladyBrown.initialize();
+ * // in a route
+ * ladyBrown.moveTo(lemlib::ArmPreset::SCORE);
+ * ladyBrown.waitUntilSettled(700);
+ * ladyBrown.moveTo(lemlib::ArmPreset::STOWED);
+ * @endcode
+ */
+class Arm {
+    public:
+        /** how often the arm is updated, in milliseconds */
+        static constexpr uint32_t PERIOD = 10;
+
+        /**
+         * @brief Construct a new Arm
+         *
+         * @param motor motor of the arm
+         * @param settings constants for the arm
+         */
+        Arm(pros::Motor* motor, ArmSettings settings);
+
+        /**
+         * @brief Zero the encoder with the arm stowed, and start the arm's task
+         */
+        void initialize();
+        /**
+         * @brief Tell the arm it is at a preset, and hold it there. Use it once the arm is against a hard stop, or at
+         * the start of a route to say where the arm starts
+         *
+         * @param preset where the arm is. Not MANUAL
+         */
+        void resetPosition(ArmPreset preset);
+        /**
+         * @brief Run the arm at a power instead of holding a preset, until it is told to move to one
+         *
+         * @param power power to run at, out of 127. 0 holds the arm where it is
+         */
+        void move(float power);
+        /**
+         * @brief Start moving the arm to a preset
+         *
+         * @param preset the preset
+         */
+        void moveTo(ArmPreset preset);
+        /**
+         * @brief Get the preset the arm was last told to move to
+         *
+         * @return ArmPreset
+         */
+        ArmPreset getPreset() const { return preset.load(std::memory_order_relaxed); }
+        /**
+         * @brief Whether the arm has got to the last preset it was told to move to
+         */
+        bool isSettled() const;
+        /**
+         * @brief Wait until the arm has got to the last preset it was told to move to
+         *
+         * @param timeout longest to wait, in milliseconds
+         * @return true the arm settled
+         * @return false the timeout ran out first
+         */
+        bool waitUntilSettled(uint32_t timeout) const;
+        /**
+         * @brief Get the position of the arm at its last update
+         *
+         * @return float position, in degrees up from stowed
+         */
+        float getPosition() const { return position.load(std::memory_order_relaxed); }
+        /**
+         * @brief Get the power the arm was last run at
+         *
+         * @return float power, out of 127
+         */
+        float getPower() const { return power.load(std::memory_order_relaxed); }
+        /**
+         * @brief Get the position of a preset
+         *
+         * @param preset the preset. The position the arm is held at for MANUAL
+         * @return float position, in degrees up from stowed
+         */
+        float getTarget(ArmPreset preset) const;
+    private:
+        /**
+         * @brief Run the arm towards its target. Runs in the arm's task
+         */
+        void update();
+
+        pros::Motor* motor;
+        ArmSettings settings;
+        PID pid;
+        ExitCondition settle;
+
+        std::atomic<ArmPreset> preset = ArmPreset::STOWED;
+        std::atomic<float> manualPower = 0;
+        std::atomic<float> holdPosition = 0; // where a MANUAL arm is held once its power is 0
+        std::atomic<bool> reset = false; // the next update zeroes the encoder at the preset
+        float offset = 0; // position of the arm when the encoder was last zeroed. Only used by the arm's task
+        // counts moves, so the task knows to start a new one, and a move only settles for the target it was for
+        std::atomic<uint32_t> moves = 0;
+        std::atomic<uint32_t> settledMove = 0;
+        uint32_t lastMove = 0;
+        std::atomic<float> position = 0;
+        std::atomic<float> power = 0;
+        std::unique_ptr<PeriodicTask> task;
+};
+} // namespace lemlib
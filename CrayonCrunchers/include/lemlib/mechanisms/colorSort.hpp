@@ -0,0 +1,209 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "pros/motors.hpp"
+#include "pros/optical.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/seqlock.hpp"
+#include "lemlib/mechanisms/ringClassifier.hpp"
+
+namespace lemlib {
+/**
+ * @brief A reading of a color sorter's optical sensor, and what it made of it
+ */
+struct ColorReading {
+        OpticalSample sample;
+        RingClassification ring;
+        /** color being calibrated, or -1 when not calibrating */
+        int label = -1;
+        /** when the sensor was read, in milliseconds */
+        uint32_t time = 0;
+};
+
+/**
+ * @brief class containing constants for a color sorter
+ */
+class ColorSortSettings {
+    public:
+        /**
+         * @brief ColorSortSettings constructor
+         *
+         * Distances are in the conveyor motor's encoder units, degrees by default, so they don't depend on how fast
+         * the conveyor runs
+         *
+         * @param ejectDistance how far the conveyor travels from when a ring is in front of the optical sensor to when
+         * it has to reverse to throw it off
+         * @param reverseDistance how far the conveyor reverses to throw a ring off
+         * @param ringLength how far the conveyor travels while one ring passes the optical sensor. Rings seen closer
+         * together than this are taken to be the same ring
+         * @param latency how old a reading of the optical sensor is when it arrives, in milliseconds
+         * @param reverseTimeout longest the conveyor reverses, in milliseconds, in case it is stopped or blocked
+         * @param minConfidence lowest confidence of the classifier that a ring is the color it picked, from 0 to 1
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::ColorSortSettings colorSortSettings(190, // eject distance, in degrees
+         *                                             360, // reverse distance, in degrees
+         *                                             120, // ring length, in degrees
+         *                                             20, // optical sensor latency, in milliseconds
+         *                                             400, // reverse timeout, in milliseconds
+         *                                             0.9); // minimum confidence
+         * @endcode
+         */
+        ColorSortSettings(float ejectDistance, float reverseDistance, float ringLength, float latency,
+                          uint32_t reverseTimeout, float minConfidence)
+            : ejectDistance(ejectDistance),
+              reverseDistance(reverseDistance),
+              ringLength(ringLength),
+              latency(latency),
+              reverseTimeout(reverseTimeout),
+              minConfidence(minConfidence) {}
+
+        float ejectDistance;
+        float reverseDistance;
+        float ringLength;
+        float latency;
+        uint32_t reverseTimeout;
+        float minConfidence;
+};
+
+/**
+ * @brief Throws rings of the wrong color off the top of a conveyor
+ *
+ * Every ring of the wrong color is marked with where the conveyor was when it passed the optical sensor, and thrown
+ * off once the conveyor has carried it a fixed distance further. Loop timing and conveyor speed don't change where
+ * that is, and rings can be marked while another one is still on its way up. The conveyor reverses until it has gone
+ * back far enough, then carries on.
+ *
+ * The optical sensor only reports every SAMPLE_PERIOD milliseconds, so it is read that often, once per reading. The
+ * conveyor's position is read every update, so update as often as the conveyor is driven.
+ *
+ * Colors are told apart by a RingClassifier. Calibrate it on the field before a match: start calibrating each color in
+ * turn, with it held in front of the sensor, and finish. The model is saved to the microSD card, and loaded again when
+ * the program starts.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // in initialize
+ * colorSort.initialize();
+ * // every 10 ms, in the task driving the conveyor
+ * const bool reversing = colorSort.update(alliance ? lemlib::RingColor::RED : lemlib::RingColor::BLUE);
+ * conveyor.move(reversing ? -100 : 120);
+ * @endcode
+ */
+class ColorSort {
+    public:
+        /** how often the optical sensor reports, in milliseconds */
+        static constexpr uint32_t SAMPLE_PERIOD = 20;
+        /** most rings that can be on their way to being thrown off at once */
+        static constexpr size_t MAX_PENDING = 4;
+        /** where the classifier's model is saved */
+        static constexpr const char* MODEL_PATH = "/usd/ring_colors.txt";
+
+        /**
+         * @brief Construct a new ColorSort
+         *
+         * @param optical optical sensor the rings pass in front of
+         * @param conveyor motor of the conveyor
+         * @param settings constants for the sorter
+         */
+        ColorSort(pros::Optical* optical, pros::Motor* conveyor, ColorSortSettings settings);
+
+        /**
+         * @brief Turn on the optical sensor's LED, make it report as often as it is read, and load the saved model
+         */
+        void initialize();
+        /**
+         * @brief Look for rings, and throw off the ones that are due
+         *
+         * @param rejected color of the rings to throw off. NONE stops marking rings, but the marked ones are still
+         * thrown off
+         * @return true the conveyor should be reversing, to throw off a ring
+         * @return false the conveyor should run as usual
+         */
+        bool update(RingColor rejected);
+        /**
+         * @brief Forget every marked ring, and stop reversing
+         */
+        void reset();
+        /**
+         * @brief Start collecting readings of a color to calibrate the classifier with. No rings are marked until
+         * calibration finishes
+         *
+         * @param color color held in front of the sensor. NONE for nothing in front of it
+         */
+        void calibrate(RingColor color);
+        /**
+         * @brief Fit the classifier to the readings collected, and save it
+         *
+         * @return true the classifier was fitted. It is saved if there is a microSD card
+         * @return false some color didn't have enough readings. The classifier is left as it was
+         */
+        bool finishCalibration();
+        /**
+         * @brief Get the last reading of the optical sensor. Can be called from any task
+         *
+         * @return ColorReading
+         */
+        ColorReading getReading() const { return reading.read(); }
+        /**
+         * @brief Get the color of the ring in front of the optical sensor at its last reading
+         *
+         * @return RingColor
+         */
+        RingColor getSeen() const { return seen; }
+        /**
+         * @brief Get the number of rings marked but not thrown off yet
+         *
+         * @return size_t
+         */
+        size_t getPending() const { return pending; }
+        /**
+         * @brief Get the number of rings thrown off since the program started
+         *
+         * @return uint32_t
+         */
+        uint32_t getEjected() const { return ejected; }
+        /**
+         * @brief Get how far the conveyor travels from a ring passing the optical sensor to it being thrown off, in
+         * degrees
+         *
+         * @return float
+         */
+        float getEjectDistance() const { return settings.ejectDistance; }
+    private:
+        /**
+         * @brief Mark a ring to be thrown off, unless it is already marked
+         *
+         * @param position where the conveyor was when the ring passed the optical sensor
+         */
+        void mark(float position);
+
+        pros::Optical* optical;
+        pros::Motor* conveyor;
+        ColorSortSettings settings;
+
+        // the classifier is fitted from whichever task finishes calibrating, while the conveyor's task uses it
+        pros::Mutex classifierMutex;
+        RingClassifier classifier;
+        int calibrating = -1;
+        SeqLock<ColorReading> reading {ColorReading {}};
+
+        // where the conveyor was when each marked ring passed the sensor, oldest first
+        std::array<float, MAX_PENDING> marks {};
+        size_t first = 0;
+        size_t pending = 0;
+        // the last ring marked, so one ring seen over several readings is only marked once
+        float lastMark = 0;
+        bool marked = false;
+
+        RingColor seen = RingColor::NONE;
+        uint32_t lastSample = 0;
+        bool reversing = false;
+        float reverseEnd = 0;
+        uint32_t reverseStart = 0;
+        uint32_t ejected = 0;
+};
+} // namespace lemlib
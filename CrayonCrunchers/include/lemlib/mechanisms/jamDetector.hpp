@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstdint>
+#include "pros/motors.hpp"
+
+namespace lemlib {
+/**
+ * @brief What a jam detector is doing
+ */
+enum class JamState {
+    /** running as commanded */
+    RUNNING,
+    /** jammed, running backwards to clear it */
+    REVERSING,
+    /** stopped for a moment after reversing */
+    PAUSED,
+    /** running as commanded again, to see if the jam cleared */
+    RETRYING,
+    /** stopped, because every retry jammed again. Runs again after a cooldown, or once commanded to stop */
+    GAVE_UP
+};
+
+/**
+ * @brief Get the name of a jam state, for logging
+ *
+ * @param state the state
+ * @return const char*
+ */
+const char* toString(JamState state);
+
+/**
+ * @brief Counts of what a jam detector has done since the program started
+ */
+struct JamStats {
+        /** number of jams detected. Each one ends up cleared or given up on */
+        uint32_t jams = 0;
+        /** number of retries that jammed again, and were reversed again */
+        uint32_t retries = 0;
+        /** number of jams cleared by reversing */
+        uint32_t cleared = 0;
+        /** number of times every retry jammed again */
+        uint32_t gaveUp = 0;
+        /** longest it took to clear a jam, from detecting it to the retry running clear, in milliseconds */
+        uint32_t maxClearTime = 0;
+};
+
+/**
+ * @brief class containing constants for a jam detector
+ */
+class JamDetectorSettings {
+    public:
+        /**
+         * @brief JamDetectorSettings constructor
+         *
+         * @param stallCurrent current draw above which the motor is straining, in mA
+         * @param stallTorque torque above which the motor is straining, in Nm
+         * @param stallSpeed fraction of its commanded speed under which the motor is stalled, from 0 to 1
+         * @param jamTime how long the motor has to be straining and stalled to be jammed, in milliseconds
+         * @param filterTime time constant of the filter on the readings, in milliseconds
+         * @param reversePower power to reverse at, out of 127
+         * @param reverseTime how long to reverse, in milliseconds
+         * @param pauseTime how long to stop after reversing, in milliseconds
+         * @param retryTime how long a retry has to run without jamming to count as cleared, in milliseconds
+         * @param maxAttempts number of times to reverse for one jam before giving up
+         * @param cooldownTime how long to stay stopped after giving up before trying again, in milliseconds
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::JamDetectorSettings jamSettings(1800, // stall current, in mA
+         *                                         0.8, // stall torque, in Nm
+         *                                         0.15, // stall speed, out of the commanded speed
+         *                                         120, // jam time, in milliseconds
+         *                                         30, // filter time constant, in milliseconds
+         *                                         80, // reverse power, out of 127
+         *                                         250, // reverse time, in milliseconds
+         *                                         100, // pause time, in milliseconds
+         *                                         400, // retry time, in milliseconds
+         *                                         3, // attempts before giving up
+         *                                         1000); // cooldown after giving up, in milliseconds
+         * @endcode
+         */
+        JamDetectorSettings(float stallCurrent, float stallTorque, float stallSpeed, uint32_t jamTime,
+                            float filterTime, int reversePower, uint32_t reverseTime, uint32_t pauseTime,
+                            uint32_t retryTime, int maxAttempts, uint32_t cooldownTime)
+            : stallCurrent(stallCurrent),
+              stallTorque(stallTorque),
+              stallSpeed(stallSpeed),
+              jamTime(jamTime),
+              filterTime(filterTime),
+              reversePower(reversePower),
+              reverseTime(reverseTime),
+              pauseTime(pauseTime),
+              retryTime(retryTime),
+              maxAttempts(maxAttempts),
+              cooldownTime(cooldownTime) {}
+
+        float stallCurrent;
+        float stallTorque;
+        float stallSpeed;
+        uint32_t jamTime;
+        float filterTime;
+        int reversePower;
+        uint32_t reverseTime;
+        uint32_t pauseTime;
+        uint32_t retryTime;
+        int maxAttempts;
+        uint32_t cooldownTime;
+};
+
+/**
+ * @brief Detects a motor jamming, and clears the jam without blocking
+ *
+ * A motor is jammed when it has been straining, drawing a lot of current or putting out a lot of torque, while
+ * turning much slower than it was commanded to, for long enough. Readings are low pass filtered first, so a ring
+ * catching for a moment isn't a jam. The detector sits between whatever commands the motor and the motor, and once it
+ * detects a jam it reverses, pauses and retries, a step each update, so everything else running in the same loop
+ * keeps going. Retries that jam again start over, until it gives up. After a cooldown it runs again, so one
+ * stubborn jam doesn't stop the motor for the rest of an autonomous route.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // every 10 ms, in the task driving the conveyor
+ * conveyor.move(conveyorJam.update(power));
+ * @endcode
+ */
+class JamDetector {
+    public:
+        /**
+         * @brief Construct a new JamDetector
+         *
+         * @param motor motor to watch. The detector doesn't move it
+         * @param settings constants for the detector
+         */
+        JamDetector(pros::Motor* motor, JamDetectorSettings settings);
+
+        /**
+         * @brief Check the motor, and get the power it should run at
+         *
+         * @param power power the motor is commanded to run at, out of 127
+         * @return int power to run the motor at, out of 127. The commanded power unless clearing a jam
+         */
+        int update(int power);
+        /**
+         * @brief Stop clearing a jam, and forget the readings. Keeps the stats
+         */
+        void reset();
+        /**
+         * @brief Get what the detector is doing
+         *
+         * @return JamState
+         */
+        JamState getState() const { return state; }
+        /**
+         * @brief Get the filtered current draw of the motor, in mA
+         *
+         * @return float
+         */
+        float getCurrent() const { return current; }
+        /**
+         * @brief Get the filtered fraction of its commanded speed the motor is short of, from 0 to 1 or more
+         *
+         * @return float
+         */
+        float getVelocityError() const { return velocityError; }
+        /**
+         * @brief Get the counts of what the detector has done
+         *
+         * @return JamStats
+         */
+        const JamStats& getStats() const { return stats; }
+    private:
+        /**
+         * @brief Start reversing to clear a jam
+         *
+         * @param now the time, in milliseconds
+         */
+        void startReversing(uint32_t now);
+
+        pros::Motor* motor;
+        JamDetectorSettings settings;
+
+        JamState state = JamState::RUNNING;
+        JamStats stats;
+        int attempts = 0;
+        // when the state last changed, when the motor was last stalled from, and when the current jam was detected
+        uint32_t stateStart = 0;
+        uint32_t stallStart = 0;
+        uint32_t jamStart = 0;
+        // which way the motor is commanded, and since when
+        int commandDirection = 0;
+        uint32_t commandStart = 0;
+        int jamDirection = 1; // which way the motor was commanded when it jammed
+
+        uint32_t lastUpdate = 0;
+        float maxRpm = 0;
+        float current = 0;
+        float torque = 0;
+        float velocityError = 0;
+};
+} // namespace lemlib
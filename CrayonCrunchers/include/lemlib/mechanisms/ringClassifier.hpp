@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "pros/optical.hpp"
+
+namespace lemlib {
+/**
+ * @brief Color of a ring
+ */
+enum class RingColor {
+    /** no ring, or one that can't be told apart */
+    NONE,
+    RED,
+    BLUE
+};
+
+/**
+ * @brief Get the name of a ring color, for logging
+ *
+ * @param color the color
+ * @return const char*
+ */
+const char* toString(RingColor color);
+
+/**
+ * @brief Everything an optical sensor reads at once
+ */
+struct OpticalSample {
+        float red = 0;
+        float green = 0;
+        float blue = 0;
+        /** from 0 to 1 */
+        float brightness = 0;
+        /** in degrees */
+        float hue = 0;
+        /** from 0 to 1 */
+        float saturation = 0;
+        /** from 0 to 255, higher is closer */
+        int32_t proximity = 0;
+
+        /**
+         * @brief Read every value of an optical sensor, each once
+         *
+         * @param optical the sensor
+         * @return OpticalSample
+         */
+        static OpticalSample read(pros::Optical& optical);
+};
+
+/**
+ * @brief The color a ring classifier picked, and how sure it is
+ */
+struct RingClassification {
+        RingColor color = RingColor::NONE;
+        /** probability of the color, from 0 to 1 */
+        float confidence = 0;
+};
+
+/**
+ * @brief Tells ring colors apart from optical sensor readings, with a model learned on the field
+ *
+ * Each color, and no ring at all, is modelled as a normal distribution with its own mean and variance for each of a
+ * few features of a reading: the hue as a point on the color wheel scaled by saturation, the share of red and of blue
+ * in the rgb reading, brightness and proximity. Field lighting moves all of them, so the model is learned from
+ * readings taken under it: hold each color in front of the sensor while addSample collects readings, then fit.
+ * Classifying a reading takes a fixed, small number of operations, a few microseconds on the brain.
+ *
+ * Until it is fitted or loaded, the model roughly matches the hue windows color sorting used to use.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::RingClassifier classifier;
+ * // with a red ring held in front of the sensor
+ * for (int i = 0; i < 50; i++) {
+ *     classifier.addSample(lemlib::RingColor::RED, lemlib::OpticalSample::read(optical));
+ *     pros::delay(20);
+ * }
+ * // ... the same for blue, and for nothing in front of the sensor
+ * classifier.fit();
+ * const lemlib::RingClassification ring = classifier.classify(lemlib::OpticalSample::read(optical));
+ * @endcode
+ */
+class RingClassifier {
+    public:
+        /** number of features of a reading */
+        static constexpr int FEATURES = 6;
+        /** number of colors, including no ring */
+        static constexpr int CLASSES = 3;
+        /** fewest readings of each color fit needs */
+        static constexpr int MIN_SAMPLES = 20;
+
+        /**
+         * @brief Construct a new RingClassifier, with the default model
+         */
+        RingClassifier();
+
+        /**
+         * @brief Classify a reading
+         *
+         * @param sample the reading
+         * @return RingClassification the most likely color, and its probability
+         */
+        RingClassification classify(const OpticalSample& sample) const;
+        /**
+         * @brief Add a reading of a known color, to fit the model to
+         *
+         * @param color color in front of the sensor. NONE for no ring
+         * @param sample the reading
+         */
+        void addSample(RingColor color, const OpticalSample& sample);
+        /**
+         * @brief Get the number of readings of a color added since the last fit
+         *
+         * @param color the color
+         * @return int
+         */
+        int getSampleCount(RingColor color) const;
+        /**
+         * @brief Fit the model to the readings added, and forget them
+         *
+         * @return true the model was fitted
+         * @return false some color had fewer than MIN_SAMPLES readings, and the model was left as it was
+         */
+        bool fit();
+        /**
+         * @brief Forget the readings added since the last fit
+         */
+        void clearSamples();
+        /**
+         * @brief Save the model to a file, so it can be loaded after the program restarts
+         *
+         * @param path path of the file, on the microSD card on the brain
+         * @return true the model was saved
+         * @return false the file couldn't be written
+         */
+        bool save(const char* path) const;
+        /**
+         * @brief Load a model saved with save
+         *
+         * @param path path of the file
+         * @return true the model was loaded
+         * @return false the file couldn't be read, or isn't a model. The model is left as it was
+         */
+        bool load(const char* path);
+        /**
+         * @brief Get the features of a reading the model uses
+         *
+         * @param sample the reading
+         * @return std::array<float, FEATURES>
+         */
+        static std::array<float, FEATURES> getFeatures(const OpticalSample& sample);
+    private:
+        // a normal distribution with independent features, kept in the form classify needs
+        struct Gaussian {
+                std::array<float, FEATURES> mean {};
+                std::array<float, FEATURES> inverseVariance {};
+                // log of the normalizing constant, -sum(log(variance)) / 2
+                float logScale = 0;
+        };
+        // running mean and variance of the readings of a color, with Welford's method
+        struct Accumulator {
+                int count = 0;
+                std::array<double, FEATURES> mean {};
+                std::array<double, FEATURES> m2 {};
+        };
+
+        /**
+         * @brief Set a class of the model from the mean and variance of each feature
+         */
+        void setClass(RingColor color, const std::array<float, FEATURES>& mean,
+                      const std::array<float, FEATURES>& variance);
+
+        std::array<Gaussian, CLASSES> model;
+        std::array<Accumulator, CLASSES> samples;
+};
+} // namespace lemlib
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "pros/motors.hpp"
+#include "lemlib/seqlock.hpp"
+#include "lemlib/mechanisms/colorSort.hpp"
+
+namespace lemlib {
+/**
+ * @brief Counts of rings that went through a conveyor since the program started
+ */
+struct RingCounts {
+        /** rings on the conveyor now */
+        int held = 0;
+        /** rings that came in through the intake */
+        int intaken = 0;
+        /** rings that went over the top onto a goal */
+        int scored = 0;
+        /** scored rings the conveyor motor also strained to push over the top */
+        int confirmed = 0;
+        /** rings the color sorter threw off */
+        int ejected = 0;
+        /** rings that went back out of the intake */
+        int outtaken = 0;
+        /** rings scored since the goal was last let go of */
+        int onGoal = 0;
+};
+
+/**
+ * @brief class containing constants for a ring inventory
+ */
+class RingInventorySettings {
+    public:
+        /**
+         * @brief RingInventorySettings constructor
+         *
+         * Distances are along the conveyor from the optical sensor, in the conveyor motor's encoder units
+         *
+         * @param scoreDistance how far a ring travels from the optical sensor to when it has gone over the top
+         * @param outtakeDistance how far back down from the optical sensor a ring goes before it is out of the intake
+         * @param ringLength how far the conveyor travels while one ring passes the optical sensor
+         * @param spikeCurrent how far the conveyor's current draw jumps above usual when it pushes a ring over the top,
+         * in mA
+         * @param spikeWindow how far before scoreDistance the jump can start
+         * @param goalCapacity most rings a goal holds
+         *
+         * @b Example
+         * @code {.cpp}
+         * lemlib::RingInventorySettings ringInventorySettings(260, // score distance, in degrees
+         *                                                     200, // outtake distance, in degrees
+         *                                                     120, // ring length, in degrees
+         *                                                     600, // current spike, in mA
+         *                                                     90, // spike window, in degrees
+         *                                                     6); // rings a goal holds
+         * @endcode
+         */
+        RingInventorySettings(float scoreDistance, float outtakeDistance, float ringLength, float spikeCurrent,
+                              float spikeWindow, int goalCapacity)
+            : scoreDistance(scoreDistance),
+              outtakeDistance(outtakeDistance),
+              ringLength(ringLength),
+              spikeCurrent(spikeCurrent),
+              spikeWindow(spikeWindow),
+              goalCapacity(goalCapacity) {}
+
+        float scoreDistance;
+        float outtakeDistance;
+        float ringLength;
+        float spikeCurrent;
+        float spikeWindow;
+        int goalCapacity;
+};
+
+/**
+ * @brief Keeps track of the rings on a conveyor, so routes can wait for rings instead of for a fixed time
+ *
+ * A ring enters when the color sorter's optical sensor sees one, and is followed up the conveyor by the conveyor
+ * motor's encoder, the same way the color sorter follows the rings it throws off. It leaves when it has travelled far
+ * enough to go over the top, when the color sorter throws it off, or when the conveyor runs it back out of the intake.
+ * Pushing a ring over the top makes the conveyor motor strain, so a jump in its current draw near the top confirms a
+ * ring was scored.
+ *
+ * Everything can be read from any task. update runs in the task driving the conveyor, after the color sorter.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // in a route, after driving over a ring
+ * rings.waitUntilScored(rings.getCounts().scored + 1, 2500);
+ * if (rings.isGoalFull()) latch.set_value(false);
+ * @endcode
+ */
+class RingInventory {
+    public:
+        /** most rings that fit on the conveyor at once */
+        static constexpr size_t MAX_RINGS = 8;
+
+        /**
+         * @brief Construct a new RingInventory
+         *
+         * @param conveyor motor of the conveyor
+         * @param colorSort color sorter, whose readings and ejections the inventory uses
+         * @param settings constants for the inventory
+         */
+        RingInventory(pros::Motor* conveyor, const ColorSort* colorSort, RingInventorySettings settings);
+
+        /**
+         * @brief Follow the rings on the conveyor. Call it every time the color sorter is updated, after it
+         */
+        void update();
+        /**
+         * @brief Start counting rings on a new goal. Call it when the goal is let go of. Can be called from any task
+         */
+        void resetGoal() { goalReset.store(true, std::memory_order_relaxed); }
+        /**
+         * @brief Get the counts of rings
+         *
+         * @return RingCounts
+         */
+        RingCounts getCounts() const { return state.read().counts; }
+        /**
+         * @brief Whether the goal holds as many rings as it can
+         */
+        bool isGoalFull() const { return getCounts().onGoal >= settings.goalCapacity; }
+        /**
+         * @brief Whether there is a ring between two distances along the conveyor from the optical sensor
+         *
+         * @param from the lower distance
+         * @param to the higher distance
+         */
+        bool isRingBetween(float from, float to) const;
+        /**
+         * @brief Wait until a number of rings have been scored since the program started
+         *
+         * @param scored the number of rings
+         * @param timeout longest to wait, in milliseconds
+         * @return true the rings were scored
+         * @return false the timeout ran out first
+         */
+        bool waitUntilScored(int scored, uint32_t timeout) const;
+        /**
+         * @brief Wait until the conveyor holds at least a number of rings
+         *
+         * @param held the number of rings
+         * @param timeout longest to wait, in milliseconds
+         * @return true the conveyor holds the rings
+         * @return false the timeout ran out first
+         */
+        bool waitUntilHeld(int held, uint32_t timeout) const;
+        /**
+         * @brief Wait until a number of rings have come in through the intake since the program started
+         *
+         * @param intaken the number of rings
+         * @param timeout longest to wait, in milliseconds
+         * @return true the rings came in
+         * @return false the timeout ran out first
+         */
+        bool waitUntilIntaken(int intaken, uint32_t timeout) const;
+    private:
+        struct Ring {
+                float entry; // where the conveyor was when the ring passed the optical sensor
+                bool spiked; // whether the current jumped while the ring was being pushed over the top
+        };
+        // what other tasks can read
+        struct State {
+                RingCounts counts;
+                float position = 0;
+                std::array<float, MAX_RINGS> entries {};
+                size_t rings = 0;
+        };
+
+        /**
+         * @brief Stop following a ring
+         *
+         * @param index index of the ring
+         */
+        void remove(size_t index);
+
+        pros::Motor* conveyor;
+        const ColorSort* colorSort;
+        RingInventorySettings settings;
+
+        std::array<Ring, MAX_RINGS> rings {};
+        size_t count = 0;
+        RingCounts counts;
+        float lastPosition = 0;
+        float lastEntry = 0;
+        bool entered = false;
+        uint32_t lastReading = 0;
+        uint32_t ejected = 0;
+        float baseline = 0; // usual current draw, in mA
+        std::atomic<bool> goalReset = false;
+        SeqLock<State> state {State {}};
+};
+} // namespace lemlib
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+
+namespace lemlib {
+/**
+ * @brief Jerk limited velocity profile for moving a set distance, starting and ending at rest
+ *
+ * The profile has up to 7 phases: jerk up, constant acceleration, jerk down, cruise, then the same three mirrored to
+ * slow down. Phases that aren't needed have no length, so short moves never reach full speed and moves with no jerk
+ * limit become trapezoidal profiles.
+ */
+class MotionProfile {
+    public:
+        /**
+         * @brief Where the profile wants the robot to be at a point in time
+         */
+        struct State {
+                /** distance from the start */
+                float position = 0;
+                float velocity = 0;
+                float acceleration = 0;
+        };
+
+        /**
+         * @brief Create a new motion profile
+         *
+         * @param distance distance to move. Negative to move backwards
+         * @param maxVelocity maximum velocity, in distance per second
+         * @param maxAcceleration maximum acceleration, in distance per second squared
+         * @param maxJerk maximum jerk, in distance per second cubed. 0 for no limit, which makes a trapezoidal profile
+         *
+         * @b Example
+         * @code {.cpp}
+         * // move 48 inches at up to 60 inches per second
+         * lemlib::MotionProfile profile(48, 60, 120, 600);
+         * // where the robot should be half a second in
+         * lemlib::MotionProfile::State state = profile.sample(0.5);
+         * @endcode
+         */
+        MotionProfile(float distance, float maxVelocity, float maxAcceleration, float maxJerk = 0);
+        /**
+         * @brief Get the state of the profile at a point in time
+         *
+         * @param time time since the profile started, in seconds. Times past the end give the end of the profile
+         * @return State
+         */
+        State sample(float time) const;
+        /**
+         * @brief Get how long the profile takes
+         *
+         * @return float duration in seconds
+         */
+        float getDuration() const { return duration; }
+    private:
+        float direction = 1;
+        float duration = 0;
+        std::array<float, 7> phaseTime {};
+        std::array<float, 7> phaseJerk {};
+        // state at the start of each phase, plus the end of the profile
+        std::array<State, 8> phaseStart {};
+};
+} // namespace lemlib
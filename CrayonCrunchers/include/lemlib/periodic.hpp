@@ -0,0 +1,204 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include "pros/rtos.hpp"
+#include "lemlib/seqlock.hpp"
+
+namespace lemlib {
+/**
+ * @brief Timing of a periodic loop
+ *
+ * Histograms have a bucket per power of 2 microseconds. Bucket 0 counts times of 0, and bucket i counts times of at
+ * least 2^(i-1) and less than 2^i microseconds. The last bucket also counts everything longer.
+ */
+struct PeriodicStats {
+        static constexpr int BUCKETS = 20;
+
+        /** number of cycles run */
+        uint32_t runs = 0;
+        /** number of cycles skipped because the one before ran past their start */
+        uint32_t missed = 0;
+        /** longest the loop woke up after it was due, in microseconds */
+        uint32_t maxJitter = 0;
+        /** longest a cycle took to run, in microseconds */
+        uint32_t maxExecution = 0;
+        /** total time spent running cycles, in microseconds. Wraps around after about 71 minutes */
+        uint32_t busy = 0;
+        /** how late the loop woke up */
+        std::array<uint32_t, BUCKETS> jitter {};
+        /** how long each cycle took to run */
+        std::array<uint32_t, BUCKETS> execution {};
+};
+
+/**
+ * @brief Runs a loop at a fixed period, and measures how well it keeps to it
+ *
+ * Each cycle starts a whole number of periods after the first, with pros::Task::delay_until, so the period doesn't
+ * drift by however long the cycle took. A cycle that runs past the start of the next one makes the loop skip the
+ * cycles it missed, rather than run them back to back to catch up, and they are counted.
+ *
+ * Every loop is listed, so the timing of every loop can be looked up while the program runs. Loops in tasks that can
+ * be deleted, like opcontrol, should be static, so they aren't left listed after their task is gone.
+ *
+ * @b Example
+ * @code {.cpp}
+ * static lemlib::PeriodicLoop loop("opcontrol", 10);
+ * loop.restart();
+ * while (true) {
+ *     // ...
+ *     loop.wait();
+ * }
+ * @endcode
+ */
+class PeriodicLoop {
+    public:
+        /** most loops that can be listed at once */
+        static constexpr size_t MAX_LOOPS = 24;
+        /** bytes at the bottom of a watched stack that aren't watched, to leave room for the frames above the task */
+        static constexpr size_t STACK_GUARD = 1024;
+
+        /**
+         * @brief Construct a new PeriodicLoop. The first cycle starts now
+         *
+         * Reads the clock and takes a mutex, so construct it once PROS has started, not globally.
+         *
+         * @param name name of the loop, for looking it up. Has to outlive the loop
+         * @param period period, in milliseconds
+         */
+        PeriodicLoop(const char* name, uint32_t period);
+        ~PeriodicLoop();
+        PeriodicLoop(const PeriodicLoop&) = delete;
+        PeriodicLoop& operator=(const PeriodicLoop&) = delete;
+
+        /**
+         * @brief Start the next cycle now, without counting the time since the last one. Keeps the stats
+         *
+         * Call it when a loop that was stopped starts again.
+         */
+        void restart();
+        /**
+         * @brief End the cycle, and wait until the next one is due
+         */
+        void wait();
+        /**
+         * @brief Get the timing of the loop. Can be called from any task
+         *
+         * @return PeriodicStats
+         */
+        PeriodicStats getStats() const { return stats.read(); }
+        /**
+         * @brief Get the name of the loop
+         */
+        const char* getName() const { return name; }
+        /**
+         * @brief Get the period of the loop, in milliseconds
+         */
+        uint32_t getPeriod() const { return period; }
+        /**
+         * @brief Change the period of the loop. Takes effect from the next cycle
+         *
+         * @param period period, in milliseconds
+         */
+        void setPeriod(uint32_t period) { this->period = period; }
+        /**
+         * @brief Start watching how much of the stack of the current task is used. Call it from the loop's task
+         *
+         * Fills the unused part of the stack with a pattern, so getStackFree can tell how far down the stack has ever
+         * reached. The top of the stack isn't known exactly, so the bottom STACK_GUARD bytes aren't watched.
+         *
+         * @param depth stack size of the task, in words, as it was given to pros::Task
+         */
+        void watchStack(uint16_t depth);
+        /**
+         * @brief Get how much of the stack has never been used. Can be called from any task
+         *
+         * Reads the whole unused part of the stack, so call it once in a while, not every cycle.
+         *
+         * @return int32_t bytes never used, at least. -1 if the stack isn't watched
+         */
+        int32_t getStackFree() const;
+        /**
+         * @brief Get every loop there is
+         *
+         * @return std::array<const PeriodicLoop*, MAX_LOOPS> the loops, followed by nullptr
+         */
+        static std::array<const PeriodicLoop*, MAX_LOOPS> getLoops();
+        /**
+         * @brief Find a loop by name
+         *
+         * @param name
+         * @return const PeriodicLoop* nullptr if there is no loop with that name
+         */
+        static const PeriodicLoop* find(const char* name);
+    private:
+        const char* const name;
+        uint32_t period;
+
+        // start of the cycle, in milliseconds, for delay_until
+        uint32_t time;
+        // when the cycle started running, in microseconds
+        uint64_t cycleStart;
+        // only changed by the loop's task, and published to the others
+        PeriodicStats current;
+        SeqLock<PeriodicStats> stats {PeriodicStats {}};
+        // the watched part of the stack, from its bottom up
+        std::atomic<const uint32_t*> stackBottom = nullptr;
+        size_t stackWords = 0;
+};
+
+/**
+ * @brief A task that runs a function at a fixed period
+ *
+ * Its stack is watched, see PeriodicLoop::watchStack.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // construct it in initialize, not globally, so its task starts after PROS has
+ * static lemlib::PeriodicTask conveyorTask("conveyor", 10, conveyorChecking);
+ * const lemlib::PeriodicStats stats = conveyorTask.getStats();
+ * @endcode
+ */
+class PeriodicTask {
+    public:
+        /**
+         * @brief Construct a new PeriodicTask, and start it
+         *
+         * @param name name of the task and its loop. Has to outlive the task
+         * @param period period, in milliseconds
+         * @param body function to run each period. Should return well within the period
+         * @param priority priority of the task
+         * @param stack stack size of the task, in words
+         */
+        PeriodicTask(const char* name, uint32_t period, std::function<void()> body,
+                     uint32_t priority = TASK_PRIORITY_DEFAULT, uint16_t stack = TASK_STACK_DEPTH_DEFAULT);
+        /**
+         * @brief Stop the task
+         */
+        ~PeriodicTask();
+        PeriodicTask(const PeriodicTask&) = delete;
+        PeriodicTask& operator=(const PeriodicTask&) = delete;
+        /**
+         * @brief Get the timing of the task. Can be called from any task
+         *
+         * @return PeriodicStats
+         */
+        PeriodicStats getStats() const { return loop.getStats(); }
+        /**
+         * @brief Get the loop the task runs
+         */
+        const PeriodicLoop& getLoop() const { return loop; }
+        /**
+         * @brief Change the period of the task. Takes effect from the next cycle
+         *
+         * @param period period, in milliseconds
+         */
+        void setPeriod(uint32_t period) { loop.setPeriod(period); }
+    private:
+        PeriodicLoop loop;
+        std::function<void()> body;
+        pros::Task task;
+};
+} // namespace lemlib
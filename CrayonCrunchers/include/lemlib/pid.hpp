@@ -3,6 +3,15 @@
 namespace lemlib {
 class PID {
     public:
+        /**
+         * @brief What each term added to the output of an update
+         */
+        struct Terms {
+                float proportional = 0;
+                float integral = 0;
+                float derivative = 0;
+        };
+
         /**
          * @brief Construct a new PID
          *
@@ -60,6 +69,21 @@ class PID {
          * @endcode
          */
         void reset();
+
+        /**
+         * @brief Get the terms of the last update, for telemetry and tuning
+         *
+         * @return Terms
+         *
+         * @b Example
+         * @code {.cpp}
+         * PID pid(5, 0, 20);
+         * pid.update(10);
+         * // 50, since only kP is set and the error is 10
+         * float p = pid.getTerms().proportional;
+         * @endcode
+         */
+        Terms getTerms() const { return terms; }
     protected:
         // gains
         const float kP;
@@ -72,5 +96,6 @@ class PID {
 
         float integral = 0;
         float prevError = 0;
+        Terms terms;
 };
 } // namespace lemlib
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <string>
+#define FMT_HEADER_ONLY
+#include "fmt/core.h"
 
 namespace lemlib {
 /**
@@ -207,12 +208,13 @@ class Pose {
          */
         Pose rotate(float angle) const;
 };
+} // namespace lemlib
 
 /**
  * @brief Format a pose
  *
- * @param pose
- * @return std::string
+ * Formats straight into the output, so logging a pose doesn't allocate. Float format specs apply to every field
  */
-std::string format_as(const Pose& pose);
-} // namespace lemlib
+template <> struct fmt::formatter<lemlib::Pose> : fmt::formatter<float> {
+        fmt::format_context::iterator format(const lemlib::Pose& pose, fmt::format_context& ctx) const;
+};
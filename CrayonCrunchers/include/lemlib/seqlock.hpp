@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include "pros/rtos.hpp"
+
+namespace lemlib {
+/**
+ * @brief Sequence lock for publishing small values from one task to many
+ *
+ * Writers never wait. A write bumps the sequence number to odd, copies the value in, and bumps it back to even.
+ * Readers copy the value out and retry only if a write overlapped the copy, so a read can never see half of one
+ * write and half of another. A reader that keeps failing sleeps between retries, so a lower priority writer it
+ * preempted in the middle of a write gets to finish.
+ *
+ * @tparam T trivially copyable type to publish
+ */
+template <typename T> class SeqLock {
+        static_assert(std::is_trivially_copyable_v<T>, "SeqLock can only hold trivially copyable types");
+    public:
+        /**
+         * @brief Construct a new SeqLock
+         *
+         * @param value initial value
+         */
+        SeqLock(const T& value) { store(value); }
+
+        /**
+         * @brief Try to publish a new value
+         *
+         * Fails immediately instead of waiting if another task is in the middle of a write
+         *
+         * @param value the value to publish
+         * @return true the value was published
+         * @return false another write was in progress, nothing was published
+         */
+        bool tryWrite(const T& value) {
+            uint32_t expected = sequence.load(std::memory_order_relaxed);
+            if (expected & 1) return false;
+            if (!sequence.compare_exchange_strong(expected, expected + 1, std::memory_order_acquire)) return false;
+            std::atomic_thread_fence(std::memory_order_release);
+            store(value);
+            sequence.store(expected + 2, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Read a consistent copy of the last published value
+         *
+         * @return T the value
+         */
+        T read() const {
+            std::array<uint32_t, WORDS> copy;
+            for (int tries = 1;; tries++) {
+                const uint32_t before = sequence.load(std::memory_order_acquire);
+                for (size_t i = 0; i < WORDS; i++) copy[i] = words[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint32_t after = sequence.load(std::memory_order_relaxed);
+                if (!(before & 1) && before == after) break;
+                // a write takes microseconds, so a few retries are enough unless the writer was preempted by this
+                // task. It can't run again while this task spins, and pros::delay(0) only yields to tasks of the same
+                // priority, so sleep a tick
+                if (tries >= MAX_SPINS) pros::delay(1);
+            }
+            // T may not be default constructible, so build it straight from the bytes
+            alignas(T) unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, copy.data(), sizeof(T));
+            return *std::launder(reinterpret_cast<T*>(bytes));
+        }
+
+        /**
+         * @brief Get the number of writes so far
+         *
+         * @return uint32_t number of writes
+         */
+        uint32_t getWrites() const { return sequence.load(std::memory_order_relaxed) / 2; }
+    private:
+        static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+        // retries a read spins for before it sleeps between them
+        static constexpr int MAX_SPINS = 8;
+
+        void store(const T& value) {
+            std::array<uint32_t, WORDS> copy {};
+            std::memcpy(copy.data(), &value, sizeof(T));
+            for (size_t i = 0; i < WORDS; i++) words[i].store(copy[i], std::memory_order_relaxed);
+        }
+
+        // the value is stored as atomic words so a read racing a write is well defined, just discarded
+        std::array<std::atomic<uint32_t>, WORDS> words;
+        std::atomic<uint32_t> sequence = 0;
+};
+} // namespace lemlib
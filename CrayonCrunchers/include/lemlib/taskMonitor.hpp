@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "lemlib/periodic.hpp"
+
+namespace lemlib {
+/**
+ * @brief How busy a task was and how much of its stack it used, over the time between two samples
+ */
+struct TaskUsage {
+        /** name of the task's loop */
+        const char* name = nullptr;
+        /** share of the time the task's cycles were running, from 0 to 1. Includes time other tasks preempted it */
+        float busy = 0;
+        /** bytes of stack the task has never used, at least. -1 if its stack isn't watched */
+        int32_t stackFree = -1;
+        /** cycles the task missed */
+        uint32_t missed = 0;
+};
+
+/**
+ * @brief Measures how busy the tasks of the program are and how much of their stacks they use
+ *
+ * PROS can't list tasks or tell how long they ran, so every task is measured through its PeriodicLoop: the time its
+ * cycles took, and its watched stack. A cycle's time is measured from when the task woke up to when it waited again,
+ * so it also counts time higher priority tasks took in between. Busy time is an upper bound on the task's CPU use,
+ * and the busy times of tasks that preempt each other overlap, so they don't add up to the CPU use of the program.
+ *
+ * @b Example
+ * @code {.cpp}
+ * static lemlib::TaskMonitor monitor;
+ * static lemlib::PeriodicTask monitorTask("monitor", 1000, [] {
+ *     monitor.sample();
+ *     for (int i = 0; i < monitor.getCount(); i++) {
+ *         const lemlib::TaskUsage& usage = monitor.getUsage()[i];
+ *         printf("%s %.1f%% busy, %d bytes free\n", usage.name, usage.busy * 100, usage.stackFree);
+ *     }
+ * }, TASK_PRIORITY_MIN + 1);
+ * @endcode
+ */
+class TaskMonitor {
+    public:
+        /**
+         * @brief Measure every task since the last sample
+         *
+         * Reads the stack of every watched task, so call it once a second or so, from a low priority task.
+         */
+        void sample();
+        /**
+         * @brief Get the usage of every task at the last sample. The first getCount() are valid
+         *
+         * @return const std::array<TaskUsage, PeriodicLoop::MAX_LOOPS>&
+         */
+        const std::array<TaskUsage, PeriodicLoop::MAX_LOOPS>& getUsage() const { return usage; }
+        /**
+         * @brief Get the number of tasks at the last sample
+         */
+        int getCount() const { return count; }
+    private:
+        std::array<TaskUsage, PeriodicLoop::MAX_LOOPS> usage {};
+        int count = 0;
+
+        // the loops at the last sample, and how busy they were then
+        std::array<const PeriodicLoop*, PeriodicLoop::MAX_LOOPS> loops {};
+        std::array<PeriodicStats, PeriodicLoop::MAX_LOOPS> previous {};
+        uint64_t previousTime = 0;
+};
+} // namespace lemlib
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/pose.hpp"
+
+// Benchmark for the BaseSink logging path.
+//
+// Logs the messages the robot sends at its highest rates through a sink that only counts what it gets, and reports
+// nanoseconds and heap allocations per message. The path BaseSink::log took before it formatted into the sink's own
+// buffer is copied here as the baseline: fmt::format into a string, dynamic named arguments, fmt::vformat into a second
+// string and a shared_ptr copy to reach the sink. The shared stdout buffer the real sinks push into is not included.
+//
+// The sim compiles every level in. Build with LOG_LEVEL=2 to measure what debug and info cost when they are compiled
+// out, like on the brain.
+
+namespace {
+uint64_t allocations = 0;
+
+using Clock = std::chrono::steady_clock;
+
+// counts what it is sent, so the compiler can't drop the formatting
+class CountingSink : public lemlib::BaseSink {
+    public:
+        CountingSink() { setFormat("[LemLib] {level}: {message}"); }
+
+        uint64_t characters = 0;
+    private:
+        void sendMessage(const lemlib::Message& message) override { characters += message.message.size(); }
+};
+
+// BaseSink::log before it formatted into the sink's buffer
+class LegacySink {
+    public:
+        template <typename... T> void log(lemlib::Level level, fmt::format_string<T...> format, T&&... args) {
+            if (level < lowestLevel) return;
+            std::string messageString = fmt::format(format, std::forward<T>(args)...);
+            const uint32_t time = pros::millis();
+            fmt::dynamic_format_arg_store<fmt::format_context> formattingArgs;
+            formattingArgs.push_back(fmt::arg("time", time));
+            formattingArgs.push_back(fmt::arg("level", level));
+            formattingArgs.push_back(fmt::arg("message", messageString));
+            std::string formattedString = fmt::vformat(logFormat, std::move(formattingArgs));
+            characters += formattedString.size();
+        }
+
+        lemlib::Level lowestLevel = lemlib::Level::INFO;
+        std::string logFormat = "[LemLib] {level}: {message}";
+        uint64_t characters = 0;
+};
+
+// how Pose was formatted before it had a fmt::formatter
+std::string legacyPose(const lemlib::Pose& pose) {
+    return fmt::format("lemlib::Pose {{ x: {}, y: {}, theta: {} }}", pose.x, pose.y, pose.theta);
+}
+
+// the sink getters returned a copy of the shared_ptr
+std::shared_ptr<LegacySink> legacySink() {
+    static std::shared_ptr<LegacySink> sink = std::make_shared<LegacySink>();
+    return sink;
+}
+
+const std::shared_ptr<CountingSink>& countingSink() {
+    static std::shared_ptr<CountingSink> sink = std::make_shared<CountingSink>();
+    return sink;
+}
+
+// left at the default level, like the robot's sinks, so debug messages are filtered out
+const std::shared_ptr<CountingSink>& quietSink() {
+    static std::shared_ptr<CountingSink> sink = std::make_shared<CountingSink>();
+    return sink;
+}
+
+struct Result {
+        double ns;
+        double allocations;
+};
+
+template <typename Log> Result measure(int messages, Log log) {
+    // warm up, so one time setup isn't counted
+    for (int i = 0; i < 1000; i++) log(i);
+    const uint64_t startAllocations = allocations;
+    const auto start = Clock::now();
+    for (int i = 0; i < messages; i++) log(i);
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return {ns / messages, double(allocations - startAllocations) / messages};
+}
+
+void print(const char* name, const Result& legacy, const Result& current) {
+    std::printf("%-24s %9.1f ns %6.2f allocs | %9.1f ns %6.2f allocs | %5.1fx\n", name, legacy.ns,
+                legacy.allocations, current.ns, current.allocations, legacy.ns / current.ns);
+}
+} // namespace
+
+// every allocation is counted. Each form of new is replaced together with its matching delete, so nothing the
+// library allocates is freed by a different allocator
+namespace {
+void* allocate(size_t size, size_t alignment) {
+    allocations++;
+    // aligned_alloc wants the size to be a multiple of the alignment
+    size = (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment;
+    return alignment <= alignof(std::max_align_t) ? std::malloc(size) : std::aligned_alloc(alignment, size);
+}
+
+void* allocateOrThrow(size_t size, size_t alignment) {
+    if (void* p = allocate(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(size_t size) { return allocateOrThrow(size, alignof(std::max_align_t)); }
+
+void* operator new[](size_t size) { return allocateOrThrow(size, alignof(std::max_align_t)); }
+
+void* operator new(size_t size, std::align_val_t alignment) { return allocateOrThrow(size, size_t(alignment)); }
+
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateOrThrow(size, size_t(alignment)); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size, alignof(std::max_align_t)); }
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size, alignof(std::max_align_t)); }
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, size_t(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, size_t(alignment));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete[](void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+int main(int argc, char** argv) {
+    const int messages = argc > 1 ? std::atoi(argv[1]) : 200000;
+    countingSink()->setLowestLevel(lemlib::Level::INFO);
+    const lemlib::Pose pose(12.345f, -67.89f, 123.4f);
+
+    std::printf("%-24s %-29s | %-29s |\n", "message", "before", "now");
+    print("pose telemetry",
+          measure(messages, [&](int) { legacySink()->log(lemlib::Level::INFO, "Chassis pose: {}", legacyPose(pose)); }),
+          measure(messages, [&](int) { countingSink()->info("Chassis pose: {}", pose); }));
+    print("odom fault",
+          measure(messages,
+                  [&](int i) {
+                      legacySink()->log(lemlib::Level::WARN, "odom fault,{},{},{},{}", i, "vertical1", "stuck",
+                                        "imu");
+                  }),
+          measure(messages, [&](int i) {
+              countingSink()->warn("odom fault,{},{},{},{}", i, "vertical1", "stuck", "imu");
+          }));
+    print("motor power",
+          measure(messages,
+                  [&](int i) { legacySink()->log(lemlib::Level::INFO, "Turn Motor Power: {} ", i * 0.1f); }),
+          measure(messages, [&](int i) { countingSink()->info("Turn Motor Power: {} ", i * 0.1f); }));
+    print("integer",
+          measure(messages, [&](int i) { legacySink()->log(lemlib::Level::DEBUG, "{}", i); }),
+          measure(messages, [&](int i) { countingSink()->debug("{}", i); }));
+    LegacySink quietLegacy;
+    quietLegacy.lowestLevel = lemlib::Level::WARN;
+    print("filtered debug",
+          measure(messages, [&](int i) { quietLegacy.log(lemlib::Level::DEBUG, "wait,{},{}", i, i * 2); }),
+          measure(messages, [&](int i) { quietSink()->debug("wait,{},{}", i, i * 2); }));
+    // both paths have to produce the same text, unless levels were compiled out of this one
+    if (lemlib::COMPILED_LEVEL != lemlib::Level::INFO) {
+        std::printf("levels under %s compiled out, output not compared\n",
+                    std::string(format_as(lemlib::COMPILED_LEVEL)).c_str());
+        std::fflush(stdout);
+        std::_Exit(0);
+    }
+    const bool same = legacySink()->characters == countingSink()->characters && quietSink()->characters == 0;
+    std::printf("%s\n", same ? "output matches" : "output differs");
+    std::fflush(stdout);
+    std::_Exit(same ? 0 : 1);
+}
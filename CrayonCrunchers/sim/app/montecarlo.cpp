@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sim/runner.hpp"
+#include "sim/workStealingPool.hpp"
+
+namespace {
+struct Options {
+        std::vector<int> routes {1, 2, 3, 4, 5, 6, 7, 8};
+        int trials = 500; // per route
+        unsigned jobs = 0;
+        uint64_t seed = 1;
+        double time = 15;
+        double tolerance = 3; // max distance from the nominal final position to count as a success, in inches
+        double headingTolerance = 10; // max heading error to count as a success, in degrees
+        double startSigma = 0.5; // in inches
+        double headingSigma = 1; // in degrees
+        double wheelSigma = 0.01; // fraction of the nominal tracking wheel diameter
+        double driftSigma = 0.02; // in degrees per second
+        double strengthMin = 0.9; // weakest a side of the drivetrain can be, as a fraction of full strength
+        int unplugPort = 0; // sensor unplugged in every trial, 0 for none
+        int jamPort = 0; // tracking wheel jammed in every trial, 0 for none
+        double wallTime = 0; // how long the robot is held against a wall in every trial, in seconds
+        double faultTime = 5; // in seconds after autonomous starts
+        const char* csv = nullptr;
+};
+
+struct Trial {
+        sim::TrialConfig config;
+        sim::TrialResult result;
+};
+
+void usage(const char* name) {
+    std::printf("usage: %s [options]\n"
+                "  --routes LIST          routes to run, e.g. 1-8 or 1,3,5 (default 1-8)\n"
+                "  --trials N             trials per route (default 500)\n"
+                "  --jobs N               worker threads (default one per core)\n"
+                "  --seed N               random seed (default 1)\n"
+                "  --time SECONDS         length of autonomous (default 15)\n"
+                "  --tolerance IN         position error counted as a success (default 3)\n"
+                "  --heading-tolerance DEG heading error counted as a success (default 10)\n"
+                "  --start-sigma IN       start position error std dev (default 0.5)\n"
+                "  --heading-sigma DEG    start heading error std dev (default 1)\n"
+                "  --wheel-sigma FRAC     tracking wheel diameter error std dev (default 0.01)\n"
+                "  --drift-sigma DEG/S    imu drift std dev (default 0.02)\n"
+                "  --strength-min FRAC    weakest drivetrain side (default 0.9)\n"
+                "  --unplug PORT          unplug the sensor on this port in every trial (default none)\n"
+                "  --jam PORT             jam the tracking wheel on this port in every trial (default none)\n"
+                "  --wall SECONDS         hold the robot against a wall this long in every trial (default 0)\n"
+                "  --fault-time SECONDS   when the sensor fails or the wall is hit (default 5)\n"
+                "  --csv FILE             write every trial to a csv file\n",
+                name);
+}
+
+bool parseRoutes(const char* text, std::vector<int>& routes) {
+    routes.clear();
+    std::string list(text);
+    size_t start = 0;
+    while (start < list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+        const std::string item = list.substr(start, end - start);
+        const size_t dash = item.find('-');
+        const int first = std::atoi(item.substr(0, dash).c_str());
+        const int last = dash == std::string::npos ? first : std::atoi(item.substr(dash + 1).c_str());
+        if (first <= 0 || last < first) return false;
+        for (int route = first; route <= last; route++) routes.push_back(route);
+        start = end + 1;
+    }
+    return !routes.empty();
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) return false;
+        const char* flag = argv[i];
+        const char* value = argv[++i];
+        if (!std::strcmp(flag, "--routes")) {
+            if (!parseRoutes(value, options.routes)) return false;
+        } else if (!std::strcmp(flag, "--trials")) options.trials = std::atoi(value);
+        else if (!std::strcmp(flag, "--jobs")) options.jobs = std::atoi(value);
+        else if (!std::strcmp(flag, "--seed")) options.seed = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(flag, "--time")) options.time = std::atof(value);
+        else if (!std::strcmp(flag, "--tolerance")) options.tolerance = std::atof(value);
+        else if (!std::strcmp(flag, "--heading-tolerance")) options.headingTolerance = std::atof(value);
+        else if (!std::strcmp(flag, "--start-sigma")) options.startSigma = std::atof(value);
+        else if (!std::strcmp(flag, "--heading-sigma")) options.headingSigma = std::atof(value);
+        else if (!std::strcmp(flag, "--wheel-sigma")) options.wheelSigma = std::atof(value);
+        else if (!std::strcmp(flag, "--drift-sigma")) options.driftSigma = std::atof(value);
+        else if (!std::strcmp(flag, "--strength-min")) options.strengthMin = std::atof(value);
+        else if (!std::strcmp(flag, "--unplug")) options.unplugPort = std::atoi(value);
+        else if (!std::strcmp(flag, "--jam")) options.jamPort = std::atoi(value);
+        else if (!std::strcmp(flag, "--wall")) options.wallTime = std::atof(value);
+        else if (!std::strcmp(flag, "--fault-time")) options.faultTime = std::atof(value);
+        else if (!std::strcmp(flag, "--csv")) options.csv = value;
+        else return false;
+    }
+    return options.trials > 0;
+}
+
+/**
+ * @brief Run a trial in a child process
+ *
+ * The robot code lives in globals, so each trial needs a fresh copy of the process. The parent never runs a trial
+ * itself, so every child starts from the same untouched state.
+ */
+sim::TrialResult forkTrial(const sim::TrialConfig& config) {
+    sim::TrialResult result;
+    int fds[2];
+    if (pipe(fds) != 0) return result;
+    const pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return result;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        // keep the robot's own logging out of the report
+        const int devNull = open("/dev/null", O_WRONLY);
+        dup2(devNull, STDOUT_FILENO);
+        const sim::TrialResult childResult = sim::runTrial(config);
+        [[maybe_unused]] const ssize_t written = write(fds[1], &childResult, sizeof(childResult));
+        _exit(0);
+    }
+    close(fds[1]);
+    // a child that crashed writes nothing and counts as a failed run
+    size_t received = 0;
+    while (received < sizeof(result)) {
+        const ssize_t n = read(fds[0], reinterpret_cast<char*>(&result) + received, sizeof(result) - received);
+        if (n <= 0) break;
+        received += n;
+    }
+    if (received != sizeof(result)) result = sim::TrialResult();
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return result;
+}
+
+/**
+ * @brief Draw a random perturbation. Each trial has its own generator so results don't depend on scheduling
+ */
+sim::Perturbation samplePerturbation(const Options& options, int route, int trial) {
+    std::seed_seq seeds {uint32_t(options.seed), uint32_t(options.seed >> 32), uint32_t(route), uint32_t(trial)};
+    std::mt19937_64 rng(seeds);
+    std::normal_distribution<double> start(0, options.startSigma);
+    std::normal_distribution<double> heading(0, options.headingSigma);
+    std::normal_distribution<double> wheel(0, options.wheelSigma);
+    std::normal_distribution<double> drift(0, options.driftSigma);
+    std::uniform_real_distribution<double> strength(options.strengthMin, 1);
+    sim::Perturbation perturbation;
+    perturbation.x = start(rng);
+    perturbation.y = start(rng);
+    perturbation.theta = heading(rng);
+    perturbation.horizontalScale = 1 + wheel(rng);
+    perturbation.vertical1Scale = 1 + wheel(rng);
+    perturbation.vertical2Scale = 1 + wheel(rng);
+    perturbation.imuDrift = drift(rng);
+    perturbation.leftStrength = strength(rng);
+    perturbation.rightStrength = strength(rng);
+    perturbation.unplugPort = options.unplugPort;
+    perturbation.jamPort = options.jamPort;
+    perturbation.wallTime = options.wallTime;
+    perturbation.faultTime = options.faultTime;
+    return perturbation;
+}
+
+double headingError(double a, double b) { return std::fabs(std::remainder(a - b, 360)); }
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return NAN;
+    std::sort(values.begin(), values.end());
+    const size_t index = std::min(values.size() - 1, size_t(p * (values.size() - 1) + 0.5));
+    return values.at(index);
+}
+
+double mean(const std::vector<double>& values) {
+    double sum = 0;
+    for (double value : values) sum += value;
+    return values.empty() ? NAN : sum / values.size();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    sim::WorkStealingPool pool(options.jobs);
+
+    // nominal runs set the target each perturbed run is judged against
+    std::vector<Trial> nominal(options.routes.size());
+    std::vector<std::vector<Trial>> trials(options.routes.size(), std::vector<Trial>(options.trials));
+    for (size_t r = 0; r < options.routes.size(); r++) {
+        nominal.at(r).config.route = options.routes.at(r);
+        nominal.at(r).config.time = options.time;
+        for (int t = 0; t < options.trials; t++) {
+            Trial& trial = trials.at(r).at(t);
+            trial.config.route = options.routes.at(r);
+            trial.config.time = options.time;
+            trial.config.perturbation = samplePerturbation(options, options.routes.at(r), t);
+        }
+    }
+    for (Trial& trial : nominal) pool.submit([&trial]() { trial.result = forkTrial(trial.config); });
+    for (std::vector<Trial>& route : trials) {
+        for (Trial& trial : route) pool.submit([&trial]() { trial.result = forkTrial(trial.config); });
+    }
+    pool.run();
+    const double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    FILE* csv = options.csv == nullptr ? nullptr : std::fopen(options.csv, "w");
+    if (csv != nullptr) {
+        std::fprintf(csv, "route,trial,completed,dx,dy,dtheta,horizontalScale,vertical1Scale,vertical2Scale,imuDrift,"
+                          "leftStrength,rightStrength,x,y,theta,odomX,odomY,odomTheta,positionError,headingError\n");
+    }
+
+    std::printf("%-6s %7s %8s | %-36s | %-20s | %s\n", "route", "trials", "success", "position error (in)",
+                "heading error (deg)", "odom error (in)");
+    std::printf("%-6s %7s %8s | %6s %6s %6s %6s %7s | %6s %6s %6s | %6s %6s\n", "", "", "", "mean", "p50", "p90",
+                "p99", "max", "p50", "p90", "max", "p50", "p90");
+    for (size_t r = 0; r < options.routes.size(); r++) {
+        const sim::TrialResult& target = nominal.at(r).result;
+        if (!target.completed) {
+            std::printf("%-6d nominal run failed\n", options.routes.at(r));
+            continue;
+        }
+        std::vector<double> positionErrors;
+        std::vector<double> headingErrors;
+        std::vector<double> odomErrors;
+        int successes = 0;
+        for (int t = 0; t < options.trials; t++) {
+            const Trial& trial = trials.at(r).at(t);
+            const sim::TrialResult& result = trial.result;
+            // a run that never finished is as far off as it gets
+            const double positionError =
+                result.completed ? std::hypot(result.x - target.x, result.y - target.y) : INFINITY;
+            const double heading = result.completed ? headingError(result.theta, target.theta) : 180;
+            positionErrors.push_back(positionError);
+            headingErrors.push_back(heading);
+            if (result.completed) odomErrors.push_back(std::hypot(result.x - result.odomX, result.y - result.odomY));
+            if (positionError <= options.tolerance && heading <= options.headingTolerance) successes++;
+            if (csv != nullptr) {
+                const sim::Perturbation& p = trial.config.perturbation;
+                std::fprintf(csv, "%d,%d,%d,%.4f,%.4f,%.4f,%.5f,%.5f,%.5f,%.5f,%.4f,%.4f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,"
+                                  "%.3f,%.3f\n",
+                             options.routes.at(r), t, result.completed, p.x, p.y, p.theta, p.horizontalScale,
+                             p.vertical1Scale, p.vertical2Scale, p.imuDrift, p.leftStrength, p.rightStrength, result.x,
+                             result.y, result.theta, result.odomX, result.odomY, result.odomTheta, positionError,
+                             heading);
+            }
+        }
+        std::printf("%-6d %7d %7.1f%% | %6.2f %6.2f %6.2f %6.2f %7.2f | %6.2f %6.2f %6.2f | %6.2f %6.2f\n",
+                    options.routes.at(r), options.trials, 100.0 * successes / options.trials, mean(positionErrors),
+                    percentile(positionErrors, 0.5), percentile(positionErrors, 0.9),
+                    percentile(positionErrors, 0.99), percentile(positionErrors, 1), percentile(headingErrors, 0.5),
+                    percentile(headingErrors, 0.9), percentile(headingErrors, 1), percentile(odomErrors, 0.5),
+                    percentile(odomErrors, 0.9));
+    }
+    if (csv != nullptr) std::fclose(csv);
+
+    const size_t runs = options.routes.size() * (options.trials + 1);
+    std::printf("\n%zu runs on %u workers in %.2f s (%.0f runs/s)\n", runs, pool.getWorkers(), wallTime,
+                runs / wallTime);
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include "lemlib/chassis/calibration.hpp"
+
+// Host runner for the odometry calibration solver.
+//
+// With a file argument, reads the "calibration,..." lines Chassis::calibrateOdom prints to the terminal and solves
+// them again, so a real calibration run can be checked or re-solved without the robot. Without one, generates the
+// segments of a calibration run from a robot whose wheels differ from main.cpp by a few percent, adds encoder and IMU
+// noise, and checks the solver recovers the true values. Exits with 1 if it doesn't.
+
+namespace {
+struct Wheel {
+        double scale; // true diameter as a fraction of the configured diameter
+        double offset;
+};
+
+// the true robot. main.cpp has -4.55, 4.55 and -5 for the offsets and 10.4 for the track width
+constexpr Wheel VERTICAL1 {1.012, -4.31};
+constexpr Wheel VERTICAL2 {0.991, 4.72};
+constexpr Wheel HORIZONTAL {1, -5.35};
+constexpr Wheel DRIVE {1.021, 0.05};
+constexpr double TRACK_WIDTH = 10.9;
+
+void print(const char* name, const lemlib::WheelCalibration& wheel) {
+    if (!wheel.valid) std::printf("%-12s not enough data\n", name);
+    else std::printf("%-12s scale %.4f offset %.4f error %.3f in\n", name, wheel.scale, wheel.offset, wheel.error);
+}
+
+void print(const lemlib::CalibrationResult& result) {
+    print("vertical1", result.vertical1);
+    print("vertical2", result.vertical2);
+    print("horizontal1", result.horizontal1);
+    print("horizontal2", result.horizontal2);
+    print("drive", result.drive);
+    std::printf("%-12s %.4f\n", "track width", result.trackWidth);
+}
+
+bool readLog(const char* path, lemlib::OdomCalibration& calibration) {
+    FILE* file = std::fopen(path, "r");
+    if (file == nullptr) return false;
+    char line[256];
+    int segments = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        // the line can have terminal junk in front of it
+        const char* start = std::strstr(line, "calibration,");
+        if (start == nullptr) continue;
+        char type[16];
+        float distance;
+        lemlib::CalibrationSegment s;
+        if (std::sscanf(start, "calibration,%15[^,],%f,%f,%f,%f,%f,%f,%f,%f", type, &distance, &s.vertical1,
+                        &s.vertical2, &s.horizontal1, &s.horizontal2, &s.left, &s.right, &s.heading) != 9)
+            continue;
+        if (!std::strcmp(type, "spin")) calibration.addSpin(s);
+        else calibration.addStraight(s, distance);
+        segments++;
+    }
+    std::fclose(file);
+    std::printf("read %d segments from %s\n", segments, path);
+    return true;
+}
+
+bool check(const char* name, double value, double truth, double tolerance) {
+    const bool ok = std::fabs(value - truth) <= tolerance;
+    std::printf("%-24s %9.4f true %9.4f %s\n", name, value, truth, ok ? "ok" : "FAIL");
+    return ok;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    lemlib::OdomCalibration calibration;
+    if (argc > 1) {
+        if (!readLog(argv[1], calibration)) {
+            std::printf("can't open %s\n", argv[1]);
+            return 1;
+        }
+        print(calibration.solve());
+        return 0;
+    }
+
+    std::mt19937 rng(72116);
+    std::normal_distribution<double> gaussian(0, 1);
+    // what a wheel reads over a segment with the configured diameter, with quantization and slip noise
+    auto read = [&](const Wheel& wheel, double distance, double turn, double noise) {
+        return float((distance - turn * wheel.offset) / wheel.scale + noise * gaussian(rng));
+    };
+    auto segment = [&](double distance, double lateral, double turn) {
+        const Wheel left {DRIVE.scale, DRIVE.offset - TRACK_WIDTH / 2};
+        const Wheel right {DRIVE.scale, DRIVE.offset + TRACK_WIDTH / 2};
+        return lemlib::CalibrationSegment {read(VERTICAL1, distance, turn, 0.01),
+                                           read(VERTICAL2, distance, turn, 0.01),
+                                           read(HORIZONTAL, lateral, turn, 0.01),
+                                           0,
+                                           read(left, distance, turn, 0.1),
+                                           read(right, distance, turn, 0.1),
+                                           float(turn + 0.002 * gaussian(rng))};
+    };
+    // same segments Chassis::calibrateOdom drives by default. Straights wander a little, spins creep a little
+    for (int i = 0; i < 4; i++) {
+        const double distance = (i % 2 == 0 ? 1 : -1) * (48 + gaussian(rng));
+        calibration.addStraight(segment(distance, 0.05 * gaussian(rng), 0.02 * gaussian(rng)), distance);
+    }
+    for (int i = 0; i < 4; i++) {
+        const double turn = (i % 2 == 0 ? 1 : -1) * (4 * M_PI + 0.1 * gaussian(rng));
+        calibration.addSpin(segment(0.1 * gaussian(rng), 0.1 * gaussian(rng), turn));
+    }
+
+    const lemlib::CalibrationResult result = calibration.solve();
+    print(result);
+    bool ok = true;
+    ok &= check("vertical1 scale", result.vertical1.scale, VERTICAL1.scale, 0.002);
+    ok &= check("vertical1 offset", result.vertical1.offset, VERTICAL1.offset, 0.02);
+    ok &= check("vertical2 scale", result.vertical2.scale, VERTICAL2.scale, 0.002);
+    ok &= check("vertical2 offset", result.vertical2.offset, VERTICAL2.offset, 0.02);
+    ok &= check("horizontal1 offset", result.horizontal1.offset, HORIZONTAL.offset, 0.02);
+    ok &= !result.horizontal2.valid;
+    ok &= check("drive scale", result.drive.scale, DRIVE.scale, 0.005);
+    ok &= check("track width", result.trackWidth, TRACK_WIDTH, 0.05);
+    std::printf("%s\n", ok ? "calibration recovered the true robot" : "calibration FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "lemlib/chassis/odomFilter.hpp"
+
+// Microbenchmark for the odometry kalman filter.
+//
+// Drives the filter with the readings the robot in main.cpp produces in EKF mode: two vertical wheels, one
+// horizontal wheel, both sides of the drivetrain and the IMU. The robot follows a synthetic path of arcs for the length
+// of a skills run. Like real encoders, each sensor's total reading gets gaussian noise, so the noise in one update's
+// reading is cancelled out by the next instead of adding up. The final pose error is printed as a sanity check
+// alongside the timing, and the run is repeated to get a stable time.
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr float DT = 0.01;
+
+struct Reading {
+        float vertical1;
+        float vertical2;
+        float horizontal;
+        float left;
+        float right;
+        float imu;
+};
+
+struct Wheel {
+        float offset;
+        float noise;
+};
+
+// same offsets as main.cpp
+constexpr Wheel VERTICAL1 {-4.55, 0.002};
+constexpr Wheel VERTICAL2 {4.55, 0.002};
+constexpr Wheel HORIZONTAL {-5, 0.002};
+constexpr Wheel LEFT {-5.2, 0.05};
+constexpr Wheel RIGHT {5.2, 0.05};
+constexpr float IMU_NOISE = 0.0005;
+} // namespace
+
+int main(int argc, char** argv) {
+    const int updates = 6000; // 60 s skills run
+    const int runs = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    // generate the path up front so only the filter is timed
+    std::mt19937 rng(72116);
+    std::normal_distribution<float> gaussian(0, 1);
+    std::vector<Reading> readings;
+    readings.reserve(updates);
+    double x = 0;
+    double y = 0;
+    double theta = 0;
+    // true total reading and previous noisy reading of each wheel, then the imu
+    std::array<double, 6> total {};
+    std::array<float, 6> previous {};
+    for (int i = 0; i < updates; i++) {
+        const double t = i * DT;
+        const double forward = 40 * std::sin(t * 0.7) * DT; // inches this update
+        const double lateral = 0.5 * std::sin(t * 2.3) * DT;
+        const double turn = 1.5 * std::sin(t * 0.4) * DT; // radians this update
+        auto read = [&](size_t sensor, double travel, float noise) {
+            total[sensor] += travel;
+            const float reading = float(total[sensor] + noise * gaussian(rng));
+            const float delta = reading - previous[sensor];
+            previous[sensor] = reading;
+            return delta;
+        };
+        auto wheel = [&](size_t sensor, double travel, const Wheel& w) {
+            return read(sensor, travel - turn * w.offset, w.noise);
+        };
+        readings.push_back({wheel(0, forward, VERTICAL1), wheel(1, forward, VERTICAL2), wheel(2, lateral, HORIZONTAL),
+                            wheel(3, forward, LEFT), wheel(4, forward, RIGHT), read(5, turn, IMU_NOISE)});
+        // advance the true pose with the same arc model as odom
+        const double chord = turn == 0 ? 1 : 2 * std::sin(turn / 2) / turn;
+        const double avgHeading = theta + turn / 2;
+        x += forward * chord * std::sin(avgHeading) - lateral * chord * std::cos(avgHeading);
+        y += forward * chord * std::cos(avgHeading) + lateral * chord * std::sin(avgHeading);
+        theta += turn;
+    }
+
+    lemlib::OdomFilter filter;
+    std::vector<double> times;
+    for (int run = 0; run < runs; run++) {
+        filter = lemlib::OdomFilter();
+        const Clock::time_point start = Clock::now();
+        for (const Reading& r : readings) {
+            filter.predict(DT);
+            filter.fuseVertical(r.vertical1, VERTICAL1.offset, VERTICAL1.noise);
+            filter.fuseVertical(r.vertical2, VERTICAL2.offset, VERTICAL2.noise);
+            filter.fuseHorizontal(r.horizontal, HORIZONTAL.offset, HORIZONTAL.noise);
+            filter.fuseVertical(r.left, LEFT.offset, LEFT.noise);
+            filter.fuseVertical(r.right, RIGHT.offset, RIGHT.noise);
+            filter.fuseHeading(r.imu, IMU_NOISE);
+            filter.integrate();
+        }
+        times.push_back(std::chrono::duration<double>(Clock::now() - start).count() / updates * 1e9);
+    }
+    std::sort(times.begin(), times.end());
+
+    const lemlib::Pose pose = filter.getPose();
+    std::printf("%d runs of %d updates, ns per update: min %.0f median %.0f max %.0f\n", runs, updates, times.front(),
+                times[times.size() / 2], times.back());
+    std::printf("final pose (%.2f, %.2f, %.4f) true (%.2f, %.2f, %.4f)\n", pose.x, pose.y, pose.theta, x, y, theta);
+    std::printf("error %.3f in, %.5f rad\n", std::hypot(pose.x - x, pose.y - y), std::abs(pose.theta - theta));
+    return 0;
+}
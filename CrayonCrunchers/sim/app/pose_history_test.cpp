@@ -0,0 +1,104 @@
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "lemlib/chassis/poseHistory.hpp"
+
+// Host test for the pose history odom keeps for getPoseAt.
+//
+// Checks lookups between samples interpolate, and that both edges of the buffer behave, before and after it wraps and
+// after a reset. Then looks poses up from other threads while one thread keeps adding them, where every pose is a
+// function of its time, so a lookup that mixes two writes shows up. Exits with 1 if anything fails.
+
+namespace {
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    if (ok) return;
+    std::printf("FAILED: %s\n", what);
+    failures++;
+}
+
+bool near(const std::optional<lemlib::Pose>& pose, float x, float y, float theta) {
+    return pose && std::fabs(pose->x - x) < 1e-3 && std::fabs(pose->y - y) < 1e-3 &&
+           std::fabs(pose->theta - theta) < 1e-3;
+}
+
+// a pose every 10 ms, where x is the time, y is twice it and theta a tenth of it
+lemlib::Pose poseAt(uint32_t time) { return lemlib::Pose(float(time), 2 * float(time), float(time) / 10); }
+
+void testEdges() {
+    lemlib::PoseHistory history;
+    check(!history.get(0), "empty history has no pose");
+    check(history.size() == 0, "empty history has no samples");
+
+    for (uint32_t time = 100; time <= 200; time += 10) history.push(poseAt(time), time);
+    check(history.size() == 11, "size counts every sample");
+    check(near(history.get(135), 135, 270, 13.5), "interpolates between samples");
+    check(near(history.get(140), 140, 280, 14), "returns a sample at its own time");
+    check(near(history.get(100), 100, 200, 10), "returns the oldest sample at its time");
+    check(!history.get(99), "no pose before the oldest sample");
+    check(near(history.get(200), 200, 400, 20), "returns the latest sample at its time");
+    check(near(history.get(5000), 200, 400, 20), "returns the latest sample after it");
+
+    // wrap the buffer, so the oldest sample is no longer in the first slot
+    const uint32_t last = 200 + 10 * (lemlib::PoseHistory::CAPACITY + 5);
+    for (uint32_t time = 210; time <= last; time += 10) history.push(poseAt(time), time);
+    const uint32_t oldest = last - 10 * (lemlib::PoseHistory::CAPACITY - 1);
+    check(history.size() == lemlib::PoseHistory::CAPACITY, "a full history keeps CAPACITY samples");
+    check(!history.get(oldest - 1), "no pose before the oldest sample once wrapped");
+    check(near(history.get(oldest), oldest, 2 * oldest, oldest / 10.0f), "returns the oldest sample once wrapped");
+    check(near(history.get(oldest + 4), oldest + 4, 2 * (oldest + 4), (oldest + 4) / 10.0f),
+          "interpolates across the oldest samples once wrapped");
+    check(near(history.get(last - 3), last - 3, 2 * (last - 3), (last - 3) / 10.0f),
+          "interpolates across the newest samples once wrapped");
+    check(near(history.get(last), last, 2 * last, last / 10.0f), "returns the latest sample once wrapped");
+
+    // a reset drops every sample before it
+    history.reset(lemlib::Pose(1, 2, 3), last + 10);
+    check(history.size() == 1, "a reset leaves one sample");
+    check(!history.get(last), "no pose from before a reset");
+    check(near(history.get(last + 10), 1, 2, 3), "returns the pose a reset started from");
+    history.push(lemlib::Pose(3, 2, 1), last + 20);
+    check(near(history.get(last + 15), 2, 2, 2), "interpolates after a reset");
+}
+
+void testConcurrent() {
+    lemlib::PoseHistory history;
+    history.push(poseAt(0), 0);
+    std::atomic<uint32_t> latest = 0;
+    std::atomic<bool> done = false;
+    std::atomic<int> torn = 0;
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; r++) {
+        readers.emplace_back([&]() {
+            while (!done.load(std::memory_order_relaxed)) {
+                // somewhere in the newer half of the buffer. The writer never sleeps, so it can still drop the
+                // sample before a slow lookup gets to it, which is fine as long as the lookup says so
+                const uint32_t newest = latest.load(std::memory_order_acquire);
+                const uint32_t back = 10 * (lemlib::PoseHistory::CAPACITY / 2);
+                const uint32_t time = newest > back ? newest - back + newest % 7 : newest;
+                const std::optional<lemlib::Pose> pose = history.get(time);
+                if (pose && (pose->y != 2 * pose->x || std::fabs(pose->x - float(time)) > 0.5f)) torn++;
+            }
+        });
+    }
+    for (uint32_t time = 10; time <= 1000000; time += 10) {
+        history.push(poseAt(time), time);
+        latest.store(time, std::memory_order_release);
+    }
+    done = true;
+    for (std::thread& reader : readers) reader.join();
+    check(torn == 0, "lookups while poses are added see whole poses");
+}
+} // namespace
+
+int main() {
+    testEdges();
+    testConcurrent();
+    std::printf("%s\n", failures == 0 ? "every check passed" : "pose history FAILED");
+    return failures == 0 ? 0 : 1;
+}
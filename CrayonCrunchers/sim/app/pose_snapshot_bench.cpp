@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/seqlock.hpp"
+
+// Microbenchmark for the seqlock odom publishes its pose through.
+//
+// One writer thread publishes as fast as it can, like an odom task that never sleeps, while reader threads take
+// snapshots. Every field of a published snapshot holds the same counter, so a torn read shows up as a mismatch.
+// A mutex-guarded pose is measured the same way for comparison.
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+lemlib::PoseSnapshot makeSnapshot(uint32_t i) {
+    const float f = float(i);
+    return {lemlib::Pose(f, f, f), lemlib::Pose(f, f, f), i};
+}
+
+bool isConsistent(const lemlib::PoseSnapshot& s) {
+    const float f = float(s.timestamp);
+    return s.pose.x == f && s.pose.y == f && s.pose.theta == f && s.speed.x == f && s.speed.y == f &&
+           s.speed.theta == f;
+}
+
+struct Stats {
+        std::vector<double> readLatency; // in ns
+        std::vector<double> writeLatency; // in ns
+        uint64_t torn = 0;
+        uint64_t failedWrites = 0;
+};
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values.at(std::min(values.size() - 1, size_t(p * (values.size() - 1))));
+}
+
+template <typename Write, typename Read> Stats run(int readers, int reads, Write write, Read read) {
+    Stats stats;
+    std::atomic<bool> done = false;
+    std::thread writer([&]() {
+        for (uint32_t i = 1; !done.load(std::memory_order_relaxed); i++) {
+            const auto start = Clock::now();
+            if (!write(makeSnapshot(i))) stats.failedWrites++;
+            if (i % 16 == 0) stats.writeLatency.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        }
+    });
+    std::vector<std::thread> threads;
+    std::vector<Stats> readerStats(readers);
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r]() {
+            Stats& local = readerStats.at(r);
+            local.readLatency.reserve(reads);
+            for (int i = 0; i < reads; i++) {
+                const auto start = Clock::now();
+                const lemlib::PoseSnapshot snapshot = read();
+                local.readLatency.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+                if (!isConsistent(snapshot)) local.torn++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    done = true;
+    writer.join();
+    for (Stats& local : readerStats) {
+        stats.readLatency.insert(stats.readLatency.end(), local.readLatency.begin(), local.readLatency.end());
+        stats.torn += local.torn;
+    }
+    return stats;
+}
+
+void report(const char* name, Stats stats) {
+    std::printf("%-8s read ns p50 %7.0f p99 %7.0f max %9.0f | write ns p50 %7.0f p99 %7.0f max %9.0f | torn %llu "
+                "failed writes %llu\n",
+                name, percentile(stats.readLatency, 0.5), percentile(stats.readLatency, 0.99),
+                percentile(stats.readLatency, 1), percentile(stats.writeLatency, 0.5),
+                percentile(stats.writeLatency, 0.99), percentile(stats.writeLatency, 1),
+                (unsigned long long)stats.torn, (unsigned long long)stats.failedWrites);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    const int readers = argc > 1 ? std::atoi(argv[1]) : 3;
+    const int reads = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    std::printf("%d readers, %d reads each, writer publishing continuously\n", readers, reads);
+
+    lemlib::SeqLock<lemlib::PoseSnapshot> seqlock(makeSnapshot(0));
+    report("seqlock", run(
+                          readers, reads, [&](const lemlib::PoseSnapshot& s) { return seqlock.tryWrite(s); },
+                          [&]() { return seqlock.read(); }));
+
+    std::mutex mutex;
+    lemlib::PoseSnapshot guarded = makeSnapshot(0);
+    report("mutex", run(
+                        readers, reads,
+                        [&](const lemlib::PoseSnapshot& s) {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            guarded = s;
+                            return true;
+                        },
+                        [&]() {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            return guarded;
+                        }));
+    return 0;
+}
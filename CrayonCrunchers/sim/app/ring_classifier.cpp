@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "lemlib/mechanisms/ringClassifier.hpp"
+
+// Host check for lemlib::RingClassifier against recorded optical sensor readings.
+//
+// Takes the optical.csv that sim/app/telemetry_decode writes from a recording with ring color calibration in it,
+// fits the classifier to every other labelled reading, and tests it on the rest, next to the hue windows color sorting
+// used before. Writes the fitted model to a file if given one, to copy onto the microSD card as ring_colors.txt.
+// Without a recording, makes readings of rings under a few kinds of field lighting instead, and exits with 1 if the
+// classifier gets more than 1% of them wrong.
+
+namespace {
+struct Reading {
+        lemlib::OpticalSample sample;
+        int label;
+};
+
+// the hue windows and saturation gate color sorting used before the classifier
+lemlib::RingColor hueWindows(const lemlib::OpticalSample& sample) {
+    if (sample.saturation <= 0.2) return lemlib::RingColor::NONE;
+    if (sample.hue > 345 || sample.hue < 15) return lemlib::RingColor::RED;
+    if (sample.hue > 210 && sample.hue < 230) return lemlib::RingColor::BLUE;
+    return lemlib::RingColor::NONE;
+}
+
+std::vector<std::string> split(const std::string& line) {
+    std::vector<std::string> cells;
+    std::string cell;
+    for (char c : line) {
+        if (c == ',') {
+            cells.push_back(cell);
+            cell.clear();
+        } else if (c != '"' && c != '\n' && c != '\r') {
+            cell += c;
+        }
+    }
+    cells.push_back(cell);
+    return cells;
+}
+
+bool load(const char* path, std::vector<Reading>& readings) {
+    FILE* file = std::fopen(path, "r");
+    if (file == nullptr) return false;
+    char line[512];
+    if (std::fgets(line, sizeof(line), file) == nullptr) {
+        std::fclose(file);
+        return false;
+    }
+    // find the columns by name, so fields added to the channel later don't break this
+    const std::vector<std::string> header = split(line);
+    const char* names[] = {"red", "green", "blue", "brightness", "hue", "saturation", "proximity", "label"};
+    std::array<int, 8> columns;
+    for (size_t i = 0; i < columns.size(); i++) {
+        columns[i] = -1;
+        for (size_t c = 0; c < header.size(); c++) {
+            if (header[c] == names[i]) columns[i] = c;
+        }
+        if (columns[i] == -1) {
+            std::printf("%s has no %s column\n", path, names[i]);
+            std::fclose(file);
+            return false;
+        }
+    }
+    while (std::fgets(line, sizeof(line), file) != nullptr) {
+        const std::vector<std::string> cells = split(line);
+        std::array<float, 8> values;
+        bool complete = true;
+        for (size_t i = 0; i < columns.size(); i++) {
+            complete = complete && size_t(columns[i]) < cells.size() && !cells[columns[i]].empty();
+            if (complete) values[i] = std::atof(cells[columns[i]].c_str());
+        }
+        if (!complete || values[7] < 0) continue;
+        Reading reading;
+        reading.sample = {values[0], values[1], values[2], values[3], values[4], values[5], int32_t(values[6])};
+        reading.label = int(values[7]);
+        if (reading.label < lemlib::RingClassifier::CLASSES) readings.push_back(reading);
+    }
+    std::fclose(file);
+    return true;
+}
+
+// reading of a ring, or of the empty conveyor, as the sim's optical sensor would make it
+lemlib::OpticalSample makeSample(float hue, float saturation, float brightness, int32_t proximity) {
+    const float h = std::fmod(hue + 360, 360.0f) / 60;
+    const float chroma = brightness * saturation;
+    const float x = chroma * (1 - std::fabs(std::fmod(h, 2) - 1));
+    std::array<float, 3> rgb;
+    switch (int(h)) {
+        case 0: rgb = {chroma, x, 0}; break;
+        case 1: rgb = {x, chroma, 0}; break;
+        case 2: rgb = {0, chroma, x}; break;
+        case 3: rgb = {0, x, chroma}; break;
+        case 4: rgb = {x, 0, chroma}; break;
+        default: rgb = {chroma, 0, x}; break;
+    }
+    const float base = brightness - chroma;
+    return {(rgb[0] + base) * 255, (rgb[1] + base) * 255, (rgb[2] + base) * 255, brightness,
+            std::fmod(hue + 360, 360.0f), saturation, proximity};
+}
+
+// readings under one kind of field lighting, which shifts every hue and changes how saturated and bright rings look
+std::vector<Reading> makeReadings(std::mt19937& rng, float hueShift, float saturationScale, float brightness, int n) {
+    std::normal_distribution<float> noise(0, 1);
+    std::vector<Reading> readings;
+    for (int i = 0; i < n; i++) {
+        const int label = i % 3;
+        const float hue = label == 1 ? 5 : label == 2 ? 218 : 60;
+        const float saturation = label == 0 ? 0.08 : 0.55 * saturationScale;
+        const int32_t proximity = label == 0 ? 20 : 180;
+        lemlib::OpticalSample sample = makeSample(hue + hueShift + noise(rng) * 6,
+                                                  std::fmax(0.0f, saturation + noise(rng) * 0.04),
+                                                  brightness * (label == 0 ? 0.3f : 1) * (1 + noise(rng) * 0.05),
+                                                  proximity + int32_t(noise(rng) * 10));
+        readings.push_back({sample, label});
+    }
+    return readings;
+}
+
+struct Result {
+        // [actual][classified]
+        std::array<std::array<int, lemlib::RingClassifier::CLASSES>, lemlib::RingClassifier::CLASSES> confusion {};
+        int wrong = 0;
+        int total = 0;
+        double confidence = 0;
+};
+
+void print(const char* name, const Result& result) {
+    std::printf("%-12s %5.1f%% wrong of %d |", name, 100.0 * result.wrong / std::max(result.total, 1), result.total);
+    for (int actual = 0; actual < lemlib::RingClassifier::CLASSES; actual++) {
+        std::printf(" %s:", lemlib::toString(static_cast<lemlib::RingColor>(actual)));
+        for (int classified : result.confusion[actual]) std::printf(" %4d", classified);
+        std::printf(" |");
+    }
+    if (result.confidence > 0) std::printf(" mean confidence %.3f", result.confidence / std::max(result.total, 1));
+    std::printf("\n");
+}
+
+// fits to every other reading of each color, and tests on the rest
+Result evaluate(const std::vector<Reading>& readings, lemlib::RingClassifier& classifier, Result& windows) {
+    std::array<int, lemlib::RingClassifier::CLASSES> seen {};
+    std::vector<const Reading*> test;
+    for (const Reading& reading : readings) {
+        if (seen[reading.label]++ % 2 == 0) classifier.addSample(static_cast<lemlib::RingColor>(reading.label),
+                                                                 reading.sample);
+        else test.push_back(&reading);
+    }
+    Result result;
+    if (!classifier.fit()) return result;
+    for (const Reading* reading : test) {
+        const lemlib::RingClassification ring = classifier.classify(reading->sample);
+        result.confusion[reading->label][static_cast<int>(ring.color)]++;
+        result.wrong += static_cast<int>(ring.color) != reading->label;
+        result.confidence += ring.confidence;
+        result.total++;
+        const lemlib::RingColor old = hueWindows(reading->sample);
+        windows.confusion[reading->label][static_cast<int>(old)]++;
+        windows.wrong += static_cast<int>(old) != reading->label;
+        windows.total++;
+    }
+    return result;
+}
+
+double timeClassify(const lemlib::RingClassifier& classifier, const std::vector<Reading>& readings) {
+    constexpr int ROUNDS = 200;
+    volatile float sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (const Reading& reading : readings) sink = sink + classifier.classify(reading.sample).confidence;
+    }
+    const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / (ROUNDS * readings.size());
+}
+
+int selfTest() {
+    struct Lighting {
+            const char* name;
+            float hueShift;
+            float saturationScale;
+            float brightness;
+    };
+    const Lighting lightings[] = {
+        {"neutral", 0, 1, 0.6}, {"warm", 14, 0.8, 0.5}, {"cool", -12, 0.9, 0.7}, {"dim", 6, 0.5, 0.2}};
+    std::mt19937 rng(1);
+    bool passed = true;
+    for (const Lighting& lighting : lightings) {
+        const std::vector<Reading> readings =
+            makeReadings(rng, lighting.hueShift, lighting.saturationScale, lighting.brightness, 600);
+        lemlib::RingClassifier classifier;
+        Result windows;
+        const Result result = evaluate(readings, classifier, windows);
+        std::printf("%s lighting\n", lighting.name);
+        print("classifier", result);
+        print("hue windows", windows);
+        passed = passed && result.total > 0 && result.wrong * 100 <= result.total;
+        if (&lighting == &lightings[0]) std::printf("classify takes %.0f ns\n", timeClassify(classifier, readings));
+    }
+    std::printf("%s\n", passed ? "self test passed" : "self test FAILED");
+    return passed ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) return selfTest();
+    std::vector<Reading> readings;
+    if (!load(argv[1], readings)) {
+        std::printf("can't read %s\n", argv[1]);
+        return 1;
+    }
+    lemlib::RingClassifier classifier;
+    Result windows;
+    const Result result = evaluate(readings, classifier, windows);
+    if (result.total == 0) {
+        std::printf("%zu labelled readings in %s, need %d of each color to fit\n", readings.size(), argv[1],
+                    2 * lemlib::RingClassifier::MIN_SAMPLES);
+        return 1;
+    }
+    print("classifier", result);
+    print("hue windows", windows);
+    std::printf("classify takes %.0f ns\n", timeClassify(classifier, readings));
+    if (argc > 2) {
+        // fit to every reading for the saved model
+        lemlib::RingClassifier full;
+        for (const Reading& reading : readings) full.addSample(static_cast<lemlib::RingColor>(reading.label),
+                                                               reading.sample);
+        if (!full.fit() || !full.save(argv[2])) {
+            std::printf("can't write %s\n", argv[2]);
+            return 1;
+        }
+        std::printf("model written to %s\n", argv[2]);
+    }
+    return 0;
+}
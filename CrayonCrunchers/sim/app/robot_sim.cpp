@@ -0,0 +1,59 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "sim/runner.hpp"
+
+namespace {
+void usage(const char* name) {
+    std::printf("usage: %s [--route N] [--side -1|0|1] [--alliance red|blue] [--time SECONDS] [--trace FILE]\n"
+                "       [--unplug PORT] [--jam PORT] [--wall SECONDS] [--fault-time SECONDS]\n"
+                "       [--ring X,Y,red|blue]...\n",
+                name);
+}
+
+bool parseOptions(int argc, char** argv, sim::TrialConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--route") && hasValue) config.route = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--side") && hasValue) config.side = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--alliance") && hasValue) config.alliance = !std::strcmp(argv[++i], "blue");
+        else if (!std::strcmp(argv[i], "--time") && hasValue) config.time = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--trace") && hasValue) config.trace = argv[++i];
+        else if (!std::strcmp(argv[i], "--unplug") && hasValue) config.perturbation.unplugPort = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--jam") && hasValue) config.perturbation.jamPort = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--wall") && hasValue) config.perturbation.wallTime = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--fault-time") && hasValue)
+            config.perturbation.faultTime = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--ring") && hasValue) {
+            sim::FieldRing ring;
+            char color[8] = {};
+            if (std::sscanf(argv[++i], "%lf,%lf,%7s", &ring.x, &ring.y, color) != 3) return false;
+            ring.blue = !std::strcmp(color, "blue");
+            config.rings.push_back(ring);
+        } else return false;
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    sim::TrialConfig config;
+    if (!parseOptions(argc, argv, config)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const sim::TrialResult result = sim::runTrial(config);
+    if (!result.completed) {
+        std::printf("initialize() did not return\n");
+        std::fflush(stdout);
+        std::_Exit(1);
+    }
+    std::printf("route %d: true (%.2f, %.2f, %.2f) odom (%.2f, %.2f, %.2f)\n", result.route, result.x, result.y,
+                result.theta, result.odomX, result.odomY, result.odomTheta);
+    if (!config.rings.empty()) std::printf("rings: held %d scored %d\n", result.ringsHeld, result.ringsScored);
+    std::printf("simulated %.3f s in %.1f ms\n", result.simTime, result.wallTime);
+    std::fflush(stdout);
+    // tasks are still parked on their own stacks, skip static destructors
+    std::_Exit(0);
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "lemlib/logger/telemetryFrame.hpp"
+
+// Host decoder for binary telemetry from TelemetrySink and RecorderSink.
+//
+// With a capture of the robot's serial output, or a file the recorder wrote to the microSD card, finds every frame in it, skips the text around them and writes one CSV
+// file per channel, named after the channel and with a column per field, ready for plotting. Without one, encodes a
+// stream like the one main.cpp sends, buries it in text, and checks every frame decodes back. Exits with 1 if not.
+
+namespace {
+struct Channel {
+        std::string name;
+        std::vector<std::string> fields;
+        std::vector<std::string> rows;
+        int columns = 0;
+};
+
+struct Stream {
+        std::map<int, Channel> channels;
+        int frames = 0;
+        int rejected = 0;
+};
+
+std::string toString(const lemlib::TelemetryField& field) {
+    char text[32];
+    switch (field.type) {
+        case lemlib::TelemetryType::FLOAT: std::snprintf(text, sizeof(text), "%.9g", field.number); return text;
+        case lemlib::TelemetryType::STRING: {
+            // quoted, since logged messages have commas in them
+            std::string quoted = "\"";
+            for (char c : field.string) quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+            return quoted + "\"";
+        }
+        default: return std::to_string(field.integer);
+    }
+}
+
+// split the stream on the 0s that end frames, and decode what is between them
+Stream decode(const std::vector<uint8_t>& bytes) {
+    Stream stream;
+    std::vector<uint8_t> scratch(bytes.size());
+    lemlib::DecodedTelemetryFrame frame;
+    size_t start = 0;
+    for (size_t i = 0; i < bytes.size(); i++) {
+        if (bytes[i] != 0) continue;
+        // the recorder pads its writes with 0s
+        if (i == start) {
+            start = i + 1;
+            continue;
+        }
+        // text in front of a frame ends up in the same chunk. Frames are short, so try the end of the chunk too
+        bool found = false;
+        const size_t first = i - start > lemlib::TelemetryFrame::MAX_ENCODED_SIZE
+                                 ? i - lemlib::TelemetryFrame::MAX_ENCODED_SIZE
+                                 : start;
+        for (size_t from = first; from < i && !found; from++) {
+            found = lemlib::decodeTelemetryFrame(&bytes[from], i - from, scratch.data(), frame);
+        }
+        start = i + 1;
+        if (!found) {
+            stream.rejected++;
+            continue;
+        }
+        stream.frames++;
+        if (frame.channel == lemlib::TelemetryFrame::SCHEMA_CHANNEL) {
+            if (frame.fieldCount < 2) continue;
+            Channel& channel = stream.channels[frame.fields[0].integer];
+            channel.name = std::string(frame.fields[1].string);
+            channel.fields.clear();
+            for (int f = 2; f < frame.fieldCount; f++) channel.fields.emplace_back(frame.fields[f].string);
+            continue;
+        }
+        std::string row = std::to_string(frame.time);
+        for (int f = 0; f < frame.fieldCount; f++) row += "," + toString(frame.fields[f]);
+        Channel& channel = stream.channels[frame.channel];
+        channel.rows.push_back(row);
+        channel.columns = std::max(channel.columns, frame.fieldCount);
+    }
+    return stream;
+}
+
+bool write(const Stream& stream, const std::string& prefix) {
+    for (const auto& [id, channel] : stream.channels) {
+        if (channel.rows.empty()) continue;
+        const std::string name = channel.name.empty() ? "channel" + std::to_string(id) : channel.name;
+        const std::string path = prefix + name + ".csv";
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (file == nullptr) return false;
+        std::fprintf(file, "time");
+        // channels that were never defined get numbered columns
+        for (size_t f = 0; f < size_t(channel.columns); f++) {
+            if (f < channel.fields.size()) std::fprintf(file, ",%s", channel.fields[f].c_str());
+            else std::fprintf(file, ",field%zu", f + 1);
+        }
+        std::fprintf(file, "\n");
+        for (const std::string& row : channel.rows) std::fprintf(file, "%s\n", row.c_str());
+        std::fclose(file);
+        std::printf("%-12s %6zu rows -> %s\n", name.c_str(), channel.rows.size(), path.c_str());
+    }
+    return true;
+}
+
+void append(std::vector<uint8_t>& bytes, const lemlib::TelemetryFrame& frame) {
+    uint8_t encoded[lemlib::TelemetryFrame::MAX_ENCODED_SIZE];
+    const size_t size = frame.encode(encoded);
+    bytes.insert(bytes.end(), encoded, encoded + size);
+}
+
+void append(std::vector<uint8_t>& bytes, const char* text) { bytes.insert(bytes.end(), text, text + strlen(text)); }
+
+int selfTest() {
+    std::mt19937 rng(72116);
+    std::uniform_real_distribution<float> uniform(-72, 72);
+    std::vector<uint8_t> bytes;
+    std::vector<std::string> expected;
+    size_t textBytes = 0;
+    size_t textSent = 0;
+    // a decoder that starts late sees data before the channel definition
+    for (int tick = 0; tick < 1000; tick++) {
+        if (tick == 10) {
+            lemlib::TelemetryFrame schema(lemlib::TelemetryFrame::SCHEMA_CHANNEL, tick * 10);
+            schema.add(1);
+            schema.add("pose");
+            for (const char* field : {"x", "y", "theta"}) schema.add(field);
+            append(bytes, schema);
+        }
+        const float x = uniform(rng), y = uniform(rng), theta = uniform(rng) * 5;
+        lemlib::TelemetryFrame frame(1, tick * 10);
+        frame.add(x);
+        frame.add(y);
+        frame.add(theta);
+        // every byte value shows up in floats, 0s included, which COBS has to get through
+        if (tick == 500) {
+            lemlib::TelemetryFrame zeros(1, tick * 10);
+            zeros.add(0.0f);
+            zeros.add(0.0f);
+            zeros.add(0.0f);
+            append(bytes, zeros);
+            expected.push_back(std::to_string(tick * 10) + ",0,0,0");
+        }
+        append(bytes, frame);
+        // and the recorder's padding
+        if (tick % 100 == 99) bytes.insert(bytes.end(), 37, 0);
+        char row[96];
+        std::snprintf(row, sizeof(row), "%d,%.9g,%.9g,%.9g", tick * 10, x, y, theta);
+        expected.push_back(row);
+        // the same pose as text, the way the sink logs it, shows up between frames
+        char text[128];
+        std::snprintf(text, sizeof(text),
+                      "\033[sTELE_STARTChassis pose: lemlib::Pose { x: %g, y: %g, theta: %g }TELE_END\033[u\033[0J", x,
+                      y, theta);
+        textBytes += std::strlen(text);
+        if (tick % 7 != 0) continue;
+        append(bytes, text);
+        textSent += std::strlen(text);
+    }
+
+    const Stream stream = decode(bytes);
+    const auto found = stream.channels.find(1);
+    bool ok = found != stream.channels.end() && found->second.name == "pose" && found->second.fields.size() == 3;
+    ok &= found != stream.channels.end() && found->second.rows == expected;
+    std::printf("%d frames decoded, %d chunks that weren't frames\n", stream.frames, stream.rejected);
+    std::printf("pose as text %.1f bytes, as a frame %.1f bytes\n", double(textBytes) / 1000,
+                double(bytes.size() - textSent) / (expected.size() + 1));
+    std::printf("%s\n", ok ? "every frame decoded" : "decoding FAILED");
+    return ok ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) return selfTest();
+    FILE* file = std::fopen(argv[1], "rb");
+    if (file == nullptr) {
+        std::printf("can't open %s\n", argv[1]);
+        return 1;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), file)) > 0;) bytes.insert(bytes.end(), chunk, chunk + n);
+    std::fclose(file);
+    const Stream stream = decode(bytes);
+    std::printf("%d frames, %d chunks that weren't frames\n", stream.frames, stream.rejected);
+    return write(stream, argc > 2 ? argv[2] : "") ? 0 : 1;
+}
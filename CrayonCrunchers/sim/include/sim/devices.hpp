@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace sim {
+constexpr int SMART_PORT_COUNT = 22; // smart ports are 1-indexed
+constexpr int ADI_PORT_COUNT = 8;
+
+/**
+ * @brief State of a simulated V5 motor
+ *
+ * Everything is stored in the frame the user code sees, so a reversed motor reads the same as a forward one. The sim
+ * assumes the robot is wired the way the code says it is.
+ */
+struct MotorState {
+        enum class Mode { VOLTAGE, VELOCITY, POSITION, BRAKE };
+
+        Mode mode = Mode::VOLTAGE;
+        double voltage = 0; // commanded voltage, in mV
+        int32_t targetVelocity = 0; // commanded velocity, in rpm
+        double targetPosition = 0; // commanded position, in degrees
+        int32_t profileVelocity = 0; // max velocity for position moves, in rpm
+        double position = 0; // position of the output shaft, in degrees
+        double zero = 0; // position of the output shaft when it was last tared, in degrees
+        double velocity = 0; // velocity of the output shaft, in rpm
+        double current = 0; // current draw, in mA
+        double torque = 0; // output torque, in Nm
+        double temperature = 25; // in degrees celsius
+        int brakeMode = 0; // pros::MotorBrake
+        int gearing = 1; // pros::MotorGears
+        int units = 0; // pros::MotorUnits
+        bool reversed = false;
+        int32_t currentLimit = 2500; // in mA
+        int32_t voltageLimit = 0; // in mV, 0 means no limit
+        bool connected = false;
+};
+
+/**
+ * @brief State of a simulated rotation sensor
+ */
+struct RotationState {
+        double position = 0; // in centidegrees
+        double velocity = 0; // in centidegrees per second
+        bool reversed = false;
+        bool connected = false;
+        bool jammed = false; // the wheel has stopped turning, so the position stops changing
+};
+
+/**
+ * @brief State of a simulated inertial sensor
+ */
+struct ImuState {
+        double rotation = 0; // unbounded rotation reported by the sensor, in degrees
+        double offset = 0; // value subtracted from the rotation by tares and resets, in degrees
+        double pitch = 0;
+        double roll = 0;
+        double gyroRate = 0; // in degrees per second
+        uint32_t calibratedAt = 0; // time calibration finishes, in ms
+        bool connected = false;
+};
+
+/**
+ * @brief State of a simulated optical sensor
+ */
+struct OpticalState {
+        double hue = 0;
+        double saturation = 0;
+        double brightness = 0;
+        int32_t proximity = 0;
+        int32_t ledPwm = 0;
+        double integrationTime = 100; // in ms
+        bool connected = false;
+};
+
+/**
+ * @brief State of a simulated controller
+ *
+ * Inputs can be written by a script to drive opcontrol
+ */
+struct ControllerState {
+        std::array<int32_t, 4> analog {}; // indexed by pros::controller_analog_e_t
+        std::array<bool, 12> digital {}; // indexed by pros::controller_digital_e_t - DIGITAL_L1
+        std::array<bool, 12> pressedLastRead {}; // used for new press detection
+        std::array<std::string, 3> text {};
+        std::string rumble;
+};
+
+extern std::array<MotorState, SMART_PORT_COUNT> motors;
+extern std::array<RotationState, SMART_PORT_COUNT> rotations;
+extern std::array<ImuState, SMART_PORT_COUNT> imus;
+extern std::array<OpticalState, SMART_PORT_COUNT> opticals;
+extern std::array<int32_t, ADI_PORT_COUNT> adi;
+extern ControllerState controller;
+extern uint8_t competitionStatus;
+// whether a microSD card is in. Off, since files go wherever their path says on the host
+extern bool usdInstalled;
+extern std::array<std::string, 8> lcdLines;
+
+/**
+ * @brief Maximum speed of a motor's output shaft for its gearing
+ *
+ * @param gearing pros::MotorGears value
+ * @return float max speed, in rpm
+ */
+double maxRpm(int gearing);
+} // namespace sim
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+#include <ucontext.h>
+
+namespace sim {
+/**
+ * @brief A simulated RTOS task
+ *
+ * Every task runs on its own stack as a coroutine. Only one task runs at a time, and a task only gives up the cpu
+ * when it blocks, so a simulation is fully deterministic.
+ */
+struct Task {
+        enum class State { READY, RUNNING, BLOCKED, SUSPENDED, DELETED };
+
+        ucontext_t context;
+        void* stack = nullptr;
+        void (*function)(void*) = nullptr;
+        void* parameters = nullptr;
+        uint32_t priority = 0;
+        std::string name;
+        State state = State::READY;
+        // time to wake up at in microseconds, or UINT64_MAX to block forever
+        uint64_t wakeTime = UINT64_MAX;
+        // order the task blocked in, used to wake tasks with the same wake time in FIFO order
+        uint64_t blockSequence = 0;
+        uint32_t notifyValue = 0;
+        bool notifyPending = false;
+        bool waitingForNotify = false;
+        // mutex the task is waiting on, if any
+        struct Mutex* waitingMutex = nullptr;
+        // set when a mutex was handed to the task while it was waiting on it
+        bool mutexHandedOff = false;
+        std::vector<Task*> joiners;
+};
+
+/**
+ * @brief A simulated RTOS mutex
+ */
+struct Mutex {
+        Task* owner = nullptr;
+        bool locked = false;
+        std::deque<Task*> waiters;
+};
+
+/**
+ * @brief Cooperative scheduler running on a virtual clock
+ *
+ * The kernel backs the PROS RTOS api on the host. Time only moves forward when every task is blocked, in steps of
+ * 1 ms. A tick hook is called once per step so a plant model can integrate the robot's motion.
+ */
+class Kernel {
+    public:
+        /**
+         * @brief Get the kernel singleton
+         *
+         * The kernel is constructed on first use, so tasks and mutexes can be created during static initialization.
+         */
+        static Kernel& get();
+
+        /**
+         * @brief Run the scheduler until the virtual clock reaches the given time or no task can ever run again
+         *
+         * @param untilMicros virtual time to stop at, in microseconds
+         */
+        void run(uint64_t untilMicros);
+
+        /**
+         * @brief Stop the kernel. Every RTOS call made afterwards is a no-op
+         */
+        void shutdown();
+
+        /**
+         * @brief Set the function called every time the virtual clock advances by 1 ms
+         *
+         * @param hook function taking the new time in microseconds
+         */
+        void setTickHook(std::function<void(uint64_t)> hook);
+
+        uint64_t now() const { return time; }
+
+        bool isShutdown() const { return stopped; }
+
+        Task* current() const { return running; }
+
+        Task* createTask(void (*function)(void*), void* parameters, uint32_t priority, const char* name);
+        void deleteTask(Task* task);
+        void suspendTask(Task* task);
+        void resumeTask(Task* task);
+        void delay(uint64_t micros);
+        void delayUntil(uint64_t wakeMicros);
+        void join(Task* task);
+        uint32_t notify(Task* task, uint32_t value, int action, uint32_t* prevValue);
+        uint32_t notifyTake(bool clearOnExit, uint32_t timeout);
+        bool notifyClear(Task* task);
+        Mutex* createMutex();
+        bool takeMutex(Mutex* mutex, uint32_t timeout);
+        bool giveMutex(Mutex* mutex);
+        void deleteMutex(Mutex* mutex);
+        uint32_t taskCount() const;
+        Task* findTask(const char* name) const;
+        bool isValid(Task* task) const;
+    private:
+        Kernel() = default;
+
+        /**
+         * @brief Block the running task until it is woken or its wake time passes, then return to the scheduler
+         */
+        void block(uint64_t wakeTime);
+        void makeReady(Task* task);
+        void switchToScheduler();
+        void wakeSleepers();
+        static void taskEntry();
+
+        ucontext_t schedulerContext;
+        Task* running = nullptr;
+        std::deque<Task*> readyQueue;
+        std::vector<Task*> tasks;
+        std::function<void(uint64_t)> tickHook;
+        uint64_t time = 0;
+        uint64_t sequence = 0;
+        bool stopped = false;
+};
+} // namespace sim
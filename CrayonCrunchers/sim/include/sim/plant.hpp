@@ -0,0 +1,138 @@
+#pragma once
+
+#include <vector>
+
+namespace sim {
+/**
+ * @brief A tracking wheel mounted on the simulated robot
+ */
+struct TrackingWheelParams {
+        int port; // rotation sensor port
+        double diameter; // in inches
+        double offset; // distance from the tracking center, in inches. Same convention as lemlib::TrackingWheel
+        bool vertical; // whether the wheel measures forward or sideways motion
+};
+
+/**
+ * @brief Physical parameters of the simulated robot
+ *
+ * These are kept apart from the robot config in main.cpp so the real robot can be made to differ from what the code
+ * believes it is, for example a tracking wheel that is slightly larger than its nominal size.
+ */
+struct PlantParams {
+        std::vector<int> leftPorts {12, 11, 13};
+        std::vector<int> rightPorts {14, 16, 17};
+        double wheelDiameter = 2.75; // in inches
+        double driveRpm = 480; // wheel speed at full power
+        double trackWidth = 10.4; // effective track width, in inches
+        double timeConstant = 0.1; // first order lag of the drivetrain, in seconds
+        double leftStrength = 1; // fraction of the commanded speed the left side actually reaches
+        double rightStrength = 1; // fraction of the commanded speed the right side actually reaches
+        std::vector<TrackingWheelParams> trackingWheels {
+            {15, 2.125, -5, false}, {10, 2.125, -4.55, true}, {1, 2.125, 4.55, true}};
+        int imuPort = 21;
+        double imuDrift = 0; // in degrees per second
+        double mechanismTimeConstant = 0.05; // first order lag of every motor that isn't on the drivetrain
+        double wallSlip = 0.3; // fraction of the commanded speed the drive wheels spin at while pushing a wall
+        // rings, picked up by the intake and carried up the conveyor past the optical sensor
+        int conveyorPort = 3;
+        int opticalPort = 4;
+        double intakeReach = 7; // from the tracking center to where the intake picks rings up, in inches
+        double intakeRadius = 4; // how close to that point a ring has to be to be picked up, in inches
+        double sensorTravel = 60; // conveyor travel from picking a ring up to it reaching the optical sensor, in degrees
+        double ringTravel = 120; // conveyor travel while a ring passes the optical sensor, in degrees
+        double topTravel = 200; // conveyor travel from the optical sensor to a ring leaving over the top, in degrees
+};
+
+/**
+ * @brief A ring lying on the field
+ */
+struct FieldRing {
+        double x; // in inches
+        double y; // in inches
+        bool blue;
+};
+
+/**
+ * @brief Pose and velocity of the simulated robot
+ *
+ * Uses the same convention as lemlib, theta is clockwise with 0 facing +y
+ */
+struct PlantState {
+        double x = 0; // in inches
+        double y = 0; // in inches
+        double theta = 0; // in radians
+        double leftVelocity = 0; // in inches per second
+        double rightVelocity = 0; // in inches per second
+};
+
+/**
+ * @brief Kinematic model of a differential drive robot and its mechanisms
+ *
+ * The plant reads motor commands from the simulated devices and writes back motor encoders, tracking wheels and the
+ * imu.
+ */
+class Plant {
+    public:
+        Plant(const PlantParams& params);
+
+        /**
+         * @brief Set the true pose of the robot
+         *
+         * @param x x position, in inches
+         * @param y y position, in inches
+         * @param theta heading, in degrees
+         */
+        void setPose(double x, double y, double theta);
+        /**
+         * @brief Hold the robot in place, as if it were pushing against a wall
+         *
+         * The tracking wheels and imu stop, while the drive wheels slip and keep turning at PlantParams::wallSlip of
+         * their commanded speed
+         *
+         * @param blocked whether the robot is held
+         */
+        void setBlocked(bool blocked) { this->blocked = blocked; }
+        /**
+         * @brief Put a ring on the field
+         *
+         * The intake picks it up if the conveyor runs up while it is in reach, and carries it past the optical
+         * sensor until it leaves over the top. The optical sensor is only driven once a ring has been added
+         *
+         * @param ring the ring
+         */
+        void addRing(const FieldRing& ring) {
+            fieldRings.push_back(ring);
+            ringsAdded = true;
+        }
+
+        /**
+         * @brief Advance the plant
+         *
+         * @param dt time step, in seconds
+         */
+        void step(double dt);
+
+        const PlantState& getState() const { return state; }
+
+        const PlantParams& getParams() const { return params; }
+    private:
+        double commandedSpeed(int port) const;
+        void stepMechanisms(double dt);
+        void stepRings();
+
+        PlantParams params;
+        PlantState state;
+        double time = 0;
+        bool blocked = false;
+
+        struct CarriedRing {
+                double pickup; // conveyor position when it was picked up, in degrees
+                bool blue;
+        };
+
+        std::vector<FieldRing> fieldRings;
+        std::vector<CarriedRing> carriedRings;
+        bool ringsAdded = false;
+};
+} // namespace sim
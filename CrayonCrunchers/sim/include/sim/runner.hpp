@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "sim/plant.hpp"
+
+namespace sim {
+/**
+ * @brief Ways the simulated robot differs from what the robot code believes
+ */
+struct Perturbation {
+        double x = 0; // start pose error, in inches
+        double y = 0; // start pose error, in inches
+        double theta = 0; // start heading error, in degrees
+        double horizontalScale = 1; // true horizontal tracking wheel diameter as a fraction of nominal
+        double vertical1Scale = 1; // true vertical tracking wheel diameter as a fraction of nominal
+        double vertical2Scale = 1; // true second vertical tracking wheel diameter as a fraction of nominal
+        double imuDrift = 0; // in degrees per second
+        double leftStrength = 1; // fraction of the commanded speed the left side reaches
+        double rightStrength = 1; // fraction of the commanded speed the right side reaches
+        int unplugPort = 0; // smart port of a sensor that gets unplugged partway through the run, 0 for none
+        int jamPort = 0; // smart port of a tracking wheel that jams partway through the run, 0 for none
+        double wallTime = 0; // how long the robot is held against a wall from faultTime, in seconds. 0 for never
+        double faultTime = 5; // when the sensor fails or the wall is hit, in seconds after autonomous starts
+};
+
+/**
+ * @brief Settings for a single simulated autonomous run
+ */
+struct TrialConfig {
+        int route = -1; // autonRoute to run, or -1 to use the selection in main.cpp
+        int side = -1; // autonSide to use, or -1 to use the selection in main.cpp
+        int alliance = -1; // 0 for red, 1 for blue, or -1 to use the selection in main.cpp
+        double time = 15; // length of the autonomous period, in seconds
+        const char* trace = nullptr; // csv file to write the true and odom pose to every 10 ms
+        std::vector<FieldRing> rings; // rings on the field for the intake to pick up
+        Perturbation perturbation;
+};
+
+/**
+ * @brief Outcome of a simulated autonomous run
+ */
+struct TrialResult {
+        bool completed = false; // false if initialize() never returned
+        int route = 0; // autonRoute that actually ran
+        double x = 0; // true final pose
+        double y = 0;
+        double theta = 0; // in degrees
+        double odomX = 0; // final pose according to odometry
+        double odomY = 0;
+        double odomTheta = 0; // in degrees
+        int ringsHeld = 0; // rings on the conveyor at the end, according to the ring inventory
+        int ringsScored = 0; // rings scored, according to the ring inventory
+        double simTime = 0; // length of the autonomous period that was simulated, in seconds
+        double wallTime = 0; // time the run took, in milliseconds
+};
+
+/**
+ * @brief Run initialize() then autonomous() on the simulated robot
+ *
+ * The robot code keeps its state in globals, so this can only be called once per process. Run trials in child
+ * processes to run more than one.
+ *
+ * @param config settings for the run
+ * @return TrialResult final pose of the robot
+ */
+TrialResult runTrial(const TrialConfig& config);
+} // namespace sim
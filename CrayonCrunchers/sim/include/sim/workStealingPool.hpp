@@ -0,0 +1,50 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sim {
+/**
+ * @brief Thread pool where idle workers steal jobs from busy ones
+ *
+ * Jobs are dealt out round robin when submitted. Each worker takes jobs from the back of its own queue, and once that
+ * runs dry it steals from the front of the others, so long and short jobs still balance out across every core.
+ */
+class WorkStealingPool {
+    public:
+        /**
+         * @brief Create a new pool
+         *
+         * @param workers number of worker threads. 0 uses one per hardware thread
+         */
+        WorkStealingPool(unsigned workers = 0);
+
+        /**
+         * @brief Queue a job. Jobs must not submit more jobs
+         *
+         * @param job the job
+         */
+        void submit(std::function<void()> job);
+
+        /**
+         * @brief Run every queued job, blocking until all of them are done
+         */
+        void run();
+
+        unsigned getWorkers() const { return queues.size(); }
+    private:
+        struct Queue {
+                std::mutex mutex;
+                std::deque<std::function<void()>> jobs;
+        };
+
+        bool pop(unsigned worker, std::function<void()>& job);
+        bool steal(unsigned thief, std::function<void()>& job);
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        unsigned next = 0;
+};
+} // namespace sim
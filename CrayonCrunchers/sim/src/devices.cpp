@@ -0,0 +1,1050 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include "pros/adi.hpp"
+#include "pros/imu.hpp"
+#include "pros/llemu.hpp"
+#include "pros/misc.hpp"
+#include "pros/motor_group.hpp"
+#include "pros/motors.hpp"
+#include "pros/optical.hpp"
+#include "pros/rotation.hpp"
+#include "sim/devices.hpp"
+#include "sim/kernel.hpp"
+
+namespace sim {
+std::array<MotorState, SMART_PORT_COUNT> motors {};
+std::array<RotationState, SMART_PORT_COUNT> rotations {};
+std::array<ImuState, SMART_PORT_COUNT> imus {};
+std::array<OpticalState, SMART_PORT_COUNT> opticals {};
+std::array<int32_t, ADI_PORT_COUNT> adi {};
+ControllerState controller {};
+uint8_t competitionStatus = COMPETITION_DISABLED;
+bool usdInstalled = false;
+std::array<std::string, 8> lcdLines {};
+
+double maxRpm(int gearing) {
+    switch (gearing) {
+        case 0: return 100;
+        case 2: return 600;
+        default: return 200;
+    }
+}
+} // namespace sim
+
+namespace {
+using namespace pros;
+
+sim::MotorState& motor(std::int8_t port) { return sim::motors.at(std::abs(port)); }
+
+// encoder ticks per degree of the output shaft
+double ticksPerDegree(int gearing) {
+    switch (gearing) {
+        case 0: return 1800.0 / 360;
+        case 2: return 300.0 / 360;
+        default: return 900.0 / 360;
+    }
+}
+
+double toUnits(const sim::MotorState& state, double degrees) {
+    switch (state.units) {
+        case 1: return degrees / 360;
+        case 2: return std::round(degrees * ticksPerDegree(state.gearing));
+        default: return degrees;
+    }
+}
+
+double fromUnits(const sim::MotorState& state, double value) {
+    switch (state.units) {
+        case 1: return value * 360;
+        case 2: return value / ticksPerDegree(state.gearing);
+        default: return value;
+    }
+}
+
+std::int32_t moveVoltage(std::int8_t port, double millivolts) {
+    sim::MotorState& state = motor(port);
+    state.mode = sim::MotorState::Mode::VOLTAGE;
+    state.voltage = std::clamp(millivolts, -12000.0, 12000.0);
+    state.targetVelocity = 0;
+    return 1;
+}
+
+std::int32_t moveVelocity(std::int8_t port, std::int32_t velocity) {
+    sim::MotorState& state = motor(port);
+    state.mode = sim::MotorState::Mode::VELOCITY;
+    state.targetVelocity = velocity;
+    return 1;
+}
+
+std::int32_t moveAbsolute(std::int8_t port, double position, std::int32_t velocity) {
+    sim::MotorState& state = motor(port);
+    state.mode = sim::MotorState::Mode::POSITION;
+    state.targetPosition = fromUnits(state, position) + state.zero;
+    state.profileVelocity = std::abs(velocity);
+    state.targetVelocity = velocity;
+    return 1;
+}
+
+std::int32_t brakeMotor(std::int8_t port) {
+    sim::MotorState& state = motor(port);
+    state.mode = sim::MotorState::Mode::BRAKE;
+    state.targetVelocity = 0;
+    return 1;
+}
+
+template <typename T, typename F> std::vector<T> forAll(const std::vector<std::int8_t>& ports, F&& function) {
+    std::vector<T> out;
+    for (std::int8_t port : ports) out.push_back(function(port));
+    return out;
+}
+} // namespace
+
+namespace pros {
+inline namespace v5 {
+Device::Device(const std::uint8_t port)
+    : _port(port) {}
+
+std::uint8_t Device::get_port(void) const { return _port; }
+
+bool Device::is_installed() { return true; }
+
+/* Motor */
+
+Motor::Motor(const std::int8_t port, const MotorGears gearset, const MotorUnits encoder_units)
+    : Device(std::abs(port), DeviceType::motor),
+      _port(port) {
+    motor(port).connected = true;
+    motor(port).reversed = port < 0;
+    if (gearset != MotorGears::invalid) set_gearing(gearset);
+    if (encoder_units != MotorUnits::invalid) set_encoder_units(encoder_units);
+}
+
+std::int32_t Motor::move(std::int32_t voltage) const { return moveVoltage(_port, voltage * 12000.0 / 127); }
+
+std::int32_t Motor::move_absolute(const double position, const std::int32_t velocity) const {
+    return moveAbsolute(_port, position, velocity);
+}
+
+std::int32_t Motor::move_relative(const double position, const std::int32_t velocity) const {
+    return moveAbsolute(_port, toUnits(motor(_port), motor(_port).targetPosition - motor(_port).zero) + position,
+                        velocity);
+}
+
+std::int32_t Motor::move_velocity(const std::int32_t velocity) const { return moveVelocity(_port, velocity); }
+
+std::int32_t Motor::move_voltage(const std::int32_t voltage) const { return moveVoltage(_port, voltage); }
+
+std::int32_t Motor::brake(void) const { return brakeMotor(_port); }
+
+std::int32_t Motor::modify_profiled_velocity(const std::int32_t velocity) const {
+    motor(_port).profileVelocity = std::abs(velocity);
+    return 1;
+}
+
+double Motor::get_target_position(const std::uint8_t index) const {
+    return toUnits(motor(_port), motor(_port).targetPosition - motor(_port).zero);
+}
+
+std::int32_t Motor::get_target_velocity(const std::uint8_t index) const { return motor(_port).targetVelocity; }
+
+double Motor::get_actual_velocity(const std::uint8_t index) const { return motor(_port).velocity; }
+
+std::int32_t Motor::get_current_draw(const std::uint8_t index) const { return motor(_port).current; }
+
+std::int32_t Motor::get_direction(const std::uint8_t index) const { return motor(_port).velocity < 0 ? -1 : 1; }
+
+double Motor::get_efficiency(const std::uint8_t index) const {
+    const sim::MotorState& state = motor(_port);
+    return state.current < 1 ? 0 : std::min(100.0, std::fabs(state.velocity) / sim::maxRpm(state.gearing) * 100);
+}
+
+std::uint32_t Motor::get_faults(const std::uint8_t index) const { return 0; }
+
+std::uint32_t Motor::get_flags(const std::uint8_t index) const { return 0; }
+
+double Motor::get_position(const std::uint8_t index) const {
+    return toUnits(motor(_port), motor(_port).position - motor(_port).zero);
+}
+
+double Motor::get_power(const std::uint8_t index) const {
+    const sim::MotorState& state = motor(_port);
+    return std::fabs(state.torque * state.velocity * 2 * M_PI / 60);
+}
+
+std::int32_t Motor::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t index) const {
+    if (timestamp != nullptr) *timestamp = c::millis();
+    return std::round(motor(_port).position * ticksPerDegree(motor(_port).gearing));
+}
+
+double Motor::get_temperature(const std::uint8_t index) const { return motor(_port).temperature; }
+
+double Motor::get_torque(const std::uint8_t index) const { return motor(_port).torque; }
+
+std::int32_t Motor::get_voltage(const std::uint8_t index) const {
+    const sim::MotorState& state = motor(_port);
+    if (state.mode == sim::MotorState::Mode::VOLTAGE) return state.voltage;
+    return state.velocity / sim::maxRpm(state.gearing) * 12000;
+}
+
+std::int32_t Motor::is_over_current(const std::uint8_t index) const {
+    return motor(_port).current >= motor(_port).currentLimit;
+}
+
+std::int32_t Motor::is_over_temp(const std::uint8_t index) const { return motor(_port).temperature >= 55; }
+
+MotorBrake Motor::get_brake_mode(const std::uint8_t index) const {
+    return static_cast<MotorBrake>(motor(_port).brakeMode);
+}
+
+std::int32_t Motor::get_current_limit(const std::uint8_t index) const { return motor(_port).currentLimit; }
+
+MotorUnits Motor::get_encoder_units(const std::uint8_t index) const {
+    return static_cast<MotorUnits>(motor(_port).units);
+}
+
+MotorGears Motor::get_gearing(const std::uint8_t index) const { return static_cast<MotorGears>(motor(_port).gearing); }
+
+std::int32_t Motor::get_voltage_limit(const std::uint8_t index) const { return motor(_port).voltageLimit; }
+
+std::int32_t Motor::is_reversed(const std::uint8_t index) const { return _port < 0; }
+
+std::int32_t Motor::set_brake_mode(const MotorBrake mode, const std::uint8_t index) const {
+    motor(_port).brakeMode = static_cast<int>(mode);
+    return 1;
+}
+
+std::int32_t Motor::set_brake_mode(const motor_brake_mode_e_t mode, const std::uint8_t index) const {
+    motor(_port).brakeMode = mode;
+    return 1;
+}
+
+std::int32_t Motor::set_current_limit(const std::int32_t limit, const std::uint8_t index) const {
+    motor(_port).currentLimit = limit;
+    return 1;
+}
+
+std::int32_t Motor::set_encoder_units(const MotorUnits units, const std::uint8_t index) const {
+    motor(_port).units = static_cast<int>(units);
+    return 1;
+}
+
+std::int32_t Motor::set_encoder_units(const motor_encoder_units_e_t units, const std::uint8_t index) const {
+    motor(_port).units = units;
+    return 1;
+}
+
+std::int32_t Motor::set_gearing(const MotorGears gearset, const std::uint8_t index) const {
+    motor(_port).gearing = static_cast<int>(gearset);
+    return 1;
+}
+
+std::int32_t Motor::set_gearing(const motor_gearset_e_t gearset, const std::uint8_t index) const {
+    motor(_port).gearing = gearset;
+    return 1;
+}
+
+std::int32_t Motor::set_reversed(const bool reverse, const std::uint8_t index) {
+    _port = reverse ? -std::abs(_port) : std::abs(_port);
+    motor(_port).reversed = reverse;
+    return 1;
+}
+
+std::int32_t Motor::set_voltage_limit(const std::int32_t limit, const std::uint8_t index) const {
+    motor(_port).voltageLimit = limit;
+    return 1;
+}
+
+std::int32_t Motor::set_zero_position(const double position, const std::uint8_t index) const {
+    sim::MotorState& state = motor(_port);
+    state.zero = state.position - fromUnits(state, position);
+    return 1;
+}
+
+std::int32_t Motor::tare_position(const std::uint8_t index) const { return set_zero_position(0); }
+
+std::int8_t Motor::size(void) const { return 1; }
+
+std::int8_t Motor::get_port(const std::uint8_t index) const { return _port; }
+
+std::vector<double> Motor::get_target_position_all(void) const { return {get_target_position()}; }
+
+std::vector<std::int32_t> Motor::get_target_velocity_all(void) const { return {get_target_velocity()}; }
+
+std::vector<double> Motor::get_actual_velocity_all(void) const { return {get_actual_velocity()}; }
+
+std::vector<std::int32_t> Motor::get_current_draw_all(void) const { return {get_current_draw()}; }
+
+std::vector<std::int32_t> Motor::get_direction_all(void) const { return {get_direction()}; }
+
+std::vector<double> Motor::get_efficiency_all(void) const { return {get_efficiency()}; }
+
+std::vector<std::uint32_t> Motor::get_faults_all(void) const { return {get_faults()}; }
+
+std::vector<std::uint32_t> Motor::get_flags_all(void) const { return {get_flags()}; }
+
+std::vector<double> Motor::get_position_all(void) const { return {get_position()}; }
+
+std::vector<double> Motor::get_power_all(void) const { return {get_power()}; }
+
+std::vector<std::int32_t> Motor::get_raw_position_all(std::uint32_t* const timestamp) const {
+    return {get_raw_position(timestamp)};
+}
+
+std::vector<double> Motor::get_temperature_all(void) const { return {get_temperature()}; }
+
+std::vector<double> Motor::get_torque_all(void) const { return {get_torque()}; }
+
+std::vector<std::int32_t> Motor::get_voltage_all(void) const { return {get_voltage()}; }
+
+std::vector<std::int32_t> Motor::is_over_current_all(void) const { return {is_over_current()}; }
+
+std::vector<std::int32_t> Motor::is_over_temp_all(void) const { return {is_over_temp()}; }
+
+std::vector<MotorBrake> Motor::get_brake_mode_all(void) const { return {get_brake_mode()}; }
+
+std::vector<std::int32_t> Motor::get_current_limit_all(void) const { return {get_current_limit()}; }
+
+std::vector<MotorUnits> Motor::get_encoder_units_all(void) const { return {get_encoder_units()}; }
+
+std::vector<MotorGears> Motor::get_gearing_all(void) const { return {get_gearing()}; }
+
+std::vector<std::int8_t> Motor::get_port_all(void) const { return {_port}; }
+
+std::vector<std::int32_t> Motor::get_voltage_limit_all(void) const { return {get_voltage_limit()}; }
+
+std::vector<std::int32_t> Motor::is_reversed_all(void) const { return {is_reversed()}; }
+
+std::int32_t Motor::set_brake_mode_all(const MotorBrake mode) const { return set_brake_mode(mode); }
+
+std::int32_t Motor::set_brake_mode_all(const motor_brake_mode_e_t mode) const { return set_brake_mode(mode); }
+
+std::int32_t Motor::set_current_limit_all(const std::int32_t limit) const { return set_current_limit(limit); }
+
+std::int32_t Motor::set_encoder_units_all(const MotorUnits units) const { return set_encoder_units(units); }
+
+std::int32_t Motor::set_encoder_units_all(const motor_encoder_units_e_t units) const {
+    return set_encoder_units(units);
+}
+
+std::int32_t Motor::set_gearing_all(const MotorGears gearset) const { return set_gearing(gearset); }
+
+std::int32_t Motor::set_gearing_all(const motor_gearset_e_t gearset) const { return set_gearing(gearset); }
+
+std::int32_t Motor::set_reversed_all(const bool reverse) { return set_reversed(reverse); }
+
+std::int32_t Motor::set_voltage_limit_all(const std::int32_t limit) const { return set_voltage_limit(limit); }
+
+std::int32_t Motor::set_zero_position_all(const double position) const { return set_zero_position(position); }
+
+std::int32_t Motor::tare_position_all(void) const { return tare_position(); }
+
+/* MotorGroup */
+
+MotorGroup::MotorGroup(const std::initializer_list<std::int8_t> ports, const MotorGears gearset,
+                       const MotorUnits encoder_units)
+    : MotorGroup(std::vector<std::int8_t>(ports), gearset, encoder_units) {}
+
+MotorGroup::MotorGroup(const std::vector<std::int8_t>& ports, const MotorGears gearset, const MotorUnits encoder_units)
+    : _ports(ports) {
+    for (std::int8_t port : _ports) Motor(port, gearset, encoder_units);
+}
+
+std::int32_t MotorGroup::move(std::int32_t voltage) const {
+    for (std::int8_t port : _ports) Motor(port).move(voltage);
+    return 1;
+}
+
+std::int32_t MotorGroup::move_absolute(const double position, const std::int32_t velocity) const {
+    for (std::int8_t port : _ports) Motor(port).move_absolute(position, velocity);
+    return 1;
+}
+
+std::int32_t MotorGroup::move_relative(const double position, const std::int32_t velocity) const {
+    for (std::int8_t port : _ports) Motor(port).move_relative(position, velocity);
+    return 1;
+}
+
+std::int32_t MotorGroup::move_velocity(const std::int32_t velocity) const {
+    for (std::int8_t port : _ports) Motor(port).move_velocity(velocity);
+    return 1;
+}
+
+std::int32_t MotorGroup::move_voltage(const std::int32_t voltage) const {
+    for (std::int8_t port : _ports) Motor(port).move_voltage(voltage);
+    return 1;
+}
+
+std::int32_t MotorGroup::brake(void) const {
+    for (std::int8_t port : _ports) Motor(port).brake();
+    return 1;
+}
+
+std::int32_t MotorGroup::modify_profiled_velocity(const std::int32_t velocity) const {
+    for (std::int8_t port : _ports) Motor(port).modify_profiled_velocity(velocity);
+    return 1;
+}
+
+double MotorGroup::get_target_position(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_target_position();
+}
+
+std::int32_t MotorGroup::get_target_velocity(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_target_velocity();
+}
+
+double MotorGroup::get_actual_velocity(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_actual_velocity();
+}
+
+std::int32_t MotorGroup::get_current_draw(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_current_draw();
+}
+
+std::int32_t MotorGroup::get_direction(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_direction();
+}
+
+double MotorGroup::get_efficiency(const std::uint8_t index) const { return Motor(_ports.at(index)).get_efficiency(); }
+
+std::uint32_t MotorGroup::get_faults(const std::uint8_t index) const { return Motor(_ports.at(index)).get_faults(); }
+
+std::uint32_t MotorGroup::get_flags(const std::uint8_t index) const { return Motor(_ports.at(index)).get_flags(); }
+
+double MotorGroup::get_position(const std::uint8_t index) const { return Motor(_ports.at(index)).get_position(); }
+
+double MotorGroup::get_power(const std::uint8_t index) const { return Motor(_ports.at(index)).get_power(); }
+
+std::int32_t MotorGroup::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_raw_position(timestamp);
+}
+
+double MotorGroup::get_temperature(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_temperature();
+}
+
+double MotorGroup::get_torque(const std::uint8_t index) const { return Motor(_ports.at(index)).get_torque(); }
+
+std::int32_t MotorGroup::get_voltage(const std::uint8_t index) const { return Motor(_ports.at(index)).get_voltage(); }
+
+std::int32_t MotorGroup::is_over_current(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).is_over_current();
+}
+
+std::int32_t MotorGroup::is_over_temp(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).is_over_temp();
+}
+
+MotorBrake MotorGroup::get_brake_mode(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_brake_mode();
+}
+
+std::int32_t MotorGroup::get_current_limit(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_current_limit();
+}
+
+MotorUnits MotorGroup::get_encoder_units(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_encoder_units();
+}
+
+MotorGears MotorGroup::get_gearing(const std::uint8_t index) const { return Motor(_ports.at(index)).get_gearing(); }
+
+std::int32_t MotorGroup::get_voltage_limit(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).get_voltage_limit();
+}
+
+std::int32_t MotorGroup::is_reversed(const std::uint8_t index) const { return _ports.at(index) < 0; }
+
+std::int32_t MotorGroup::set_brake_mode(const MotorBrake mode, const std::uint8_t index) const {
+    return Motor(_ports.at(index)).set_brake_mode(mode);
+}
+
+std::int32_t MotorGroup::set_brake_mode(const motor_brake_mode_e_t mode, const std::uint8_t index) const {
+    return Motor(_ports.at(index)).set_brake_mode(mode);
+}
+
+std::int32_t MotorGroup::set_current_limit(const std::int32_t limit, const std::uint8_t index) const {
+    return Motor(_ports.at(index)).set_current_limit(limit);
+}
+
+std::int32_t MotorGroup::set_encoder_units(const MotorUnits units, const std::uint8_t index) const {
+    return Motor(_ports.at(index)).set_encoder_units(units);
+}
+
+std::int32_t MotorGroup::set_encoder_units(const motor_encoder_units_e_t units, const std::uint8_t index) const {
+    return Motor(_ports.at(index)).set_encoder_units(units);
+}
+
+std::int32_t MotorGroup::set_gearing(const MotorGears gearset, const std::uint8_t index) const {
+    return Motor(_ports.at(index)).set_gearing(gearset);
+}
+
+std::int32_t MotorGroup::set_gearing(const motor_gearset_e_t gearset, const std::uint8_t index) const {
+    return Motor(_ports.at(index)).set_gearing(gearset);
+}
+
+std::int32_t MotorGroup::set_reversed(const bool reverse, const std::uint8_t index) {
+    _ports.at(index) = reverse ? -std::abs(_ports.at(index)) : std::abs(_ports.at(index));
+    return 1;
+}
+
+std::int32_t MotorGroup::set_voltage_limit(const std::int32_t limit, const std::uint8_t index) const {
+    return Motor(_ports.at(index)).set_voltage_limit(limit);
+}
+
+std::int32_t MotorGroup::set_zero_position(const double position, const std::uint8_t index) const {
+    return Motor(_ports.at(index)).set_zero_position(position);
+}
+
+std::int32_t MotorGroup::tare_position(const std::uint8_t index) const {
+    return Motor(_ports.at(index)).tare_position();
+}
+
+std::int8_t MotorGroup::size(void) const { return _ports.size(); }
+
+std::int8_t MotorGroup::get_port(const std::uint8_t index) const { return _ports.at(index); }
+
+std::vector<double> MotorGroup::get_target_position_all(void) const {
+    return forAll<double>(_ports, [](std::int8_t port) { return Motor(port).get_target_position(); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_target_velocity_all(void) const {
+    return forAll<std::int32_t>(_ports, [](std::int8_t port) { return Motor(port).get_target_velocity(); });
+}
+
+std::vector<double> MotorGroup::get_actual_velocity_all(void) const {
+    return forAll<double>(_ports, [](std::int8_t port) { return Motor(port).get_actual_velocity(); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_draw_all(void) const {
+    return forAll<std::int32_t>(_ports, [](std::int8_t port) { return Motor(port).get_current_draw(); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_direction_all(void) const {
+    return forAll<std::int32_t>(_ports, [](std::int8_t port) { return Motor(port).get_direction(); });
+}
+
+std::vector<double> MotorGroup::get_efficiency_all(void) const {
+    return forAll<double>(_ports, [](std::int8_t port) { return Motor(port).get_efficiency(); });
+}
+
+std::vector<std::uint32_t> MotorGroup::get_faults_all(void) const {
+    return forAll<std::uint32_t>(_ports, [](std::int8_t port) { return Motor(port).get_faults(); });
+}
+
+std::vector<std::uint32_t> MotorGroup::get_flags_all(void) const {
+    return forAll<std::uint32_t>(_ports, [](std::int8_t port) { return Motor(port).get_flags(); });
+}
+
+std::vector<double> MotorGroup::get_position_all(void) const {
+    return forAll<double>(_ports, [](std::int8_t port) { return Motor(port).get_position(); });
+}
+
+std::vector<double> MotorGroup::get_power_all(void) const {
+    return forAll<double>(_ports, [](std::int8_t port) { return Motor(port).get_power(); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_raw_position_all(std::uint32_t* const timestamp) const {
+    return forAll<std::int32_t>(_ports, [&](std::int8_t port) { return Motor(port).get_raw_position(timestamp); });
+}
+
+std::vector<double> MotorGroup::get_temperature_all(void) const {
+    return forAll<double>(_ports, [](std::int8_t port) { return Motor(port).get_temperature(); });
+}
+
+std::vector<double> MotorGroup::get_torque_all(void) const {
+    return forAll<double>(_ports, [](std::int8_t port) { return Motor(port).get_torque(); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_voltage_all(void) const {
+    return forAll<std::int32_t>(_ports, [](std::int8_t port) { return Motor(port).get_voltage(); });
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_current_all(void) const {
+    return forAll<std::int32_t>(_ports, [](std::int8_t port) { return Motor(port).is_over_current(); });
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_temp_all(void) const {
+    return forAll<std::int32_t>(_ports, [](std::int8_t port) { return Motor(port).is_over_temp(); });
+}
+
+std::vector<MotorBrake> MotorGroup::get_brake_mode_all(void) const {
+    return forAll<MotorBrake>(_ports, [](std::int8_t port) { return Motor(port).get_brake_mode(); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_limit_all(void) const {
+    return forAll<std::int32_t>(_ports, [](std::int8_t port) { return Motor(port).get_current_limit(); });
+}
+
+std::vector<MotorUnits> MotorGroup::get_encoder_units_all(void) const {
+    return forAll<MotorUnits>(_ports, [](std::int8_t port) { return Motor(port).get_encoder_units(); });
+}
+
+std::vector<MotorGears> MotorGroup::get_gearing_all(void) const {
+    return forAll<MotorGears>(_ports, [](std::int8_t port) { return Motor(port).get_gearing(); });
+}
+
+std::vector<std::int8_t> MotorGroup::get_port_all(void) const { return _ports; }
+
+std::vector<std::int32_t> MotorGroup::get_voltage_limit_all(void) const {
+    return forAll<std::int32_t>(_ports, [](std::int8_t port) { return Motor(port).get_voltage_limit(); });
+}
+
+std::vector<std::int32_t> MotorGroup::is_reversed_all(void) const {
+    return forAll<std::int32_t>(_ports, [](std::int8_t port) { return std::int32_t(port < 0); });
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const MotorBrake mode) const {
+    for (std::int8_t port : _ports) Motor(port).set_brake_mode(mode);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const motor_brake_mode_e_t mode) const {
+    for (std::int8_t port : _ports) Motor(port).set_brake_mode(mode);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_current_limit_all(const std::int32_t limit) const {
+    for (std::int8_t port : _ports) Motor(port).set_current_limit(limit);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const MotorUnits units) const {
+    for (std::int8_t port : _ports) Motor(port).set_encoder_units(units);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const motor_encoder_units_e_t units) const {
+    for (std::int8_t port : _ports) Motor(port).set_encoder_units(units);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_gearing_all(const MotorGears gearset) const {
+    for (std::int8_t port : _ports) Motor(port).set_gearing(gearset);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_gearing_all(const motor_gearset_e_t gearset) const {
+    for (std::int8_t port : _ports) Motor(port).set_gearing(gearset);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_reversed_all(const bool reverse) {
+    for (std::int8_t& port : _ports) port = reverse ? -std::abs(port) : std::abs(port);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_voltage_limit_all(const std::int32_t limit) const {
+    for (std::int8_t port : _ports) Motor(port).set_voltage_limit(limit);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_zero_position_all(const double position) const {
+    for (std::int8_t port : _ports) Motor(port).set_zero_position(position);
+    return 1;
+}
+
+std::int32_t MotorGroup::tare_position_all(void) const {
+    for (std::int8_t port : _ports) Motor(port).tare_position();
+    return 1;
+}
+
+/* Rotation */
+
+Rotation::Rotation(const std::int8_t port)
+    : Device(std::abs(port), DeviceType::rotation) {
+    sim::rotations.at(_port).connected = true;
+    sim::rotations.at(_port).reversed = port < 0;
+}
+
+std::int32_t Rotation::reset() {
+    sim::rotations.at(_port).position = 0;
+    return 1;
+}
+
+std::int32_t Rotation::set_data_rate(std::uint32_t rate) const { return 1; }
+
+std::int32_t Rotation::set_position(std::uint32_t position) const {
+    sim::rotations.at(_port).position = std::int32_t(position);
+    return 1;
+}
+
+std::int32_t Rotation::reset_position(void) const {
+    sim::rotations.at(_port).position = 0;
+    return 1;
+}
+
+namespace {
+// reading an unplugged sensor fails, like on the brain
+bool rotationConnected(std::uint8_t port) {
+    if (sim::rotations.at(port).connected) return true;
+    errno = ENODEV;
+    return false;
+}
+} // namespace
+
+std::int32_t Rotation::get_position() const {
+    if (!rotationConnected(_port)) return PROS_ERR;
+    return std::round(sim::rotations.at(_port).position);
+}
+
+std::int32_t Rotation::get_velocity() const {
+    if (!rotationConnected(_port)) return PROS_ERR;
+    return std::round(sim::rotations.at(_port).velocity);
+}
+
+std::int32_t Rotation::get_angle() const {
+    if (!rotationConnected(_port)) return PROS_ERR;
+    const double angle = std::fmod(sim::rotations.at(_port).position, 36000);
+    return std::round(angle < 0 ? angle + 36000 : angle);
+}
+
+std::int32_t Rotation::set_reversed(bool value) const {
+    sim::rotations.at(_port).reversed = value;
+    return 1;
+}
+
+std::int32_t Rotation::reverse() const { return set_reversed(!sim::rotations.at(_port).reversed); }
+
+std::int32_t Rotation::get_reversed() const { return sim::rotations.at(_port).reversed; }
+
+/* Imu */
+
+namespace {
+// reading the imu while it calibrates or once it's unplugged returns PROS_ERR_F, like on the brain
+bool imuReady(std::uint8_t port) {
+    return sim::imus.at(port).connected && c::millis() >= sim::imus.at(port).calibratedAt;
+}
+
+double imuRotation(std::uint8_t port) {
+    return imuReady(port) ? sim::imus.at(port).rotation - sim::imus.at(port).offset : PROS_ERR_F;
+}
+} // namespace
+
+std::int32_t Imu::reset(bool blocking) const {
+    sim::ImuState& state = sim::imus.at(_port);
+    state.connected = true;
+    state.calibratedAt = c::millis() + 2000;
+    state.offset = state.rotation;
+    if (blocking) c::delay(2000);
+    return 1;
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t rate) const { return 1; }
+
+double Imu::get_rotation() const { return imuRotation(_port); }
+
+double Imu::get_heading() const {
+    if (!imuReady(_port)) return PROS_ERR_F;
+    const double heading = std::fmod(imuRotation(_port), 360);
+    return heading < 0 ? heading + 360 : heading;
+}
+
+quaternion_s_t Imu::get_quaternion() const {
+    const double yaw = -get_yaw() * M_PI / 180;
+    return {0, 0, std::sin(yaw / 2), std::cos(yaw / 2)};
+}
+
+euler_s_t Imu::get_euler() const { return {get_pitch(), get_roll(), get_yaw()}; }
+
+double Imu::get_pitch() const { return sim::imus.at(_port).pitch; }
+
+double Imu::get_roll() const { return sim::imus.at(_port).roll; }
+
+double Imu::get_yaw() const { return std::remainder(imuRotation(_port), 360); }
+
+imu_gyro_s_t Imu::get_gyro_rate() const { return {0, 0, sim::imus.at(_port).gyroRate}; }
+
+std::int32_t Imu::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t Imu::tare_heading() const { return set_heading(0); }
+
+std::int32_t Imu::tare_pitch() const { return set_pitch(0); }
+
+std::int32_t Imu::tare_yaw() const { return set_yaw(0); }
+
+std::int32_t Imu::tare_roll() const { return set_roll(0); }
+
+std::int32_t Imu::tare() const { return tare_rotation(); }
+
+std::int32_t Imu::tare_euler() const { return tare_rotation(); }
+
+std::int32_t Imu::set_heading(const double target) const { return set_rotation(target); }
+
+std::int32_t Imu::set_rotation(const double target) const {
+    sim::imus.at(_port).offset = sim::imus.at(_port).rotation - target;
+    return 1;
+}
+
+std::int32_t Imu::set_yaw(const double target) const { return set_rotation(target); }
+
+std::int32_t Imu::set_pitch(const double target) const {
+    sim::imus.at(_port).pitch = target;
+    return 1;
+}
+
+std::int32_t Imu::set_roll(const double target) const {
+    sim::imus.at(_port).roll = target;
+    return 1;
+}
+
+std::int32_t Imu::set_euler(const euler_s_t target) const { return set_rotation(target.yaw); }
+
+imu_accel_s_t Imu::get_accel() const { return {0, 0, 1}; }
+
+ImuStatus Imu::get_status() const {
+    if (!sim::imus.at(_port).connected) return ImuStatus::error;
+    return imuReady(_port) ? ImuStatus::ready : ImuStatus::calibrating;
+}
+
+bool Imu::is_calibrating() const { return sim::imus.at(_port).connected && !imuReady(_port); }
+
+imu_orientation_e_t Imu::get_physical_orientation() const { return E_IMU_Z_UP; }
+
+/* Optical */
+
+Optical::Optical(const std::uint8_t port)
+    : Device(port, DeviceType::optical) {
+    sim::opticals.at(_port).connected = true;
+}
+
+double Optical::get_hue() { return sim::opticals.at(_port).hue; }
+
+double Optical::get_saturation() { return sim::opticals.at(_port).saturation; }
+
+double Optical::get_brightness() { return sim::opticals.at(_port).brightness; }
+
+std::int32_t Optical::get_proximity() { return sim::opticals.at(_port).proximity; }
+
+std::int32_t Optical::set_led_pwm(uint8_t value) {
+    sim::opticals.at(_port).ledPwm = value;
+    return 1;
+}
+
+std::int32_t Optical::get_led_pwm() { return sim::opticals.at(_port).ledPwm; }
+
+c::optical_rgb_s_t Optical::get_rgb() {
+    // the color the hue, saturation and brightness describe
+    const sim::OpticalState& state = sim::opticals.at(_port);
+    const double hue = std::fmod(state.hue, 360) / 60;
+    const double chroma = state.brightness * state.saturation;
+    const double x = chroma * (1 - std::fabs(std::fmod(hue, 2) - 1));
+    const double base = state.brightness - chroma;
+    std::array<double, 3> rgb {};
+    switch (int(hue)) {
+        case 0: rgb = {chroma, x, 0}; break;
+        case 1: rgb = {x, chroma, 0}; break;
+        case 2: rgb = {0, chroma, x}; break;
+        case 3: rgb = {0, x, chroma}; break;
+        case 4: rgb = {x, 0, chroma}; break;
+        default: rgb = {chroma, 0, x}; break;
+    }
+    return {(rgb[0] + base) * 255, (rgb[1] + base) * 255, (rgb[2] + base) * 255, state.brightness};
+}
+
+c::optical_raw_s_t Optical::get_raw() { return {0, 0, 0, 0}; }
+
+c::optical_direction_e_t Optical::get_gesture() { return c::NO_GESTURE; }
+
+c::optical_gesture_s_t Optical::get_gesture_raw() { return {}; }
+
+std::int32_t Optical::enable_gesture() { return 1; }
+
+std::int32_t Optical::disable_gesture() { return 1; }
+
+double Optical::get_integration_time() { return sim::opticals.at(_port).integrationTime; }
+
+std::int32_t Optical::set_integration_time(double time) {
+    sim::opticals.at(_port).integrationTime = std::clamp(time, 3.0, 712.0);
+    return 1;
+}
+} // namespace v5
+
+/* Controller */
+
+Controller::Controller(controller_id_e_t id)
+    : _id(id) {}
+
+std::int32_t Controller::is_connected(void) { return 1; }
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) { return sim::controller.analog.at(channel); }
+
+std::int32_t Controller::get_battery_capacity(void) { return 100; }
+
+std::int32_t Controller::get_battery_level(void) { return 100; }
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) {
+    return sim::controller.digital.at(button - E_CONTROLLER_DIGITAL_L1);
+}
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+    const int index = button - E_CONTROLLER_DIGITAL_L1;
+    const bool pressed = sim::controller.digital.at(index);
+    const bool newPress = pressed && !sim::controller.pressedLastRead.at(index);
+    sim::controller.pressedLastRead.at(index) = pressed;
+    return newPress;
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str) {
+    sim::controller.text.at(line) = str;
+    return 1;
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string& str) {
+    return set_text(line, col, str.c_str());
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) {
+    sim::controller.text.at(line).clear();
+    return 1;
+}
+
+std::int32_t Controller::rumble(const char* rumble_pattern) { return c::controller_rumble(_id, rumble_pattern); }
+
+std::int32_t Controller::clear(void) {
+    for (std::string& line : sim::controller.text) line.clear();
+    return 1;
+}
+
+namespace competition {
+std::uint8_t get_status(void) { return sim::competitionStatus; }
+
+std::uint8_t is_autonomous(void) { return (sim::competitionStatus & COMPETITION_AUTONOMOUS) != 0; }
+
+std::uint8_t is_connected(void) { return (sim::competitionStatus & COMPETITION_CONNECTED) != 0; }
+
+std::uint8_t is_disabled(void) { return (sim::competitionStatus & COMPETITION_DISABLED) != 0; }
+
+std::uint8_t is_field_control(void) { return 0; }
+
+std::uint8_t is_competition_switch(void) { return 0; }
+} // namespace competition
+
+namespace battery {
+double get_capacity(void) { return 100; }
+
+int32_t get_current(void) { return 0; }
+
+double get_temperature(void) { return 25; }
+
+int32_t get_voltage(void) { return 12800; }
+} // namespace battery
+
+namespace usd {
+std::int32_t is_installed(void) { return sim::usdInstalled; }
+} // namespace usd
+
+/* ADI */
+
+namespace adi {
+namespace {
+std::uint8_t normalizeAdiPort(std::uint8_t port) {
+    if (port >= 'a' && port <= 'h') return port - 'a' + 1;
+    if (port >= 'A' && port <= 'H') return port - 'A' + 1;
+    return port;
+}
+} // namespace
+
+Port::Port(std::uint8_t adi_port, adi_port_config_e_t type)
+    : _smart_port(INTERNAL_ADI_PORT),
+      _adi_port(normalizeAdiPort(adi_port)) {}
+
+std::int32_t Port::get_config() const { return E_ADI_TYPE_UNDEFINED; }
+
+std::int32_t Port::get_value() const { return sim::adi.at(_adi_port - 1); }
+
+std::int32_t Port::set_config(adi_port_config_e_t type) const { return 1; }
+
+std::int32_t Port::set_value(std::int32_t value) const {
+    sim::adi.at(_adi_port - 1) = value;
+    return 1;
+}
+
+ext_adi_port_tuple_t Port::get_port() const { return {_smart_port, _adi_port, 0}; }
+
+DigitalOut::DigitalOut(std::uint8_t adi_port, bool init_state)
+    : Port(adi_port, E_ADI_DIGITAL_OUT) {
+    set_value(init_state);
+}
+
+// legacy encoders read from the first port of their pair
+std::int32_t Encoder::reset() const { return Port::set_value(0); }
+
+std::int32_t Encoder::get_value() const { return Port::get_value(); }
+} // namespace adi
+
+/* LLEMU */
+
+namespace lcd {
+namespace {
+std::array<lcd_btn_cb_fn_t, 3> buttonCallbacks {};
+} // namespace
+
+bool is_initialized(void) { return true; }
+
+bool initialize(void) { return true; }
+
+bool shutdown(void) { return true; }
+
+bool set_text(std::int16_t line, std::string text) { return c::lcd_set_text(line, text.c_str()); }
+
+bool clear(void) { return c::lcd_clear(); }
+
+bool clear_line(std::int16_t line) { return c::lcd_clear_line(line); }
+
+void register_btn0_cb(lcd_btn_cb_fn_t cb) { buttonCallbacks[0] = cb; }
+
+void register_btn1_cb(lcd_btn_cb_fn_t cb) { buttonCallbacks[1] = cb; }
+
+void register_btn2_cb(lcd_btn_cb_fn_t cb) { buttonCallbacks[2] = cb; }
+
+void set_text_align(Text_Align alignment) {}
+
+std::uint8_t read_buttons(void) { return 0; }
+} // namespace lcd
+} // namespace pros
+
+namespace pros::c {
+bool lcd_print(int16_t line, const char* fmt, ...) {
+    char text[64];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    return lcd_set_text(line, text);
+}
+
+bool lcd_set_text(int16_t line, const char* text) {
+    if (line < 0 || line >= int16_t(sim::lcdLines.size())) return false;
+    sim::lcdLines.at(line) = text;
+    return true;
+}
+
+bool lcd_clear(void) {
+    for (std::string& line : sim::lcdLines) line.clear();
+    return true;
+}
+
+bool lcd_clear_line(int16_t line) { return lcd_set_text(line, ""); }
+
+int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) {
+    if (line >= sim::controller.text.size()) return PROS_ERR;
+    char text[32];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    sim::controller.text.at(line) = text;
+    return 1;
+}
+
+int32_t controller_rumble(controller_id_e_t id, const char* rumble_pattern) {
+    sim::controller.rumble = rumble_pattern;
+    return 1;
+}
+
+uint8_t competition_get_status(void) { return sim::competitionStatus; }
+} // namespace pros::c
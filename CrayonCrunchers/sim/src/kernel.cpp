@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "sim/kernel.hpp"
+
+namespace sim {
+// host code needs a lot more stack than the brain, fmt in particular
+constexpr size_t STACK_SIZE = 256 * 1024;
+
+Kernel& Kernel::get() {
+    static Kernel kernel;
+    return kernel;
+}
+
+void Kernel::setTickHook(std::function<void(uint64_t)> hook) { tickHook = hook; }
+
+void Kernel::shutdown() { stopped = true; }
+
+Task* Kernel::createTask(void (*function)(void*), void* parameters, uint32_t priority, const char* name) {
+    if (stopped) return nullptr;
+    Task* task = new Task();
+    task->function = function;
+    task->parameters = parameters;
+    task->priority = priority;
+    task->name = name == nullptr ? "" : name;
+    task->stack = std::malloc(STACK_SIZE);
+    getcontext(&task->context);
+    task->context.uc_stack.ss_sp = task->stack;
+    task->context.uc_stack.ss_size = STACK_SIZE;
+    task->context.uc_link = nullptr;
+    makecontext(&task->context, taskEntry, 0);
+    tasks.push_back(task);
+    makeReady(task);
+    return task;
+}
+
+void Kernel::taskEntry() {
+    Kernel& kernel = get();
+    Task* task = kernel.running;
+    task->function(task->parameters);
+    // returning from the task function deletes the task, like on the brain
+    kernel.deleteTask(task);
+}
+
+void Kernel::deleteTask(Task* task) {
+    if (stopped) return;
+    if (task == nullptr) task = running;
+    if (task == nullptr || !isValid(task) || task->state == Task::State::DELETED) return;
+    // unlink the task from everything it could be waiting on
+    readyQueue.erase(std::remove(readyQueue.begin(), readyQueue.end(), task), readyQueue.end());
+    if (task->waitingMutex != nullptr) {
+        std::deque<Task*>& waiters = task->waitingMutex->waiters;
+        waiters.erase(std::remove(waiters.begin(), waiters.end(), task), waiters.end());
+        task->waitingMutex = nullptr;
+    }
+    task->state = Task::State::DELETED;
+    for (Task* joiner : task->joiners) makeReady(joiner);
+    task->joiners.clear();
+    // the stack of the running task is freed by the scheduler once it has switched away from it
+    if (task == running) {
+        switchToScheduler();
+        return;
+    }
+    std::free(task->stack);
+    task->stack = nullptr;
+}
+
+void Kernel::suspendTask(Task* task) {
+    if (stopped) return;
+    if (task == nullptr) task = running;
+    if (task == nullptr || !isValid(task) || task->state == Task::State::DELETED) return;
+    readyQueue.erase(std::remove(readyQueue.begin(), readyQueue.end(), task), readyQueue.end());
+    task->state = Task::State::SUSPENDED;
+    if (task == running) switchToScheduler();
+}
+
+void Kernel::resumeTask(Task* task) {
+    if (stopped || task == nullptr || !isValid(task)) return;
+    if (task->state == Task::State::SUSPENDED) makeReady(task);
+}
+
+void Kernel::delay(uint64_t micros) {
+    if (stopped || running == nullptr) return;
+    if (micros == 0) {
+        // yield to other ready tasks
+        makeReady(running);
+        switchToScheduler();
+        return;
+    }
+    block(time + micros);
+}
+
+void Kernel::delayUntil(uint64_t wakeMicros) {
+    if (stopped || running == nullptr) return;
+    if (wakeMicros <= time) delay(0);
+    else block(wakeMicros);
+}
+
+void Kernel::join(Task* task) {
+    if (stopped || running == nullptr || task == running) return;
+    if (task == nullptr || !isValid(task) || task->state == Task::State::DELETED) return;
+    task->joiners.push_back(running);
+    block(UINT64_MAX);
+}
+
+uint32_t Kernel::notify(Task* task, uint32_t value, int action, uint32_t* prevValue) {
+    if (stopped || task == nullptr || !isValid(task) || task->state == Task::State::DELETED) return 0;
+    if (prevValue != nullptr) *prevValue = task->notifyValue;
+    // actions match notify_action_e_t
+    switch (action) {
+        case 1: task->notifyValue |= value; break;
+        case 2: task->notifyValue++; break;
+        case 3: task->notifyValue = value; break;
+        case 4:
+            if (task->notifyPending) return 0;
+            task->notifyValue = value;
+            break;
+        default: break;
+    }
+    task->notifyPending = true;
+    if (task->waitingForNotify && task->state == Task::State::BLOCKED) {
+        task->waitingForNotify = false;
+        makeReady(task);
+    }
+    return 1;
+}
+
+uint32_t Kernel::notifyTake(bool clearOnExit, uint32_t timeout) {
+    if (stopped || running == nullptr) return 0;
+    Task* task = running;
+    if (task->notifyValue == 0 && timeout != 0) {
+        task->waitingForNotify = true;
+        block(timeout == UINT32_MAX ? UINT64_MAX : time + uint64_t(timeout) * 1000);
+        task->waitingForNotify = false;
+    }
+    const uint32_t value = task->notifyValue;
+    if (value != 0) task->notifyValue = clearOnExit ? 0 : value - 1;
+    task->notifyPending = false;
+    return value;
+}
+
+bool Kernel::notifyClear(Task* task) {
+    if (task == nullptr) task = running;
+    if (stopped || task == nullptr || !isValid(task)) return false;
+    const bool wasPending = task->notifyPending;
+    task->notifyPending = false;
+    return wasPending;
+}
+
+Mutex* Kernel::createMutex() { return new Mutex(); }
+
+bool Kernel::takeMutex(Mutex* mutex, uint32_t timeout) {
+    if (mutex == nullptr) return false;
+    if (!mutex->locked) {
+        mutex->locked = true;
+        mutex->owner = running;
+        return true;
+    }
+    // outside of a task there is nothing that could wait
+    if (stopped || running == nullptr || timeout == 0) return false;
+    running->waitingMutex = mutex;
+    running->mutexHandedOff = false;
+    mutex->waiters.push_back(running);
+    block(timeout == UINT32_MAX ? UINT64_MAX : time + uint64_t(timeout) * 1000);
+    return running->mutexHandedOff;
+}
+
+bool Kernel::giveMutex(Mutex* mutex) {
+    if (mutex == nullptr || !mutex->locked) return false;
+    if (mutex->waiters.empty() || stopped) {
+        mutex->locked = false;
+        mutex->owner = nullptr;
+        return true;
+    }
+    // hand the mutex straight to the first waiter so it can't be stolen before the waiter runs
+    Task* waiter = mutex->waiters.front();
+    mutex->waiters.pop_front();
+    mutex->owner = waiter;
+    waiter->waitingMutex = nullptr;
+    waiter->mutexHandedOff = true;
+    makeReady(waiter);
+    return true;
+}
+
+void Kernel::deleteMutex(Mutex* mutex) {
+    if (mutex == nullptr) return;
+    for (Task* waiter : mutex->waiters) waiter->waitingMutex = nullptr;
+    delete mutex;
+}
+
+uint32_t Kernel::taskCount() const {
+    return std::count_if(tasks.begin(), tasks.end(),
+                         [](const Task* task) { return task->state != Task::State::DELETED; });
+}
+
+Task* Kernel::findTask(const char* name) const {
+    for (Task* task : tasks) {
+        if (task->state != Task::State::DELETED && task->name == name) return task;
+    }
+    return nullptr;
+}
+
+bool Kernel::isValid(Task* task) const { return std::find(tasks.begin(), tasks.end(), task) != tasks.end(); }
+
+void Kernel::block(uint64_t wakeTime) {
+    running->state = Task::State::BLOCKED;
+    running->wakeTime = wakeTime;
+    running->blockSequence = sequence++;
+    switchToScheduler();
+}
+
+void Kernel::makeReady(Task* task) {
+    task->state = Task::State::READY;
+    task->wakeTime = UINT64_MAX;
+    readyQueue.push_back(task);
+}
+
+void Kernel::switchToScheduler() {
+    Task* task = running;
+    swapcontext(&task->context, &schedulerContext);
+}
+
+void Kernel::wakeSleepers() {
+    std::vector<Task*> woken;
+    for (Task* task : tasks) {
+        if (task->state == Task::State::BLOCKED && task->wakeTime <= time) woken.push_back(task);
+    }
+    std::sort(woken.begin(), woken.end(), [](const Task* a, const Task* b) {
+        return a->wakeTime != b->wakeTime ? a->wakeTime < b->wakeTime : a->blockSequence < b->blockSequence;
+    });
+    for (Task* task : woken) {
+        // the wait timed out
+        if (task->waitingMutex != nullptr) {
+            std::deque<Task*>& waiters = task->waitingMutex->waiters;
+            waiters.erase(std::remove(waiters.begin(), waiters.end(), task), waiters.end());
+            task->waitingMutex = nullptr;
+        }
+        task->waitingForNotify = false;
+        makeReady(task);
+    }
+}
+
+void Kernel::run(uint64_t untilMicros) {
+    while (!stopped) {
+        if (!readyQueue.empty()) {
+            // highest priority first, FIFO within a priority
+            auto next = readyQueue.begin();
+            for (auto it = readyQueue.begin(); it != readyQueue.end(); it++) {
+                if ((*it)->priority > (*next)->priority) next = it;
+            }
+            Task* task = *next;
+            readyQueue.erase(next);
+            running = task;
+            task->state = Task::State::RUNNING;
+            swapcontext(&schedulerContext, &task->context);
+            running = nullptr;
+            if (task->state == Task::State::DELETED && task->stack != nullptr) {
+                std::free(task->stack);
+                task->stack = nullptr;
+            }
+            continue;
+        }
+        if (time >= untilMicros) break;
+        time += 1000;
+        if (tickHook) tickHook(time);
+        wakeSleepers();
+    }
+}
+} // namespace sim
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cmath>
+#include "sim/devices.hpp"
+#include "sim/plant.hpp"
+
+namespace sim {
+Plant::Plant(const PlantParams& params)
+    : params(params) {}
+
+void Plant::setPose(double x, double y, double theta) {
+    state.x = x;
+    state.y = y;
+    state.theta = theta * M_PI / 180;
+}
+
+double Plant::commandedSpeed(int port) const {
+    const MotorState& motor = motors.at(port);
+    const double max = maxRpm(motor.gearing);
+    switch (motor.mode) {
+        case MotorState::Mode::VOLTAGE: return motor.voltage / 12000 * max;
+        case MotorState::Mode::VELOCITY: return std::clamp(double(motor.targetVelocity), -max, max);
+        case MotorState::Mode::POSITION: {
+            // the motor's internal position controller
+            const double limit = motor.profileVelocity == 0 ? max : std::min(double(motor.profileVelocity), max);
+            return std::clamp(2 * (motor.targetPosition - motor.position), -limit, limit);
+        }
+        case MotorState::Mode::BRAKE: return 0;
+    }
+    return 0;
+}
+
+void Plant::step(double dt) {
+    time += dt;
+
+    // average the commands of each side of the drivetrain, as a fraction of full speed
+    auto sideCommand = [&](const std::vector<int>& ports) {
+        double sum = 0;
+        for (int port : ports) sum += commandedSpeed(port) / maxRpm(motors.at(port).gearing);
+        return sum / ports.size();
+    };
+    const double maxSpeed = params.driveRpm / 60 * M_PI * params.wheelDiameter;
+    const double traction = blocked ? params.wallSlip : 1;
+    const double leftTarget = sideCommand(params.leftPorts) * maxSpeed * params.leftStrength * traction;
+    const double rightTarget = sideCommand(params.rightPorts) * maxSpeed * params.rightStrength * traction;
+    const double alpha = dt / (params.timeConstant + dt);
+    state.leftVelocity += (leftTarget - state.leftVelocity) * alpha;
+    state.rightVelocity += (rightTarget - state.rightVelocity) * alpha;
+
+    // integrate the pose at the midpoint heading. A blocked robot doesn't move however its wheels turn
+    const double velocity = blocked ? 0 : (state.leftVelocity + state.rightVelocity) / 2;
+    const double angularVelocity = blocked ? 0 : (state.leftVelocity - state.rightVelocity) / params.trackWidth;
+    const double midTheta = state.theta + angularVelocity * dt / 2;
+    state.x += velocity * std::sin(midTheta) * dt;
+    state.y += velocity * std::cos(midTheta) * dt;
+    state.theta += angularVelocity * dt;
+
+    // drivetrain motor encoders
+    auto updateSide = [&](const std::vector<int>& ports, double sideVelocity) {
+        for (int port : ports) {
+            MotorState& motor = motors.at(port);
+            const double max = maxRpm(motor.gearing);
+            const double rpm = sideVelocity / maxSpeed * max;
+            motor.velocity = rpm;
+            motor.position += rpm * 6 * dt;
+            const double duty = commandedSpeed(port) / max;
+            motor.current = std::min(2500 * std::fabs(duty - rpm / max) + 100 * std::fabs(duty), 2500.0);
+            motor.current = std::min(motor.current, double(motor.currentLimit));
+            motor.torque = motor.current / 2500 * 2.1 * 200 / max;
+        }
+    };
+    updateSide(params.leftPorts, state.leftVelocity);
+    updateSide(params.rightPorts, state.rightVelocity);
+
+    // tracking wheels. A vertical wheel offset to the right travels less in a clockwise turn, a horizontal wheel
+    // offset towards the back moves to the left
+    for (const TrackingWheelParams& wheel : params.trackingWheels) {
+        const double speed = wheel.vertical ? velocity - angularVelocity * wheel.offset : -angularVelocity * wheel.offset;
+        RotationState& rotation = rotations.at(wheel.port);
+        rotation.velocity = rotation.jammed ? 0 : speed / (M_PI * wheel.diameter) * 36000;
+        rotation.position += rotation.velocity * dt;
+    }
+
+    // imu
+    ImuState& imu = imus.at(params.imuPort);
+    imu.gyroRate = angularVelocity * 180 / M_PI + params.imuDrift;
+    imu.rotation += imu.gyroRate * dt;
+
+    stepMechanisms(dt);
+    stepRings();
+}
+
+void Plant::stepMechanisms(double dt) {
+    const double alpha = dt / (params.mechanismTimeConstant + dt);
+    for (int port = 1; port < SMART_PORT_COUNT; port++) {
+        MotorState& motor = motors.at(port);
+        if (!motor.connected) continue;
+        if (std::find(params.leftPorts.begin(), params.leftPorts.end(), port) != params.leftPorts.end()) continue;
+        if (std::find(params.rightPorts.begin(), params.rightPorts.end(), port) != params.rightPorts.end()) continue;
+        const double max = maxRpm(motor.gearing);
+        const double target = commandedSpeed(port);
+        motor.velocity += (target - motor.velocity) * alpha;
+        motor.position += motor.velocity * 6 * dt;
+        motor.current = std::min(2500 * std::fabs(target - motor.velocity) / max + 100 * std::fabs(target) / max, 2500.0);
+        motor.current = std::min(motor.current, double(motor.currentLimit));
+        motor.torque = motor.current / 2500 * 2.1 * 200 / max;
+    }
+}
+void Plant::stepRings() {
+    if (!ringsAdded) return;
+    const MotorState& conveyor = motors.at(params.conveyorPort);
+
+    // rings in reach of the intake are picked up while the conveyor runs up
+    if (conveyor.velocity > 0) {
+        const double intakeX = state.x + params.intakeReach * std::sin(state.theta);
+        const double intakeY = state.y + params.intakeReach * std::cos(state.theta);
+        for (auto ring = fieldRings.begin(); ring != fieldRings.end();) {
+            if (std::hypot(ring->x - intakeX, ring->y - intakeY) > params.intakeRadius) {
+                ring++;
+                continue;
+            }
+            carriedRings.push_back({conveyor.position, ring->blue});
+            ring = fieldRings.erase(ring);
+        }
+    }
+
+    // rings leave over the top, whether they are scored or thrown off, or back out of the intake
+    std::erase_if(carriedRings, [&](const CarriedRing& ring) {
+        const double travel = conveyor.position - ring.pickup;
+        return travel > params.sensorTravel + params.topTravel || travel < 0;
+    });
+
+    // the optical sensor sees the ring in front of it, or nothing
+    OpticalState& optical = opticals.at(params.opticalPort);
+    optical.hue = 0;
+    optical.saturation = 0;
+    optical.brightness = 0.1;
+    optical.proximity = 0;
+    for (const CarriedRing& ring : carriedRings) {
+        const double travel = conveyor.position - ring.pickup - params.sensorTravel;
+        if (travel < 0 || travel >= params.ringTravel) continue;
+        optical.hue = ring.blue ? 220 : 5;
+        optical.saturation = 0.8;
+        optical.brightness = 0.5;
+        optical.proximity = 250;
+    }
+}
+} // namespace sim
@@ -0,0 +1,174 @@
+#include <system_error>
+#include "pros/apix.h"
+#include "pros/rtos.hpp"
+#include "sim/kernel.hpp"
+
+namespace {
+sim::Task* toTask(pros::task_t task) { return static_cast<sim::Task*>(task); }
+
+sim::Mutex* toMutex(pros::mutex_t mutex) { return static_cast<sim::Mutex*>(mutex); }
+} // namespace
+
+namespace pros::c {
+uint32_t millis(void) { return sim::Kernel::get().now() / 1000; }
+
+uint64_t micros(void) { return sim::Kernel::get().now(); }
+
+task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
+                   const char* const name) {
+    return sim::Kernel::get().createTask(function, parameters, prio, name);
+}
+
+void task_delete(task_t task) { sim::Kernel::get().deleteTask(toTask(task)); }
+
+void task_delay(const uint32_t milliseconds) { sim::Kernel::get().delay(uint64_t(milliseconds) * 1000); }
+
+void delay(const uint32_t milliseconds) { sim::Kernel::get().delay(uint64_t(milliseconds) * 1000); }
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta) {
+    *prev_time += delta;
+    sim::Kernel::get().delayUntil(uint64_t(*prev_time) * 1000);
+}
+
+uint32_t task_get_priority(task_t task) {
+    sim::Task* t = task == nullptr ? sim::Kernel::get().current() : toTask(task);
+    return t == nullptr ? 0 : t->priority;
+}
+
+void task_set_priority(task_t task, uint32_t prio) {
+    sim::Task* t = task == nullptr ? sim::Kernel::get().current() : toTask(task);
+    if (t != nullptr) t->priority = prio;
+}
+
+task_state_e_t task_get_state(task_t task) {
+    sim::Kernel& kernel = sim::Kernel::get();
+    sim::Task* t = toTask(task);
+    if (t == nullptr || !kernel.isValid(t)) return E_TASK_STATE_INVALID;
+    switch (t->state) {
+        case sim::Task::State::RUNNING: return E_TASK_STATE_RUNNING;
+        case sim::Task::State::READY: return E_TASK_STATE_READY;
+        case sim::Task::State::BLOCKED: return E_TASK_STATE_BLOCKED;
+        case sim::Task::State::SUSPENDED: return E_TASK_STATE_SUSPENDED;
+        case sim::Task::State::DELETED: return E_TASK_STATE_DELETED;
+    }
+    return E_TASK_STATE_INVALID;
+}
+
+void task_suspend(task_t task) { sim::Kernel::get().suspendTask(toTask(task)); }
+
+void task_resume(task_t task) { sim::Kernel::get().resumeTask(toTask(task)); }
+
+uint32_t task_get_count(void) { return sim::Kernel::get().taskCount(); }
+
+char* task_get_name(task_t task) {
+    sim::Task* t = task == nullptr ? sim::Kernel::get().current() : toTask(task);
+    return t == nullptr ? nullptr : t->name.data();
+}
+
+task_t task_get_by_name(const char* name) { return sim::Kernel::get().findTask(name); }
+
+task_t task_get_current() { return sim::Kernel::get().current(); }
+
+uint32_t task_notify(task_t task) {
+    return sim::Kernel::get().notify(toTask(task), 0, E_NOTIFY_ACTION_INCR, nullptr);
+}
+
+// the host's stdout has no stream framing to turn off
+int32_t serctl(const uint32_t action, void* const extra_arg) { return 0; }
+
+void task_join(task_t task) { sim::Kernel::get().join(toTask(task)); }
+
+uint32_t task_notify_ext(task_t task, uint32_t value, notify_action_e_t action, uint32_t* prev_value) {
+    return sim::Kernel::get().notify(toTask(task), value, action, prev_value);
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+    return sim::Kernel::get().notifyTake(clear_on_exit, timeout);
+}
+
+bool task_notify_clear(task_t task) { return sim::Kernel::get().notifyClear(toTask(task)); }
+
+mutex_t mutex_create(void) { return sim::Kernel::get().createMutex(); }
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) { return sim::Kernel::get().takeMutex(toMutex(mutex), timeout); }
+
+bool mutex_give(mutex_t mutex) { return sim::Kernel::get().giveMutex(toMutex(mutex)); }
+
+void mutex_delete(mutex_t mutex) { sim::Kernel::get().deleteMutex(toMutex(mutex)); }
+} // namespace pros::c
+
+namespace pros {
+inline namespace rtos {
+Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name) {
+    task = c::task_create(function, parameters, prio, stack_depth, name);
+}
+
+Task::Task(task_fn_t function, void* parameters, const char* name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {}
+
+Task::Task(task_t task)
+    : task(task) {}
+
+Task Task::current() { return Task(c::task_get_current()); }
+
+Task& Task::operator=(const task_t in) {
+    task = in;
+    return *this;
+}
+
+void Task::remove() { c::task_delete(task); }
+
+std::uint32_t Task::get_priority() { return c::task_get_priority(task); }
+
+void Task::set_priority(std::uint32_t prio) { c::task_set_priority(task, prio); }
+
+std::uint32_t Task::get_state() { return c::task_get_state(task); }
+
+void Task::suspend() { c::task_suspend(task); }
+
+void Task::resume() { c::task_resume(task); }
+
+const char* Task::get_name() { return c::task_get_name(task); }
+
+std::uint32_t Task::notify() { return c::task_notify(task); }
+
+void Task::join() { c::task_join(task); }
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t* prev_value) {
+    return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+    return c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear() { return c::task_notify_clear(task); }
+
+void Task::delay(const std::uint32_t milliseconds) { c::task_delay(milliseconds); }
+
+void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) {
+    c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count() { return c::task_get_count(); }
+
+Clock::time_point Clock::now() { return time_point {duration {c::millis()}}; }
+
+Mutex::Mutex()
+    : mutex(c::mutex_create(), c::mutex_delete) {}
+
+bool Mutex::take() { return c::mutex_take(mutex.get(), TIMEOUT_MAX); }
+
+bool Mutex::take(std::uint32_t timeout) { return c::mutex_take(mutex.get(), timeout); }
+
+bool Mutex::give() { return c::mutex_give(mutex.get()); }
+
+void Mutex::lock() {
+    if (!take(TIMEOUT_MAX)) throw std::system_error(errno, std::system_category(), "Cannot obtain lock!");
+}
+
+void Mutex::unlock() { give(); }
+
+bool Mutex::try_lock() { return take(0); }
+} // namespace rtos
+} // namespace pros
@@ -0,0 +1,114 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "main.h"
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/mechanisms/ringInventory.hpp"
+#include "sim/devices.hpp"
+#include "sim/kernel.hpp"
+#include "sim/plant.hpp"
+#include "sim/runner.hpp"
+
+// robot config and auton selection from src/main.cpp
+extern lemlib::Chassis chassis;
+extern lemlib::RingInventory rings;
+extern bool alliance;
+extern int autonSide;
+extern int autonRoute;
+
+namespace sim {
+TrialResult runTrial(const TrialConfig& config) {
+    // a side that isn't -1, 0 or 1 makes autonomous() run autonRoute as is
+    if (config.route != -1) {
+        autonSide = 2;
+        autonRoute = config.route;
+    }
+    if (config.side != -1) autonSide = config.side;
+    if (config.alliance != -1) alliance = config.alliance;
+
+    const Perturbation& perturbation = config.perturbation;
+    PlantParams params;
+    params.trackingWheels.at(0).diameter *= perturbation.horizontalScale;
+    params.trackingWheels.at(1).diameter *= perturbation.vertical1Scale;
+    params.trackingWheels.at(2).diameter *= perturbation.vertical2Scale;
+    params.imuDrift = perturbation.imuDrift;
+    params.leftStrength = perturbation.leftStrength;
+    params.rightStrength = perturbation.rightStrength;
+
+    TrialResult result;
+    const auto wallStart = std::chrono::steady_clock::now();
+    Kernel& kernel = Kernel::get();
+    Plant plant(params);
+    for (const FieldRing& ring : config.rings) plant.addRing(ring);
+    FILE* trace = config.trace == nullptr ? nullptr : std::fopen(config.trace, "w");
+    if (trace != nullptr) std::fprintf(trace, "time,x,y,theta,odomX,odomY,odomTheta\n");
+    uint64_t faultAt = UINT64_MAX; // set once autonomous starts
+    uint64_t wallUntil = 0;
+    kernel.setTickHook([&](uint64_t time) {
+        if (time >= faultAt) {
+            if (perturbation.unplugPort == params.imuPort) imus.at(perturbation.unplugPort).connected = false;
+            else if (perturbation.unplugPort != 0) rotations.at(perturbation.unplugPort).connected = false;
+            if (perturbation.jamPort != 0) rotations.at(perturbation.jamPort).jammed = true;
+            if (perturbation.wallTime > 0) {
+                plant.setBlocked(true);
+                wallUntil = faultAt + uint64_t(perturbation.wallTime * 1e6);
+            }
+            faultAt = UINT64_MAX;
+        }
+        if (wallUntil != 0 && time >= wallUntil) {
+            plant.setBlocked(false);
+            wallUntil = 0;
+        }
+        plant.step(0.001);
+        if (trace != nullptr && time % 10000 == 0) {
+            const PlantState& state = plant.getState();
+            const lemlib::Pose pose = chassis.getPose();
+            std::fprintf(trace, "%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", time / 1e6, state.x, state.y,
+                         state.theta * 180 / M_PI, pose.x, pose.y, pose.theta);
+        }
+    });
+
+    // initialize blocks every other competition mode, like on the brain
+    bool initialized = false;
+    competitionStatus = COMPETITION_DISABLED;
+    pros::Task initTask([&]() {
+        initialize();
+        initialized = true;
+    });
+    while (!initialized && kernel.now() < 60000000) kernel.run(kernel.now() + 10000);
+
+    if (initialized) {
+        const uint64_t autonStart = kernel.now();
+        if (perturbation.unplugPort != 0 || perturbation.jamPort != 0 || perturbation.wallTime > 0)
+            faultAt = autonStart + uint64_t(perturbation.faultTime * 1e6);
+        competitionStatus = COMPETITION_AUTONOMOUS;
+        pros::Task autonTask(autonomous);
+        // the route sets the odom pose before it first blocks. the robot starts where the route thinks it does, plus
+        // the start pose error
+        kernel.run(autonStart);
+        const lemlib::Pose start = chassis.getPose();
+        plant.setPose(start.x + perturbation.x, start.y + perturbation.y, start.theta + perturbation.theta);
+        kernel.run(autonStart + uint64_t(config.time * 1e6));
+        result.simTime = (kernel.now() - autonStart) / 1e6;
+    }
+    kernel.shutdown();
+    if (trace != nullptr) std::fclose(trace);
+
+    const PlantState& state = plant.getState();
+    const lemlib::Pose pose = chassis.getPose();
+    result.completed = initialized;
+    result.route = autonRoute;
+    result.x = state.x;
+    result.y = state.y;
+    result.theta = state.theta * 180 / M_PI;
+    result.odomX = pose.x;
+    result.odomY = pose.y;
+    result.odomTheta = pose.theta;
+    const lemlib::RingCounts counts = rings.getCounts();
+    result.ringsHeld = counts.held;
+    result.ringsScored = counts.scored;
+    result.wallTime =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+    return result;
+}
+} // namespace sim
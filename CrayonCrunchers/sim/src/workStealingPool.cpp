@@ -0,0 +1,50 @@
+#include <thread>
+#include "sim/workStealingPool.hpp"
+
+namespace sim {
+WorkStealingPool::WorkStealingPool(unsigned workers) {
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < workers; i++) queues.push_back(std::make_unique<Queue>());
+}
+
+void WorkStealingPool::submit(std::function<void()> job) {
+    Queue& queue = *queues.at(next);
+    next = (next + 1) % queues.size();
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back(std::move(job));
+}
+
+bool WorkStealingPool::pop(unsigned worker, std::function<void()>& job) {
+    Queue& queue = *queues.at(worker);
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned thief, std::function<void()>& job) {
+    // start with the next worker over so thieves spread out instead of all hitting worker 0
+    for (unsigned i = 1; i < queues.size(); i++) {
+        Queue& queue = *queues.at((thief + i) % queues.size());
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::run() {
+    std::vector<std::thread> threads;
+    for (unsigned worker = 0; worker < queues.size(); worker++) {
+        threads.emplace_back([this, worker]() {
+            std::function<void()> job;
+            // no job submits another, so once every queue is empty the pool is done
+            while (pop(worker, job) || steal(worker, job)) job();
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+}
+} // namespace sim
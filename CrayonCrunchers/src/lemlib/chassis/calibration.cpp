@@ -0,0 +1,69 @@
+#include <cmath>
+#include "lemlib/chassis/calibration.hpp"
+
+void lemlib::OdomCalibration::WheelFit::add(float reading, float turn, float distance) {
+    rr += double(reading) * reading;
+    rt += double(reading) * turn;
+    tt += double(turn) * turn;
+    rl += double(reading) * distance;
+    tl += double(turn) * distance;
+    ll += double(distance) * distance;
+    count++;
+}
+
+lemlib::WheelCalibration lemlib::OdomCalibration::WheelFit::solve() const {
+    WheelCalibration result;
+    // the normal equations are singular unless the wheel saw both straights and turns
+    const double det = rr * tt - rt * rt;
+    if (count < 2 || det <= 1e-6 * rr * tt) return result;
+    const double scale = (rl * tt - tl * rt) / det;
+    const double offset = (rr * tl - rt * rl) / det;
+    const double squaredError =
+        ll - 2 * (scale * rl + offset * tl) + scale * scale * rr + 2 * scale * offset * rt + offset * offset * tt;
+    result.valid = true;
+    result.scale = scale;
+    result.offset = offset;
+    result.error = std::sqrt(std::fmax(squaredError, 0) / count);
+    return result;
+}
+
+lemlib::WheelCalibration lemlib::OdomCalibration::WheelFit::solveOffset() const {
+    WheelCalibration result;
+    if (count < 1 || rr == 0 || tt <= 1e-6) return result;
+    // scale fixed at 1, so only r + t * o = L is left
+    const double offset = (tl - rt) / tt;
+    const double squaredError = ll + rr + offset * offset * tt - 2 * rl - 2 * offset * tl + 2 * offset * rt;
+    result.valid = true;
+    result.offset = offset;
+    result.error = std::sqrt(std::fmax(squaredError, 0) / count);
+    return result;
+}
+
+void lemlib::OdomCalibration::add(const CalibrationSegment& segment, float distance) {
+    vertical1.add(segment.vertical1, segment.heading, distance);
+    vertical2.add(segment.vertical2, segment.heading, distance);
+    // the robot never moves sideways, so horizontal wheels only see the turn
+    horizontal1.add(segment.horizontal1, segment.heading, 0);
+    horizontal2.add(segment.horizontal2, segment.heading, 0);
+    drive.add((segment.left + segment.right) / 2, segment.heading, distance);
+    sideTurn += double(segment.left - segment.right) * segment.heading;
+    turnTurn += double(segment.heading) * segment.heading;
+}
+
+void lemlib::OdomCalibration::addStraight(const CalibrationSegment& segment, float distance) { add(segment, distance); }
+
+void lemlib::OdomCalibration::addSpin(const CalibrationSegment& segment) { add(segment, 0); }
+
+void lemlib::OdomCalibration::clear() { *this = OdomCalibration(); }
+
+lemlib::CalibrationResult lemlib::OdomCalibration::solve() const {
+    CalibrationResult result;
+    result.vertical1 = vertical1.solve();
+    result.vertical2 = vertical2.solve();
+    result.horizontal1 = horizontal1.solveOffset();
+    result.horizontal2 = horizontal2.solveOffset();
+    result.drive = drive.solve();
+    // the sides read the track width times the turn apart, measured with the configured diameter
+    if (turnTurn > 1e-6) result.trackWidth = sideTurn / turnTurn * result.drive.scale;
+    return result;
+}
@@ -0,0 +1,537 @@
+#include <algorithm>
+#include <math.h>
+#include "pros/imu.hpp"
+#include "pros/misc.h"
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/logger/stdout.hpp"
+#include "lemlib/util.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/trackingWheel.hpp"
+
+// default drive curve
+lemlib::ExpoDriveCurve lemlib::defaultDriveCurve(0, 0, 1);
+
+lemlib::OdomSensors::OdomSensors(TrackingWheel* vertical1, TrackingWheel* vertical2, TrackingWheel* horizontal1,
+                                 TrackingWheel* horizontal2, pros::Imu* imu, OdomMode mode,
+                                 EkfSettings ekfSettings)
+    : vertical1(vertical1),
+      vertical2(vertical2),
+      horizontal1(horizontal1),
+      horizontal2(horizontal2),
+      imu(imu),
+      mode(mode),
+      ekfSettings(ekfSettings) {}
+
+lemlib::Drivetrain::Drivetrain(pros::MotorGroup* leftMotors, pros::MotorGroup* rightMotors, float trackWidth,
+                               float wheelDiameter, float rpm, float horizontalDrift)
+    : leftMotors(leftMotors),
+      rightMotors(rightMotors),
+      trackWidth(trackWidth),
+      wheelDiameter(wheelDiameter),
+      rpm(rpm),
+      horizontalDrift(horizontalDrift) {}
+
+float lemlib::ProfileSettings::feedforward(const MotionProfile::State& state) const {
+    if (state.velocity == 0 && state.acceleration == 0) return 0;
+    // static friction always opposes the direction of travel
+    const float direction = state.velocity != 0 ? sgn(state.velocity) : sgn(state.acceleration);
+    return kS * direction + kV * state.velocity + kA * state.acceleration;
+}
+
+lemlib::Chassis::Chassis(Drivetrain drivetrain, ControllerSettings linearSettings, ControllerSettings angularSettings,
+                         OdomSensors sensors, DriveCurve* throttleCurve, DriveCurve* steerCurve,
+                         ProfileSettings profileSettings)
+    : drivetrain(drivetrain),
+      lateralSettings(linearSettings),
+      angularSettings(angularSettings),
+      profileSettings(profileSettings),
+      sensors(sensors),
+      throttleCurve(throttleCurve),
+      steerCurve(steerCurve),
+      lateralPID(linearSettings.kP, linearSettings.kI, linearSettings.kD, linearSettings.windupRange, true),
+      angularPID(angularSettings.kP, angularSettings.kI, angularSettings.kD, angularSettings.windupRange, true),
+      lateralLargeExit(lateralSettings.largeError, lateralSettings.largeErrorTimeout),
+      lateralSmallExit(lateralSettings.smallError, lateralSettings.smallErrorTimeout),
+      angularLargeExit(angularSettings.largeError, angularSettings.largeErrorTimeout),
+      angularSmallExit(angularSettings.smallError, angularSettings.smallErrorTimeout) {}
+
+void lemlib::Chassis::calibrate(bool calibrateImu) {
+    // calibrate the IMU if it exists and the user doesn't specify otherwise
+    if (sensors.imu != nullptr && calibrateImu) {
+        int attempt = 1;
+        bool calibrated = false;
+        // calibrate inertial, and if calibration fails, then repeat 5 times or until successful
+        while (attempt <= 5) {
+            sensors.imu->reset();
+            // wait until IMU is calibrated
+            do pros::delay(10);
+            while (sensors.imu->get_status() != pros::ImuStatus::error && sensors.imu->is_calibrating());
+            // exit if imu has been calibrated
+            if (!isnanf(sensors.imu->get_heading()) && !isinf(sensors.imu->get_heading())) {
+                calibrated = true;
+                break;
+            }
+            // indicate error
+            pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, "---");
+            infoSink()->warn("IMU failed to calibrate! Attempt #{}", attempt);
+            attempt++;
+        }
+        // check if calibration attempts were successful
+        if (attempt > 5) {
+            sensors.imu = nullptr;
+            infoSink()->error("IMU calibration failed, defaulting to tracking wheels / motor encoders");
+        }
+    }
+    // initialize odom
+    if (sensors.vertical1 == nullptr)
+        sensors.vertical1 = new lemlib::TrackingWheel(drivetrain.leftMotors, drivetrain.wheelDiameter,
+                                                      -(drivetrain.trackWidth / 2), drivetrain.rpm);
+    if (sensors.vertical2 == nullptr)
+        sensors.vertical2 = new lemlib::TrackingWheel(drivetrain.rightMotors, drivetrain.wheelDiameter,
+                                                      drivetrain.trackWidth / 2, drivetrain.rpm);
+    sensors.vertical1->reset();
+    sensors.vertical2->reset();
+    if (sensors.horizontal1 != nullptr) sensors.horizontal1->reset();
+    if (sensors.horizontal2 != nullptr) sensors.horizontal2->reset();
+    setSensors(sensors, drivetrain);
+    init();
+    // rumble to controller to indicate success
+    pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, ".");
+}
+
+namespace {
+// distance reported by a tracking wheel, or 0 if it doesn't exist
+float distanceOf(lemlib::TrackingWheel* wheel) { return wheel == nullptr ? 0 : wheel->getDistanceTraveled(); }
+
+// total of every sensor. Subtracting two of these gives the change over a segment
+lemlib::CalibrationSegment readSensors(const lemlib::OdomSensors& sensors, lemlib::TrackingWheel& left,
+                                       lemlib::TrackingWheel& right) {
+    return {distanceOf(sensors.vertical1),
+            distanceOf(sensors.vertical2),
+            distanceOf(sensors.horizontal1),
+            distanceOf(sensors.horizontal2),
+            left.getDistanceTraveled(),
+            right.getDistanceTraveled(),
+            lemlib::degToRad(sensors.imu->get_rotation())};
+}
+
+lemlib::CalibrationSegment difference(const lemlib::CalibrationSegment& end, const lemlib::CalibrationSegment& start) {
+    return {end.vertical1 - start.vertical1, end.vertical2 - start.vertical2, end.horizontal1 - start.horizontal1,
+            end.horizontal2 - start.horizontal2, end.left - start.left,       end.right - start.right,
+            end.heading - start.heading};
+}
+
+// print a segment in a format the host calibration tool can read back
+void printSegment(const char* type, float distance, const lemlib::CalibrationSegment& s) {
+    lemlib::bufferedStdout().print("calibration,{},{:.3f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.5f}\n", type,
+                                   distance, s.vertical1, s.vertical2, s.horizontal1, s.horizontal2, s.left, s.right,
+                                   s.heading);
+}
+
+// ask the driver how far the robot actually drove
+float measureDistance(float guess) {
+    pros::Controller controller(pros::E_CONTROLLER_MASTER);
+    controller.rumble(".");
+    float distance = guess;
+    float shown = NAN;
+    while (!controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_A)) {
+        if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_UP)) distance += 0.1;
+        if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_DOWN)) distance -= 0.1;
+        if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_RIGHT)) distance += 1;
+        if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_LEFT)) distance -= 1;
+        // the controller screen only updates every 50 ms, so only send text when it changes
+        if (distance != shown) controller.set_text(0, 0, fmt::format("moved {:.1f} in   ", distance));
+        shown = distance;
+        pros::delay(50);
+    }
+    controller.clear_line(0);
+    return distance;
+}
+
+// print the calibrated values of a tracking wheel, skipping wheels that are really the drivetrain
+void printWheel(const char* name, lemlib::TrackingWheel* wheel, const lemlib::WheelCalibration& calibration) {
+    if (wheel == nullptr || wheel->getType() == 1) return;
+    if (!calibration.valid) {
+        lemlib::bufferedStdout().print("{}: not enough data\n", name);
+        return;
+    }
+    lemlib::bufferedStdout().print("{}: diameter {:.4f}, offset {:.4f} (error {:.3f} in)\n", name,
+                                   wheel->getDiameter() * calibration.scale, calibration.offset, calibration.error);
+}
+} // namespace
+
+lemlib::CalibrationResult lemlib::Chassis::calibrateOdom(float distance, int straights, int spins) {
+    if (sensors.imu == nullptr) {
+        infoSink()->error("Odom calibration needs an IMU");
+        return {};
+    }
+    // the vertical slots may already hold the drivetrain, but those have the wrong offsets for the drive fit
+    TrackingWheel left(drivetrain.leftMotors, drivetrain.wheelDiameter, -drivetrain.trackWidth / 2, drivetrain.rpm);
+    TrackingWheel right(drivetrain.rightMotors, drivetrain.wheelDiameter, drivetrain.trackWidth / 2, drivetrain.rpm);
+    OdomCalibration calibration;
+
+    // straight segments, alternating direction so the robot ends up where it started
+    for (int i = 0; i < straights; i++) {
+        const bool forwards = i % 2 == 0;
+        const Pose pose = getPose(true);
+        const float direction = forwards ? 1 : -1;
+        const CalibrationSegment start = readSensors(sensors, left, right);
+        // drive slowly, so the drivetrain and tracking wheels don't slip
+        moveToPoint(pose.x + direction * distance * std::sin(pose.theta),
+                    pose.y + direction * distance * std::cos(pose.theta), 5000, {.forwards = forwards, .maxSpeed = 60},
+                    false);
+        pros::delay(500);
+        const CalibrationSegment segment = difference(readSensors(sensors, left, right), start);
+        const float measured = direction * measureDistance(distance);
+        printSegment("straight", measured, segment);
+        calibration.addStraight(segment, measured);
+    }
+
+    // spins, alternating direction so any drift of the IMU averages out
+    for (int i = 0; i < spins; i++) {
+        const int direction = i % 2 == 0 ? 1 : -1;
+        const CalibrationSegment start = readSensors(sensors, left, right);
+        while (std::fabs(sensors.imu->get_rotation() - radToDeg(start.heading)) < 720) {
+            tank(60 * direction, -60 * direction, true);
+            pros::delay(10);
+        }
+        tank(0, 0, true);
+        pros::delay(500);
+        const CalibrationSegment segment = difference(readSensors(sensors, left, right), start);
+        printSegment("spin", 0, segment);
+        calibration.addSpin(segment);
+    }
+
+    const CalibrationResult result = calibration.solve();
+    printWheel("vertical1", sensors.vertical1, result.vertical1);
+    printWheel("vertical2", sensors.vertical2, result.vertical2);
+    printWheel("horizontal1", sensors.horizontal1, result.horizontal1);
+    printWheel("horizontal2", sensors.horizontal2, result.horizontal2);
+    if (result.drive.valid) {
+        bufferedStdout().print("drivetrain: wheel diameter {:.4f}, track width {:.4f} (error {:.3f} in)\n",
+                               drivetrain.wheelDiameter * result.drive.scale, result.trackWidth, result.drive.error);
+    } else {
+        bufferedStdout().print("drivetrain: not enough data\n");
+    }
+    return result;
+}
+
+void lemlib::Chassis::setPose(float x, float y, float theta, bool radians) {
+    lemlib::setPose(lemlib::Pose(x, y, theta), radians);
+}
+
+void lemlib::Chassis::setPose(Pose pose, bool radians) { lemlib::setPose(pose, radians); }
+
+lemlib::Pose lemlib::Chassis::getPose(bool radians, bool standardPos) {
+    Pose pose = lemlib::getPose(true);
+    if (standardPos) pose.theta = M_PI_2 - pose.theta;
+    if (!radians) pose.theta = radToDeg(pose.theta);
+    return pose;
+}
+
+void lemlib::Chassis::resetLocalPosition() {
+    float theta = this->getPose().theta;
+    lemlib::setPose(lemlib::Pose(0, 0, theta), false);
+}
+
+void lemlib::Chassis::setBrakeMode(pros::motor_brake_mode_e mode) {
+    drivetrain.leftMotors->set_brake_mode_all(mode);
+    drivetrain.rightMotors->set_brake_mode_all(mode);
+}
+
+void lemlib::Chassis::waitUntil(float dist) {
+    if (nextTicket == 0) return;
+    const uint32_t ticket = nextTicket - 1;
+    // over once the motion has ended, or has started and traveled far enough
+    wait(
+        [this, ticket, dist]() {
+            return runningTicket > ticket ||
+                   (runningTicket == ticket && motionOwner != nullptr && distTraveled >= dist);
+        },
+        TIMEOUT_MAX);
+}
+
+void lemlib::Chassis::waitUntilDone() {
+    const uint32_t ticket = nextTicket;
+    wait([this, ticket]() { return runningTicket >= ticket; }, TIMEOUT_MAX);
+}
+
+bool lemlib::Chassis::waitUntil(std::function<bool()> condition, int timeout) {
+    return wait(condition, std::max(timeout, 0));
+}
+
+bool lemlib::Chassis::waitUntilNear(float x, float y, float radius, int timeout) {
+    return waitUntil([this, x, y, radius]() { return getPose().distance(Pose(x, y)) <= radius; }, timeout);
+}
+
+lemlib::WaitLatency lemlib::Chassis::getWaitLatency() {
+    this->waitMutex.take();
+    const WaitLatency latency = waitLatency;
+    this->waitMutex.give();
+    return latency;
+}
+
+bool lemlib::Chassis::wait(const std::function<bool()>& condition, uint32_t timeout) {
+    const uint32_t start = pros::millis();
+    // clear notifications left over from an earlier wait that timed out as it was signalled
+    pros::c::task_notify_take(true, 0);
+    this->waitMutex.take();
+    if (condition()) {
+        this->waitMutex.give();
+        return true;
+    }
+    Waiter* waiter = nullptr;
+    for (Waiter& slot : waiters) {
+        if (slot.task == nullptr) {
+            waiter = &slot;
+            break;
+        }
+    }
+    if (waiter == nullptr) {
+        this->waitMutex.give();
+        infoSink()->error("Too many tasks waiting on the chassis, skipping wait");
+        return false;
+    }
+    waiter->task = pros::c::task_get_current();
+    waiter->condition = &condition;
+    waiter->signalled = false;
+    waiter->signalTime = 0;
+    waiterCount++;
+    this->waitMutex.give();
+
+    bool met = false;
+    while (!waiter->signalled) {
+        const uint32_t elapsed = pros::millis() - start;
+        if (timeout != TIMEOUT_MAX && elapsed >= timeout) break;
+        uint32_t block = timeout == TIMEOUT_MAX ? TIMEOUT_MAX : timeout - elapsed;
+        // nothing signals the wait while no motion is running, so check it here instead
+        if (!this->motionRunning) {
+            if (condition()) {
+                met = true;
+                break;
+            }
+            block = std::min(block, uint32_t(10));
+        }
+        pros::c::task_notify_take(true, block);
+    }
+
+    this->waitMutex.take();
+    if (waiter->signalled) {
+        const uint32_t latency = pros::micros() - waiter->signalTime;
+        waitLatency.count++;
+        waitLatency.last = latency;
+        waitLatency.max = std::max(waitLatency.max, latency);
+        waitLatency.total += latency;
+        telemetrySink()->debug("wait,{},{}", pros::millis(), latency);
+        met = true;
+    }
+    waiter->task = nullptr;
+    waiterCount--;
+    this->waitMutex.give();
+    return met;
+}
+
+void lemlib::Chassis::signalWaiters() {
+    // nothing is usually waiting, so don't take the mutex
+    if (waiterCount == 0) return;
+    this->waitMutex.take();
+    for (Waiter& waiter : waiters) {
+        if (waiter.task == nullptr || waiter.signalled || !(*waiter.condition)()) continue;
+        waiter.signalled = true;
+        waiter.signalTime = pros::micros();
+        pros::c::task_notify(waiter.task);
+    }
+    this->waitMutex.give();
+}
+
+int lemlib::Chassis::queuedMotions() const {
+    if (runningTicket == nextTicket) return 0;
+    return nextTicket - std::max(runningTicket + 1, cancelledTicket);
+}
+
+uint32_t lemlib::Chassis::queueMotion() {
+    this->mutex.take();
+    // a full queue blocks the caller until the running motion ends. This should be rare, so just poll
+    while (queuedMotions() >= MAX_QUEUED_MOTIONS) {
+        this->mutex.give();
+        pros::delay(10);
+        this->mutex.take();
+    }
+    const uint32_t ticket = nextTicket++;
+    motionTasks[queueSlot(ticket)] = nullptr;
+    callerTasks[queueSlot(ticket)] = nullptr;
+    // nothing was running, so this motion is at the front of the queue already
+    if (ticket == runningTicket) this->motionRunning = true;
+    this->mutex.give();
+    return ticket;
+}
+
+bool lemlib::Chassis::waitForMotion(uint32_t ticket) {
+    const pros::task_t self = pros::c::task_get_current();
+    this->mutex.take();
+    motionTasks[queueSlot(ticket)] = self;
+    // endMotion and clearMotionQueue notify this task when its turn comes or it gets cancelled
+    while (runningTicket != ticket && ticket >= cancelledTicket) {
+        this->mutex.give();
+        pros::c::task_notify_take(true, TIMEOUT_MAX);
+        this->mutex.take();
+    }
+    if (runningTicket != ticket) {
+        this->mutex.give();
+        return false;
+    }
+    motionOwner = self;
+    motionStartTime = pros::millis();
+    if (motionLoop == nullptr) motionLoop = std::make_unique<PeriodicLoop>("motion", 10);
+    motionLoop->restart();
+    distTraveled = 0;
+    entrySpeed = exitSpeed;
+    exitSpeed = 0;
+    // the motion could have been cancelled before it got to start
+    const bool run = this->motionRunning;
+    this->mutex.give();
+    if (!run) endMotion();
+    return run;
+}
+
+void lemlib::Chassis::waitForQueue(uint32_t ticket) {
+    this->mutex.take();
+    callerTasks[queueSlot(ticket)] = pros::c::task_get_current();
+    while (ticket > runningTicket + motionQueueSize && ticket >= cancelledTicket) {
+        this->mutex.give();
+        pros::c::task_notify_take(true, TIMEOUT_MAX);
+        this->mutex.take();
+    }
+    callerTasks[queueSlot(ticket)] = nullptr;
+    this->mutex.give();
+}
+
+bool lemlib::Chassis::requestMotionStart() {
+    // the task was started for a queued motion, which already has its turn
+    if (motionOwner != nullptr && motionOwner == pros::c::task_get_current()) return true;
+    return waitForMotion(queueMotion());
+}
+
+void lemlib::Chassis::endMotion() {
+    // markers the motion never reached still run, like waitUntil returning when the motion ends
+    runMarkers(runningTicket, true, 1);
+    this->mutex.take();
+    motionOwner = nullptr;
+    // move the queue forward, skipping cancelled motions
+    runningTicket = std::max(runningTicket + 1, cancelledTicket);
+    // forget the markers of motions that were cancelled before they started
+    int kept = 0;
+    for (int i = 0; i < markerCount; i++) {
+        if (markers[i].ticket < runningTicket) continue;
+        if (kept != i) markers[kept] = std::move(markers[i]);
+        kept++;
+    }
+    for (int i = kept; i < markerCount; i++) markers[i].callback = nullptr;
+    markerCount = kept;
+    this->motionRunning = runningTicket < nextTicket;
+    // start the next motion straight away, so there is no gap between them
+    if (this->motionRunning && motionTasks[queueSlot(runningTicket)] != nullptr)
+        pros::c::task_notify(motionTasks[queueSlot(runningTicket)]);
+    // let callers of async motions that are now close enough to the front carry on
+    for (uint32_t ticket = runningTicket; ticket < nextTicket; ticket++) {
+        const pros::task_t caller = callerTasks[queueSlot(ticket)];
+        if (caller != nullptr && ticket <= runningTicket + motionQueueSize) pros::c::task_notify(caller);
+    }
+    this->mutex.give();
+    signalWaiters();
+}
+
+void lemlib::Chassis::cancelMotion() {
+    this->motionRunning = false;
+    pros::delay(10); // give time for motion to stop
+}
+
+void lemlib::Chassis::clearMotionQueue() {
+    this->mutex.take();
+    // wake every queued motion and its caller, so they see they were cancelled
+    for (uint32_t ticket = std::max(runningTicket + 1, cancelledTicket); ticket < nextTicket; ticket++) {
+        if (motionTasks[queueSlot(ticket)] != nullptr) pros::c::task_notify(motionTasks[queueSlot(ticket)]);
+        if (callerTasks[queueSlot(ticket)] != nullptr) pros::c::task_notify(callerTasks[queueSlot(ticket)]);
+    }
+    cancelledTicket = nextTicket;
+    this->mutex.give();
+}
+
+void lemlib::Chassis::cancelAllMotions() {
+    clearMotionQueue();
+    cancelMotion();
+}
+
+int lemlib::Chassis::getQueuedMotions() {
+    this->mutex.take();
+    const int queued = queuedMotions();
+    this->mutex.give();
+    return queued;
+}
+
+void lemlib::Chassis::setMotionQueueSize(int size) {
+    this->mutex.take();
+    motionQueueSize = std::clamp(size, 0, MAX_QUEUED_MOTIONS);
+    this->mutex.give();
+}
+
+void lemlib::Chassis::addMarker(MarkerTrigger trigger, float value, std::function<void()> callback) {
+    this->mutex.take();
+    // the marker belongs to the motion queued last, unless it has ended or was cancelled before it could start
+    const uint32_t ticket = nextTicket - 1;
+    const bool pending =
+        nextTicket != 0 && ticket >= runningTicket && (ticket == runningTicket || ticket >= cancelledTicket);
+    if (!pending) {
+        this->mutex.give();
+        callback();
+        return;
+    }
+    if (markerCount == MAX_MARKERS) {
+        this->mutex.give();
+        infoSink()->error("Too many markers, skipping marker at {}", value);
+        return;
+    }
+    markers[markerCount++] = {ticket, trigger, value, std::move(callback)};
+    this->mutex.give();
+}
+
+void lemlib::Chassis::updateMarkers(float remaining) {
+    // most motions have no markers, so don't take the mutex for them
+    if (markerCount != 0) {
+        const float traveled = std::max(distTraveled.load(), 0.0f);
+        const float fraction = traveled + remaining > 0 ? traveled / (traveled + remaining) : 1;
+        runMarkers(runningTicket, false, fraction);
+    }
+    signalWaiters();
+}
+
+void lemlib::Chassis::runMarkers(uint32_t ticket, bool all, float fraction) {
+    // callbacks run after the mutex is given back, so they can use the chassis
+    std::array<std::function<void()>, MAX_MARKERS> due;
+    int dueCount = 0;
+    const uint32_t elapsed = pros::millis() - motionStartTime;
+    this->mutex.take();
+    int kept = 0;
+    for (int i = 0; i < markerCount; i++) {
+        Marker& marker = markers[i];
+        bool reached = all;
+        if (marker.trigger == MarkerTrigger::DISTANCE) reached |= distTraveled >= marker.value;
+        else if (marker.trigger == MarkerTrigger::FRACTION) reached |= fraction >= marker.value;
+        else reached |= elapsed >= marker.value;
+        // keep the markers in the order they were added, so markers reached on the same update run in that order
+        if (marker.ticket == ticket && reached) due[dueCount++] = std::move(marker.callback);
+        else {
+            if (kept != i) markers[kept] = std::move(marker);
+            kept++;
+        }
+    }
+    for (int i = kept; i < markerCount; i++) markers[i].callback = nullptr;
+    markerCount = kept;
+    this->mutex.give();
+    for (int i = 0; i < dueCount; i++) due[i]();
+}
+
+bool lemlib::Chassis::isInMotion() const { return this->motionRunning; }
@@ -0,0 +1,266 @@
+#include <cmath>
+#include <string>
+#include <vector>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/util.hpp"
+#include "pros/misc.hpp"
+
+/**
+ * @brief function that returns elements in a file line, separated by a delimeter
+ *
+ * @param input the raw string
+ * @param delimeter string separating the elements in the line
+ * @return std::vector<std::string> array of elements read from the file
+ */
+std::vector<std::string> splitString(const std::string& input, const std::string& delimiter) {
+    std::string token;
+    std::vector<std::string> output;
+    size_t start = 0;
+    size_t end = 0;
+    while ((end = input.find(delimiter, start)) != std::string::npos) {
+        token = input.substr(start, end - start);
+        output.push_back(token);
+        start = end + delimiter.size();
+    }
+    output.push_back(input.substr(start));
+    return output;
+}
+
+/**
+ * @brief Convert a string to hex
+ *
+ * @param input the string to convert
+ * @return std::vector<lemlib::Pose> the points of the path
+ */
+std::vector<lemlib::Pose> getData(const asset& path) {
+    std::vector<lemlib::Pose> robotPath;
+    std::vector<std::string> pathData = splitString(std::string(reinterpret_cast<char*>(path.buf), path.size), "\n");
+
+    for (std::string line : pathData) {
+        lemlib::Pose pathPoint(0, 0);
+        // check if the line is the end of the path
+        if (line == "endData" || line == "endData\r") break;
+        std::vector<std::string> pointInput = splitString(line, ", "); // parse line
+        // check if the line was read correctly
+        if (pointInput.size() != 3) {
+            lemlib::infoSink()->error("Failed to read path file! Are you using the right format? Raw line: {}", line);
+            break;
+        }
+        pathPoint.x = std::stof(pointInput.at(0)); // x position
+        pathPoint.y = std::stof(pointInput.at(1)); // y position
+        pathPoint.theta = std::stof(pointInput.at(2)); // speed
+        robotPath.push_back(pathPoint); // save data
+    }
+
+    return robotPath;
+}
+
+/**
+ * @brief find the closest point on the path to the robot
+ *
+ * @param pose the current pose of the robot
+ * @param path the path to follow
+ * @return int index to the closest point
+ */
+int findClosest(lemlib::Pose pose, std::vector<lemlib::Pose> path) {
+    int closestPoint = 0;
+    float closestDist = std::numeric_limits<float>::infinity();
+
+    // loop through all path points
+    for (int i = 0; i < path.size(); i++) {
+        const float dist = pose.distance(path.at(i));
+        if (dist < closestDist) { // new closest point
+            closestDist = dist;
+            closestPoint = i;
+        }
+    }
+
+    return closestPoint;
+}
+
+/**
+ * @brief Function that finds the intersection point between a circle and a line
+ *
+ * @param p1 start point of the line
+ * @param p2 end point of the line
+ * @param pos position of the robot
+ * @param path the path to follow
+ * @return float how far along the line the intersection point is (0 to 1), or -1 if there is none
+ */
+float circleIntersect(lemlib::Pose p1, lemlib::Pose p2, lemlib::Pose pose, float lookaheadDist) {
+    // calculations
+    // uses the quadratic formula to calculate intersection points
+    lemlib::Pose d = p2 - p1;
+    lemlib::Pose f = p1 - pose;
+    float a = d * d;
+    float b = 2 * (f * d);
+    float c = (f * f) - lookaheadDist * lookaheadDist;
+    float discriminant = b * b - 4 * a * c;
+
+    // if a possible intersection was found
+    if (discriminant >= 0) {
+        discriminant = sqrt(discriminant);
+        float t1 = (-b - discriminant) / (2 * a);
+        float t2 = (-b + discriminant) / (2 * a);
+
+        // prioritize further down the path
+        if (t2 >= 0 && t2 <= 1) return t2;
+        else if (t1 >= 0 && t1 <= 1) return t1;
+    }
+
+    // no intersection found
+    return -1;
+}
+
+/**
+ * @brief returns the lookahead point
+ *
+ * @param lastLookahead - the last lookahead point
+ * @param pose - the current position of the robot
+ * @param path - the path to follow
+ * @param closest - the index of the point closest to the robot
+ * @param lookaheadDist - the lookahead distance of the algorithm
+ */
+lemlib::Pose lookaheadPoint(lemlib::Pose lastLookahead, lemlib::Pose pose, std::vector<lemlib::Pose> path,
+                            int closest, float lookaheadDist) {
+    // optimizations applied:
+    // only consider intersections that have an index greater than or equal to the point closest
+    // to the robot
+    // and intersections that have an index greater than or equal to the last lookahead point
+    const int start = std::max(closest, int(lastLookahead.theta));
+    for (int i = start; i < path.size() - 1; i++) {
+        lemlib::Pose lastPathPose = path.at(i);
+        lemlib::Pose currentPathPose = path.at(i + 1);
+
+        float t = circleIntersect(lastPathPose, currentPathPose, pose, lookaheadDist);
+
+        if (t != -1) {
+            lemlib::Pose lookahead = lastPathPose.lerp(currentPathPose, t);
+            lookahead.theta = i;
+            return lookahead;
+        }
+    }
+
+    // robot deviated from path, use last lookahead point
+    return lastLookahead;
+}
+
+/**
+ * @brief Get the curvature of a circle that intersects the robot and the lookahead point
+ *
+ * @param pos the position of the robot
+ * @param heading the heading of the robot
+ * @param lookahead the lookahead point
+ * @return float curvature
+ */
+float findLookaheadCurvature(lemlib::Pose pose, float heading, lemlib::Pose lookahead) {
+    // calculate whether the robot is on the left or right side of the circle
+    float side = lemlib::sgn(std::sin(heading) * (lookahead.x - pose.x) - std::cos(heading) * (lookahead.y - pose.y));
+    // calculate center point and radius
+    float a = -std::tan(heading);
+    float c = std::tan(heading) * pose.x - pose.y;
+    float x = std::fabs(a * lookahead.x + lookahead.y + c) / std::sqrt((a * a) + 1);
+    float d = std::hypot(lookahead.x - pose.x, lookahead.y - pose.y);
+
+    // return curvature
+    return side * ((2 * x) / (d * d));
+}
+
+void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bool forwards, bool async) {
+    // if the function is async, queue it and run it in a new task once the motions ahead of it are done
+    if (async) {
+        const uint32_t ticket = this->queueMotion();
+        pros::Task task([=, this]() {
+            if (this->waitForMotion(ticket)) follow(path, lookahead, timeout, forwards, false);
+        });
+        this->waitForQueue(ticket);
+        return;
+    }
+    // wait for the motions ahead of this one. Were they all cancelled?
+    if (!this->requestMotionStart()) return;
+
+    std::vector<lemlib::Pose> pathPoints = getData(path); // get list of path points
+    if (pathPoints.size() == 0) {
+        infoSink()->error("No points in path! Do you have the right format? Skipping motion");
+        // set distTraveled to -1 to indicate that the function has finished
+        distTraveled = -1;
+        this->endMotion();
+        return;
+    }
+    Pose pose(0, 0, 0);
+    Pose lastPose = getPose();
+    Pose lookaheadPose(0, 0, 0);
+    Pose lastLookahead = pathPoints.at(0);
+    lastLookahead.theta = 0;
+    float curvature;
+    float targetVel;
+    float prevVel = 0;
+    int closestPoint;
+    int compState = pros::competition::get_status();
+    distTraveled = 0;
+    // length of the path, for fraction markers
+    float pathLength = 0;
+    for (size_t i = 1; i < pathPoints.size(); i++) pathLength += pathPoints.at(i).distance(pathPoints.at(i - 1));
+
+    // loop until the robot is within the end tolerance
+    for (int i = 0; i < timeout / 10 && pros::competition::get_status() == compState && this->motionRunning; i++) {
+        // get the current position of the robot
+        pose = this->getPose(true);
+        if (!forwards) pose.theta -= M_PI;
+
+        // update completion vars
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // run the markers that have been reached
+        updateMarkers(std::max(pathLength - distTraveled, 0.0f));
+
+        // find the closest point on the path to the robot
+        closestPoint = findClosest(pose, pathPoints);
+        // if the robot is at the end of the path, then stop
+        if (pathPoints.at(closestPoint).theta == 0) break;
+
+        // find the lookahead point
+        lookaheadPose = lookaheadPoint(lastLookahead, pose, pathPoints, closestPoint, lookahead);
+        lastLookahead = lookaheadPose; // update last lookahead position
+
+        // get the curvature of the arc between the robot and the lookahead point
+        float curvatureHeading = M_PI / 2 - pose.theta;
+        curvature = findLookaheadCurvature(pose, curvatureHeading, lookaheadPose);
+
+        // get the target velocity of the robot
+        targetVel = pathPoints.at(closestPoint).theta;
+        targetVel = slew(targetVel, prevVel, lateralSettings.slew);
+        prevVel = targetVel;
+
+        // calculate target left and right velocities
+        float targetLeftVel = targetVel * (2 + curvature * drivetrain.trackWidth) / 2;
+        float targetRightVel = targetVel * (2 - curvature * drivetrain.trackWidth) / 2;
+
+        // ratio the speeds to respect the max speed
+        float ratio = std::max(std::fabs(targetLeftVel), std::fabs(targetRightVel)) / 127;
+        if (ratio > 1) {
+            targetLeftVel /= ratio;
+            targetRightVel /= ratio;
+        }
+
+        // move the drivetrain
+        if (forwards) {
+            drivetrain.leftMotors->move(targetLeftVel);
+            drivetrain.rightMotors->move(targetRightVel);
+        } else {
+            drivetrain.leftMotors->move(-targetRightVel);
+            drivetrain.rightMotors->move(-targetLeftVel);
+        }
+
+        motionLoop->wait();
+    }
+
+    // stop the robot
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
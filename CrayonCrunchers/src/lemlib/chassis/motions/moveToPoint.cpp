@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "pros/misc.hpp"
+
+void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointParams params, bool async) {
+    params.earlyExitRange = fabs(params.earlyExitRange);
+    // if the function is async, queue it and run it in a new task once the motions ahead of it are done
+    if (async) {
+        const uint32_t ticket = this->queueMotion();
+        pros::Task task([=, this]() {
+            if (this->waitForMotion(ticket)) moveToPoint(x, y, timeout, params, false);
+        });
+        this->waitForQueue(ticket);
+        return;
+    }
+    // wait for the motions ahead of this one. Were they all cancelled?
+    if (!this->requestMotionStart()) return;
+
+    // reset PIDs and exit conditions
+    lateralPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    angularPID.reset();
+
+    // initialize vars used between iterations
+    Pose lastPose = getPose();
+    distTraveled = 0;
+    Timer timer(timeout);
+    bool close = false;
+    float prevLateralOut = entrySpeed; // previous lateral power, carried over if the last motion blended into this
+    bool blended = false;
+    float prevAngularOut = 0; // previous angular power
+    std::optional<bool> prevSide = std::nullopt;
+
+    // calculate target pose in standard form
+    Pose target(x, y);
+    target.theta = lastPose.angle(target);
+
+    // follow a motion profile to the target, if asked to and the chassis has settings for it
+    const bool profiled = params.profiled && profileSettings.maxVelocity > 0;
+    if (params.profiled && !profiled) infoSink()->warn("moveToPoint can't be profiled without ProfileSettings");
+    const float profileDistance = lastPose.distance(target);
+    const MotionProfile profile = profiled ? MotionProfile(profileDistance,
+                                                           profileSettings.maxVelocity * params.maxSpeed / 127,
+                                                           profileSettings.maxAcceleration, profileSettings.maxJerk)
+                                           : MotionProfile(0, 0, 0);
+    const int startTime = pros::millis();
+
+    // main loop
+    while (!timer.isDone() && ((!lateralSmallExit.getExit() && !lateralLargeExit.getExit()) || !close) &&
+           this->motionRunning) {
+        // update position
+        const Pose pose = getPose(true, true);
+
+        // update distance traveled
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // calculate distance to the target point
+        const float distTarget = pose.distance(target);
+
+        // run the markers that have been reached
+        updateMarkers(distTarget);
+
+        // check if the robot is close enough to the target to start settling
+        if (distTarget < 7.5 && close == false) {
+            close = true;
+            params.maxSpeed = fmax(fabs(prevLateralOut), 60);
+        }
+
+        // hand over to the next motion instead of settling, if there is one
+        if (close && params.blend && this->getQueuedMotions() > 0) {
+            blended = true;
+            break;
+        }
+
+        // motion chaining
+        const bool side =
+            (pose.y - target.y) * -sin(target.theta) <= (pose.x - target.x) * cos(target.theta) + params.earlyExitRange;
+        if (prevSide == std::nullopt) prevSide = side;
+        const bool sameSide = side == prevSide;
+        // exit if close
+        if (!sameSide && params.minSpeed != 0) break;
+        prevSide = side;
+
+        // calculate error
+        const float adjustedRobotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+        const float angularError = angleError(adjustedRobotTheta, pose.angle(target));
+        float lateralError = pose.distance(target) * cos(angleError(pose.theta, pose.angle(target)));
+
+        // update exit conditions
+        lateralSmallExit.update(lateralError);
+        lateralLargeExit.update(lateralError);
+
+        // get output from PIDs
+        // while the profile runs, feedforward drives the robot and the PID only corrects how far behind it is
+        const float profileTime = (pros::millis() - startTime) / 1000.0;
+        const bool profiling = profiled && profileTime < profile.getDuration();
+        float lateralOut;
+        if (profiling) {
+            const MotionProfile::State state = profile.sample(profileTime);
+            const float direction = params.forwards ? 1 : -1;
+            lateralOut = direction * profileSettings.feedforward(state) +
+                         lateralPID.update(lateralError - direction * (profileDistance - state.position));
+        } else lateralOut = lateralPID.update(lateralError);
+        float angularOut = angularPID.update(radToDeg(angularError));
+        if (close) angularOut = 0;
+
+        // apply restrictions on angular speed
+        angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+        angularOut = slew(angularOut, prevAngularOut, angularSettings.slew);
+
+        // apply restrictions on lateral speed
+        lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+        // constrain lateral output by max accel
+        // but not for decelerating, since that would interfere with settling
+        if (!close && !profiling) lateralOut = slew(lateralOut, prevLateralOut, lateralSettings.slew);
+
+        // prevent moving in the wrong direction
+        if (params.forwards && !close) lateralOut = std::fmax(lateralOut, 0);
+        else if (!params.forwards && !close) lateralOut = std::fmin(lateralOut, 0);
+
+        // constrain lateral output by the minimum speed
+        if (params.forwards && lateralOut < fabs(params.minSpeed) && lateralOut > 0) lateralOut = fabs(params.minSpeed);
+        if (!params.forwards && -lateralOut < fabs(params.minSpeed) && lateralOut < 0)
+            lateralOut = -fabs(params.minSpeed);
+
+        // update previous output
+        prevAngularOut = angularOut;
+        prevLateralOut = lateralOut;
+
+        infoSink()->debug("Angular Out: {}, Lateral Out: {}", angularOut, lateralOut);
+
+        // ratio the speeds to respect the max speed
+        float leftPower = lateralOut + angularOut;
+        float rightPower = lateralOut - angularOut;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / params.maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        // move the drivetrain
+        drivetrain.leftMotors->move(leftPower);
+        drivetrain.rightMotors->move(rightPower);
+
+        // delay to save resources
+        motionLoop->wait();
+    }
+
+    // stop the drivetrain, unless the next motion carries on from here
+    if (blended) exitSpeed = prevLateralOut;
+    else {
+        drivetrain.leftMotors->move(0);
+        drivetrain.rightMotors->move(0);
+    }
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
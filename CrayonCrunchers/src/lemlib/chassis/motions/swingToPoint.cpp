@@ -0,0 +1,102 @@
+#include <cmath>
+#include <optional>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "pros/misc.hpp"
+
+void lemlib::Chassis::swingToPoint(float x, float y, DriveSide lockedSide, int timeout, SwingToPointParams params,
+                                   bool async) {
+    params.minSpeed = fabs(params.minSpeed);
+    // if the function is async, queue it and run it in a new task once the motions ahead of it are done
+    if (async) {
+        const uint32_t ticket = this->queueMotion();
+        pros::Task task([=, this]() {
+            if (this->waitForMotion(ticket)) swingToPoint(x, y, lockedSide, timeout, params, false);
+        });
+        this->waitForQueue(ticket);
+        return;
+    }
+    // wait for the motions ahead of this one. Were they all cancelled?
+    if (!this->requestMotionStart()) return;
+    float targetTheta;
+    float deltaTheta;
+    float motorPower;
+    float prevMotorPower = 0;
+    float startTheta = getPose().theta;
+    bool settling = false;
+    std::optional<float> prevDeltaTheta = std::nullopt;
+    distTraveled = 0;
+    Timer timer(timeout);
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+    angularPID.reset();
+    // get original braking mode of the locked side
+    pros::motor_brake_mode_e_t brakeMode = static_cast<pros::motor_brake_mode_e_t>(
+        lockedSide == DriveSide::LEFT ? drivetrain.leftMotors->get_brake_mode()
+                                      : drivetrain.rightMotors->get_brake_mode());
+    // set brake mode of the locked side to hold
+    if (lockedSide == DriveSide::LEFT) drivetrain.leftMotors->set_brake_mode_all(pros::E_MOTOR_BRAKE_HOLD);
+    else drivetrain.rightMotors->set_brake_mode_all(pros::E_MOTOR_BRAKE_HOLD);
+
+    // main loop
+    while (!timer.isDone() && !angularLargeExit.getExit() && !angularSmallExit.getExit() && this->motionRunning) {
+        // update variables
+        Pose pose = getPose();
+        pose.theta = (params.forwards) ? fmod(pose.theta, 360) : fmod(pose.theta - 180, 360);
+
+        // update completion vars
+        distTraveled = fabs(angleError(pose.theta, startTheta, false));
+
+        // calculate deltaTheta
+        targetTheta = fmod(radToDeg(M_PI_2 - pose.angle({x, y})), 360);
+        deltaTheta = angleError(targetTheta, pose.theta, false, params.direction);
+        // once the robot has crossed the target, only take the shortest path to it
+        if (prevDeltaTheta && sgn(deltaTheta) != sgn(*prevDeltaTheta)) settling = true;
+        if (settling) deltaTheta = angleError(targetTheta, pose.theta, false);
+        prevDeltaTheta = deltaTheta;
+
+        // run the markers that have been reached
+        updateMarkers(fabs(deltaTheta));
+
+        // motion chaining
+        if (params.minSpeed != 0 && fabs(deltaTheta) < params.earlyExitRange) break;
+
+        // calculate the speed
+        motorPower = angularPID.update(deltaTheta);
+        angularLargeExit.update(deltaTheta);
+        angularSmallExit.update(deltaTheta);
+
+        // cap the speed
+        if (motorPower > params.maxSpeed) motorPower = params.maxSpeed;
+        else if (motorPower < -params.maxSpeed) motorPower = -params.maxSpeed;
+        if (fabs(deltaTheta) > 20) motorPower = slew(motorPower, prevMotorPower, angularSettings.slew);
+        if (motorPower < 0 && motorPower > -params.minSpeed) motorPower = -params.minSpeed;
+        else if (motorPower > 0 && motorPower < params.minSpeed) motorPower = params.minSpeed;
+        prevMotorPower = motorPower;
+
+        infoSink()->debug("Swing Motor Power: {} ", motorPower);
+
+        // move the drivetrain
+        if (lockedSide == DriveSide::LEFT) {
+            drivetrain.rightMotors->move(-motorPower);
+            drivetrain.leftMotors->brake();
+        } else {
+            drivetrain.leftMotors->move(motorPower);
+            drivetrain.rightMotors->brake();
+        }
+
+        motionLoop->wait();
+    }
+
+    // restore brake mode
+    if (lockedSide == DriveSide::LEFT) drivetrain.leftMotors->set_brake_mode_all(brakeMode);
+    else drivetrain.rightMotors->set_brake_mode_all(brakeMode);
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
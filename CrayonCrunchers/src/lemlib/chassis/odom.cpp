@@ -0,0 +1,444 @@
+// The implementation below is mostly based off of
+// the document written by 5225A (Pilons)
+// Here is a link to the original document
+// http://thepilons.ca/wp-content/uploads/2018/10/Tracking.pdf
+
+#include <math.h>
+#include <algorithm>
+#include "pros/rtos.hpp"
+#include "lemlib/util.hpp"
+#include "lemlib/periodic.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/seqlock.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/odomFilter.hpp"
+#include "lemlib/chassis/sensorMonitor.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/trackingWheel.hpp"
+
+// tracking thread
+lemlib::PeriodicTask* trackingTask = nullptr;
+
+// global variables
+lemlib::OdomSensors odomSensors(nullptr, nullptr, nullptr, nullptr, nullptr); // the sensors to be used for odometry
+// the sensors as they were set, so one that recovers from a fault can be swapped back in
+lemlib::OdomSensors configuredSensors(nullptr, nullptr, nullptr, nullptr, nullptr);
+lemlib::Drivetrain drive(nullptr, nullptr, 0, 0, 0, 0); // the drivetrain to be used for odometry
+lemlib::Pose odomPose(0, 0, 0); // the pose of the robot
+lemlib::Pose odomSpeed(0, 0, 0); // the speed of the robot
+lemlib::Pose odomLocalSpeed(0, 0, 0); // the local speed of the robot
+// the pose and speed published for other tasks to read, in radians
+lemlib::SeqLock<lemlib::PoseSnapshot> odomSnapshot({lemlib::Pose(0, 0, 0), lemlib::Pose(0, 0, 0), 0});
+lemlib::PoseHistory odomHistory; // recent poses, in radians
+lemlib::OdomFilter odomFilter; // only used in EKF mode
+lemlib::TrackingWheel* leftDrive = nullptr; // drivetrain encoders, used to check the other sensors
+lemlib::TrackingWheel* rightDrive = nullptr;
+// sensor health. A wheel can't move more than 5 inches in an update, is stuck if the drivetrain moves an inch while it
+// stays the same for a tenth of a second, and is compared with the drivetrain once the drivetrain moves 4 inches in a
+// window
+lemlib::SensorMonitor vertical1Monitor(5, 1, 4, 2);
+lemlib::SensorMonitor vertical2Monitor(5, 1, 4, 2);
+lemlib::SensorMonitor horizontal1Monitor(5, 1, 4, 2);
+lemlib::SensorMonitor horizontal2Monitor(5, 1, 4, 2);
+lemlib::SensorMonitor imuMonitor(0.5, 0.1, 0.3, 0.2);
+
+float prevVertical1 = 0;
+float prevVertical2 = 0;
+float prevHorizontal1 = 0;
+float prevHorizontal2 = 0;
+float prevImu = 0;
+// readings the monitors last saw. Faulted sensors keep being read, to tell when they recover
+float lastVertical1 = 0;
+float lastVertical2 = 0;
+float lastHorizontal1 = 0;
+float lastHorizontal2 = 0;
+float lastImu = 0;
+float prevLeftDrive = 0;
+float prevRightDrive = 0;
+float deltaLeftDrive = 0;
+float deltaRightDrive = 0;
+uint32_t prevTime = 0;
+
+void lemlib::setSensors(lemlib::OdomSensors sensors, lemlib::Drivetrain drivetrain) {
+    odomSensors = sensors;
+    configuredSensors = sensors;
+    drive = drivetrain;
+    // the drivetrain encoders are always read, even if they aren't substituting a tracking wheel
+    if (leftDrive == nullptr) {
+        leftDrive = new TrackingWheel(drive.leftMotors, drive.wheelDiameter, -(drive.trackWidth / 2), drive.rpm);
+        rightDrive = new TrackingWheel(drive.rightMotors, drive.wheelDiameter, drive.trackWidth / 2, drive.rpm);
+    }
+    prevLeftDrive = leftDrive->getDistanceTraveled();
+    prevRightDrive = rightDrive->getDistanceTraveled();
+    vertical1Monitor.reset();
+    vertical2Monitor.reset();
+    horizontal1Monitor.reset();
+    horizontal2Monitor.reset();
+    imuMonitor.reset();
+    if (sensors.vertical1 != nullptr) lastVertical1 = sensors.vertical1->getDistanceTraveled();
+    if (sensors.vertical2 != nullptr) lastVertical2 = sensors.vertical2->getDistanceTraveled();
+    if (sensors.horizontal1 != nullptr) lastHorizontal1 = sensors.horizontal1->getDistanceTraveled();
+    if (sensors.horizontal2 != nullptr) lastHorizontal2 = sensors.horizontal2->getDistanceTraveled();
+    if (sensors.imu != nullptr) lastImu = degToRad(sensors.imu->get_rotation());
+    if (sensors.mode == OdomMode::EKF) {
+        odomFilter.settings = sensors.ekfSettings;
+        odomFilter.setPose(odomPose);
+        prevTime = pros::millis();
+    }
+}
+
+lemlib::OdomHealth lemlib::getOdomHealth() {
+    return {vertical1Monitor.getFault(), vertical2Monitor.getFault(), horizontal1Monitor.getFault(),
+            horizontal2Monitor.getFault(), imuMonitor.getFault()};
+}
+
+lemlib::Pose lemlib::getPose(bool radians) {
+    if (radians) return odomPose;
+    else return lemlib::Pose(odomPose.x, odomPose.y, radToDeg(odomPose.theta));
+}
+
+void lemlib::setPose(lemlib::Pose pose, bool radians) {
+    if (radians) odomPose = pose;
+    else odomPose = lemlib::Pose(pose.x, pose.y, degToRad(pose.theta));
+    // readers should see the new pose straight away. If the odom task is mid publish, wait for it to finish
+    while (!odomSnapshot.tryWrite({odomPose, odomSpeed, pros::millis()})) pros::delay(1);
+    odomFilter.setPose(odomPose);
+    // poses from before the reset are in a different frame, so they can't be interpolated with
+    while (!odomHistory.reset(odomPose, pros::millis())) pros::delay(1);
+}
+
+lemlib::PoseSnapshot lemlib::getPoseSnapshot(bool radians) {
+    PoseSnapshot snapshot = odomSnapshot.read();
+    if (!radians) {
+        snapshot.pose.theta = radToDeg(snapshot.pose.theta);
+        snapshot.speed.theta = radToDeg(snapshot.speed.theta);
+    }
+    return snapshot;
+}
+
+std::optional<lemlib::Pose> lemlib::getPoseAt(uint32_t time, bool radians) {
+    std::optional<Pose> pose = odomHistory.get(time);
+    if (pose && !radians) pose->theta = radToDeg(pose->theta);
+    return pose;
+}
+
+lemlib::Pose lemlib::getSpeed(bool radians) {
+    if (radians) return odomSpeed;
+    else return lemlib::Pose(odomSpeed.x, odomSpeed.y, radToDeg(odomSpeed.theta));
+}
+
+lemlib::Pose lemlib::getLocalSpeed(bool radians) {
+    if (radians) return odomLocalSpeed;
+    else return lemlib::Pose(odomLocalSpeed.x, odomLocalSpeed.y, radToDeg(odomLocalSpeed.theta));
+}
+
+lemlib::Pose lemlib::estimatePose(float time, bool radians) {
+    // get current position and speed
+    Pose curPose = getPose(true);
+    Pose localSpeed = getLocalSpeed(true);
+    // calculate the change in local position
+    Pose deltaLocalPose = localSpeed * time;
+
+    // calculate the future pose
+    float avgHeading = curPose.theta + deltaLocalPose.theta / 2;
+    Pose futurePose = curPose;
+    futurePose.x += deltaLocalPose.y * sin(avgHeading);
+    futurePose.y += deltaLocalPose.y * cos(avgHeading);
+    futurePose.x += deltaLocalPose.x * -cos(avgHeading);
+    futurePose.y += deltaLocalPose.x * sin(avgHeading);
+    if (!radians) futurePose.theta = radToDeg(futurePose.theta);
+
+    return futurePose;
+}
+
+/**
+ * @brief Calculate the global speed and publish the new pose
+ *
+ * @param prevPose the pose before this update
+ */
+static void publish(lemlib::Pose prevPose) {
+    // calculate speed
+    odomSpeed.x = lemlib::ema((odomPose.x - prevPose.x) / 0.01, odomSpeed.x, 0.95);
+    odomSpeed.y = lemlib::ema((odomPose.y - prevPose.y) / 0.01, odomSpeed.y, 0.95);
+    odomSpeed.theta = lemlib::ema((odomPose.theta - prevPose.theta) / 0.01, odomSpeed.theta, 0.95);
+
+    // publish the new pose. Only fails if setPose is mid publish, and the next update publishes again anyway
+    odomSnapshot.tryWrite({odomPose, odomSpeed, pros::millis()});
+    odomHistory.push(odomPose, pros::millis());
+}
+
+/**
+ * @brief Check a sensor, and log it if it has just failed or recovered
+ *
+ * @param monitor the sensor's monitor
+ * @param name name of the sensor, for logging
+ * @param delta change in the sensor's reading this update
+ * @param expected change the drivetrain says the sensor should have seen
+ * @param moving whether the robot is moving
+ * @param fallback what the sensor is replaced with, for logging
+ * @return true if the sensor failed or recovered this update. The monitor's fault says which
+ */
+static bool checkSensor(lemlib::SensorMonitor& monitor, const char* name, float delta, float expected, bool moving,
+                        const char* fallback) {
+    const lemlib::SensorFault before = monitor.getFault();
+    const lemlib::SensorFault fault = monitor.update(delta, expected, moving);
+    if (fault == before) return false;
+    if (fault == lemlib::SensorFault::NONE) {
+        lemlib::telemetrySink()->warn("odom recovered,{},{},{}", pros::millis(), name, fallback);
+        lemlib::infoSink()->warn("Odom {} recovered, switching back from {}", name, fallback);
+    } else {
+        lemlib::telemetrySink()->warn("odom fault,{},{},{},{}", pros::millis(), name, lemlib::toString(fault),
+                                      fallback);
+        lemlib::infoSink()->warn("Odom {} {}, switching to {}", name, lemlib::toString(fault), fallback);
+    }
+    return true;
+}
+
+/**
+ * @brief Check every sensor against the drivetrain encoders, fail over to the drivetrain if one is faulty, and swap it
+ * back in once it recovers
+ *
+ * Runs before the sensors are used each update, so a bad reading never reaches the pose. A replacement starts from
+ * its reading at the last update, so this update's movement still counts and the pose doesn't jump.
+ */
+static void checkSensors() {
+    const float leftRaw = leftDrive->getDistanceTraveled();
+    const float rightRaw = rightDrive->getDistanceTraveled();
+    deltaLeftDrive = leftRaw - prevLeftDrive;
+    deltaRightDrive = rightRaw - prevRightDrive;
+    prevLeftDrive = leftRaw;
+    prevRightDrive = rightRaw;
+    // movement of the tracking center according to the drivetrain
+    const float forward = (deltaLeftDrive + deltaRightDrive) / 2;
+    const float turn = (deltaLeftDrive - deltaRightDrive) / drive.trackWidth;
+
+    // read every sensor first. Faulted ones too, to tell when they recover
+    auto readWheel = [](lemlib::TrackingWheel* sensor, float& last) {
+        if (sensor == nullptr || sensor->getType()) return 0.0f;
+        const float raw = sensor->getDistanceTraveled();
+        const float delta = raw - last;
+        last = raw;
+        return delta;
+    };
+    const float deltaVertical1 = readWheel(configuredSensors.vertical1, lastVertical1);
+    const float deltaVertical2 = readWheel(configuredSensors.vertical2, lastVertical2);
+    const float deltaHorizontal1 = readWheel(configuredSensors.horizontal1, lastHorizontal1);
+    const float deltaHorizontal2 = readWheel(configuredSensors.horizontal2, lastHorizontal2);
+    float deltaImu = 0;
+    if (configuredSensors.imu != nullptr) {
+        const float raw = lemlib::degToRad(configuredSensors.imu->get_rotation());
+        deltaImu = raw - lastImu;
+        lastImu = raw;
+    }
+    // the sensors are only judged while the robot is moving: the drive motors measured a velocity, since encoders can
+    // lag a read behind, and some tracking wheel turned. When every wheel froze at once the robot is stopped however
+    // much the drivetrain turned, like when it pushes against a wall. The imu drifts even then, so it doesn't count
+    auto changed = [](float delta) { return std::isfinite(delta) && delta != 0; };
+    const bool moving =
+        (drive.leftMotors->get_actual_velocity() != 0 || drive.rightMotors->get_actual_velocity() != 0) &&
+        (changed(deltaVertical1) || changed(deltaVertical2) || changed(deltaHorizontal1) || changed(deltaHorizontal2));
+
+    // vertical wheels fall back to the drivetrain side they're closest to
+    auto checkVertical = [&](lemlib::TrackingWheel* sensor, lemlib::TrackingWheel*& wheel, float delta, float raw,
+                             float& prev, lemlib::SensorMonitor& monitor, const char* name,
+                             lemlib::TrackingWheel* fallback, float fallbackDelta) {
+        if (sensor == nullptr || sensor->getType()) return;
+        const char* fallbackName = fallback == leftDrive ? "left drivetrain" : "right drivetrain";
+        if (!checkSensor(monitor, name, delta, forward - turn * sensor->getOffset(), moving, fallbackName)) return;
+        if (monitor.getFault() == lemlib::SensorFault::NONE) {
+            wheel = sensor;
+            prev = raw - delta;
+        } else {
+            wheel = fallback;
+            prev = fallback->getDistanceTraveled() - fallbackDelta;
+        }
+    };
+    checkVertical(configuredSensors.vertical1, odomSensors.vertical1, deltaVertical1, lastVertical1, prevVertical1,
+                  vertical1Monitor, "vertical1", leftDrive, deltaLeftDrive);
+    checkVertical(configuredSensors.vertical2, odomSensors.vertical2, deltaVertical2, lastVertical2, prevVertical2,
+                  vertical2Monitor, "vertical2", rightDrive, deltaRightDrive);
+
+    // horizontal wheels can only be dropped, the drivetrain can't measure sideways movement
+    auto checkHorizontal = [&](lemlib::TrackingWheel* sensor, lemlib::TrackingWheel*& wheel, float delta, float raw,
+                               float& prev, lemlib::SensorMonitor& monitor, const char* name) {
+        if (sensor == nullptr) return;
+        if (!checkSensor(monitor, name, delta, -turn * sensor->getOffset(), moving, "no horizontal wheel")) return;
+        if (monitor.getFault() == lemlib::SensorFault::NONE) {
+            wheel = sensor;
+            prev = raw - delta;
+        } else {
+            wheel = nullptr;
+        }
+    };
+    checkHorizontal(configuredSensors.horizontal1, odomSensors.horizontal1, deltaHorizontal1, lastHorizontal1,
+                    prevHorizontal1, horizontal1Monitor, "horizontal1");
+    checkHorizontal(configuredSensors.horizontal2, odomSensors.horizontal2, deltaHorizontal2, lastHorizontal2,
+                    prevHorizontal2, horizontal2Monitor, "horizontal2");
+
+    if (configuredSensors.imu != nullptr && checkSensor(imuMonitor, "imu", deltaImu, turn, moving, "tracking wheels")) {
+        if (imuMonitor.getFault() == lemlib::SensorFault::NONE) {
+            odomSensors.imu = configuredSensors.imu;
+            prevImu = lastImu - deltaImu;
+        } else {
+            odomSensors.imu = nullptr;
+        }
+    }
+}
+
+/**
+ * @brief Fuse every sensor with the kalman filter
+ */
+static void updateFilter() {
+    const uint32_t now = pros::millis();
+    // the odom task may be delayed, so use the real time between updates
+    odomFilter.predict(std::max(now - prevTime, uint32_t(1)) / 1000.0f);
+    prevTime = now;
+
+    // tracking wheels. Ones substituted by the drivetrain are skipped, the drivetrain is fused below
+    const lemlib::EkfSettings& settings = odomSensors.ekfSettings;
+    auto fuseWheel = [&](lemlib::TrackingWheel* wheel, float& prev, bool vertical) {
+        if (wheel == nullptr || wheel->getType()) return;
+        const float raw = wheel->getDistanceTraveled();
+        if (vertical) odomFilter.fuseVertical(raw - prev, wheel->getOffset(), settings.verticalNoise);
+        else odomFilter.fuseHorizontal(raw - prev, wheel->getOffset(), settings.horizontalNoise);
+        prev = raw;
+    };
+    fuseWheel(odomSensors.vertical1, prevVertical1, true);
+    fuseWheel(odomSensors.vertical2, prevVertical2, true);
+    fuseWheel(odomSensors.horizontal1, prevHorizontal1, false);
+    fuseWheel(odomSensors.horizontal2, prevHorizontal2, false);
+    // without a horizontal wheel nothing measures sideways movement, so assume there is none like classic odom does
+    if (odomSensors.horizontal1 == nullptr && odomSensors.horizontal2 == nullptr)
+        odomFilter.fuseHorizontal(0, 0, settings.driveNoise);
+
+    // drivetrain, already read by checkSensors
+    odomFilter.fuseVertical(deltaLeftDrive, leftDrive->getOffset(), settings.driveNoise);
+    odomFilter.fuseVertical(deltaRightDrive, rightDrive->getOffset(), settings.driveNoise);
+
+    // imu
+    if (odomSensors.imu != nullptr) {
+        const float imuRaw = lemlib::degToRad(odomSensors.imu->get_rotation());
+        odomFilter.fuseHeading(imuRaw - prevImu, settings.imuNoise);
+        prevImu = imuRaw;
+    }
+
+    odomFilter.integrate();
+    const lemlib::Pose prevPose = odomPose;
+    odomPose = odomFilter.getPose();
+    odomLocalSpeed = odomFilter.getLocalSpeed();
+    publish(prevPose);
+}
+
+void lemlib::update() {
+    checkSensors();
+    if (odomSensors.mode == OdomMode::EKF) {
+        updateFilter();
+        return;
+    }
+
+    // get the current sensor values
+    float vertical1Raw = 0;
+    float vertical2Raw = 0;
+    float horizontal1Raw = 0;
+    float horizontal2Raw = 0;
+    float imuRaw = 0;
+    if (odomSensors.vertical1 != nullptr) vertical1Raw = odomSensors.vertical1->getDistanceTraveled();
+    if (odomSensors.vertical2 != nullptr) vertical2Raw = odomSensors.vertical2->getDistanceTraveled();
+    if (odomSensors.horizontal1 != nullptr) horizontal1Raw = odomSensors.horizontal1->getDistanceTraveled();
+    if (odomSensors.horizontal2 != nullptr) horizontal2Raw = odomSensors.horizontal2->getDistanceTraveled();
+    if (odomSensors.imu != nullptr) imuRaw = degToRad(odomSensors.imu->get_rotation());
+
+    // calculate the change in sensor values
+    float deltaVertical1 = vertical1Raw - prevVertical1;
+    float deltaVertical2 = vertical2Raw - prevVertical2;
+    float deltaHorizontal1 = horizontal1Raw - prevHorizontal1;
+    float deltaHorizontal2 = horizontal2Raw - prevHorizontal2;
+    float deltaImu = imuRaw - prevImu;
+
+    // update the previous sensor values
+    prevVertical1 = vertical1Raw;
+    prevVertical2 = vertical2Raw;
+    prevHorizontal1 = horizontal1Raw;
+    prevHorizontal2 = horizontal2Raw;
+    prevImu = imuRaw;
+
+    // calculate the heading of the robot
+    // Priority:
+    // 1. Horizontal tracking wheels
+    // 2. Vertical tracking wheels
+    // 3. Inertial Sensor
+    // 4. Drivetrain
+    float heading = odomPose.theta;
+    // calculate the heading using the horizontal tracking wheels
+    if (odomSensors.horizontal1 != nullptr && odomSensors.horizontal2 != nullptr)
+        heading -= (deltaHorizontal1 - deltaHorizontal2) /
+                   (odomSensors.horizontal1->getOffset() - odomSensors.horizontal2->getOffset());
+    // else, if both vertical tracking wheels aren't substituted by the drivetrain, use the vertical tracking wheels
+    else if (!odomSensors.vertical1->getType() && !odomSensors.vertical2->getType())
+        heading -= (deltaVertical1 - deltaVertical2) /
+                   (odomSensors.vertical1->getOffset() - odomSensors.vertical2->getOffset());
+    // else, if the inertial sensor exists, use it
+    else if (odomSensors.imu != nullptr) heading += deltaImu;
+    // else, use the the substituted tracking wheels
+    else
+        heading -= (deltaVertical1 - deltaVertical2) /
+                   (odomSensors.vertical1->getOffset() - odomSensors.vertical2->getOffset());
+    float deltaHeading = heading - odomPose.theta;
+    float avgHeading = odomPose.theta + deltaHeading / 2;
+
+    // choose tracking wheels to use
+    // Prioritize non-powered tracking wheels
+    lemlib::TrackingWheel* verticalWheel = nullptr;
+    lemlib::TrackingWheel* horizontalWheel = nullptr;
+    if (!odomSensors.vertical1->getType()) verticalWheel = odomSensors.vertical1;
+    else if (!odomSensors.vertical2->getType()) verticalWheel = odomSensors.vertical2;
+    else verticalWheel = odomSensors.vertical1;
+    if (odomSensors.horizontal1 != nullptr) horizontalWheel = odomSensors.horizontal1;
+    else if (odomSensors.horizontal2 != nullptr) horizontalWheel = odomSensors.horizontal2;
+    float horizontalOffset = 0;
+    float verticalOffset = 0;
+    if (verticalWheel != nullptr) verticalOffset = verticalWheel->getOffset();
+    if (horizontalWheel != nullptr) horizontalOffset = horizontalWheel->getOffset();
+
+    // calculate change in x and y. Use the change already read for the wheel's slot, so it lines up with the heading
+    // and stays correct when a faulty wheel is swapped out
+    float deltaX = 0;
+    float deltaY = 0;
+    if (verticalWheel != nullptr) deltaY = verticalWheel == odomSensors.vertical1 ? deltaVertical1 : deltaVertical2;
+    if (horizontalWheel != nullptr)
+        deltaX = horizontalWheel == odomSensors.horizontal1 ? deltaHorizontal1 : deltaHorizontal2;
+
+    // calculate local x and y
+    float localX = 0;
+    float localY = 0;
+    if (deltaHeading == 0) { // prevent divide by 0
+        localX = deltaX;
+        localY = deltaY;
+    } else {
+        localX = 2 * sin(deltaHeading / 2) * (deltaX / deltaHeading + horizontalOffset);
+        localY = 2 * sin(deltaHeading / 2) * (deltaY / deltaHeading + verticalOffset);
+    }
+
+    // save previous pose
+    lemlib::Pose prevPose = odomPose;
+
+    // calculate global x and y
+    odomPose.x += localY * sin(avgHeading);
+    odomPose.y += localY * cos(avgHeading);
+    odomPose.x += localX * -cos(avgHeading);
+    odomPose.y += localX * sin(avgHeading);
+    odomPose.theta = heading;
+
+    // calculate local speed
+    odomLocalSpeed.x = ema(localX / 0.01, odomLocalSpeed.x, 0.95);
+    odomLocalSpeed.y = ema(localY / 0.01, odomLocalSpeed.y, 0.95);
+    odomLocalSpeed.theta = ema(deltaHeading / 0.01, odomLocalSpeed.theta, 0.95);
+
+    publish(prevPose);
+}
+
+void lemlib::init() {
+    if (trackingTask == nullptr) {
+        trackingTask = new PeriodicTask("odom", 10, update);
+    }
+}
@@ -0,0 +1,110 @@
+#include <cmath>
+#include "lemlib/chassis/odomFilter.hpp"
+
+lemlib::EkfSettings::EkfSettings(float verticalNoise, float horizontalNoise, float driveNoise, float imuNoise,
+                                 float forwardAccel, float lateralAccel, float angularAccel)
+    : verticalNoise(verticalNoise),
+      horizontalNoise(horizontalNoise),
+      driveNoise(driveNoise),
+      imuNoise(imuNoise),
+      forwardAccel(forwardAccel),
+      lateralAccel(lateralAccel),
+      angularAccel(angularAccel) {}
+
+lemlib::OdomFilter::OdomFilter(EkfSettings settings)
+    : settings(settings) {
+    // the robot starts still, but not certainly
+    covariance(FORWARD, FORWARD) = 1;
+    covariance(LATERAL, LATERAL) = 1;
+    covariance(OMEGA, OMEGA) = 1;
+}
+
+void lemlib::OdomFilter::setPose(Pose pose) {
+    state(X, 0) = pose.x;
+    state(Y, 0) = pose.y;
+    state(THETA, 0) = pose.theta;
+    // the new pose is known exactly, and has nothing to do with the velocity
+    for (size_t i = X; i <= THETA; i++) {
+        for (size_t j = 0; j < STATES; j++) {
+            covariance(i, j) = 0;
+            covariance(j, i) = 0;
+        }
+    }
+}
+
+void lemlib::OdomFilter::predict(float dt) {
+    this->dt = dt;
+    // velocities are a random walk, driven by acceleration
+    covariance(FORWARD, FORWARD) += std::pow(settings.forwardAccel * dt, 2);
+    covariance(LATERAL, LATERAL) += std::pow(settings.lateralAccel * dt, 2);
+    covariance(OMEGA, OMEGA) += std::pow(settings.angularAccel * dt, 2);
+}
+
+void lemlib::OdomFilter::fuseVertical(float delta, float offset, float noise) {
+    // the wheel travels the forward distance, less the arc it sweeps around the tracking center
+    Matrix<1, STATES> h;
+    h(0, FORWARD) = dt;
+    h(0, OMEGA) = -offset * dt;
+    fuse(h, delta, noise);
+}
+
+void lemlib::OdomFilter::fuseHorizontal(float delta, float offset, float noise) {
+    Matrix<1, STATES> h;
+    h(0, LATERAL) = dt;
+    h(0, OMEGA) = -offset * dt;
+    fuse(h, delta, noise);
+}
+
+void lemlib::OdomFilter::fuseHeading(float delta, float noise) {
+    Matrix<1, STATES> h;
+    h(0, OMEGA) = dt;
+    fuse(h, delta, noise);
+}
+
+void lemlib::OdomFilter::fuse(const Matrix<1, STATES>& h, float reading, float noise) {
+    // readings are scalar, so the innovation covariance is too and no matrix has to be inverted
+    const Vector<STATES> ph = covariance * h.transpose();
+    const float innovationCovariance = (h * ph)(0, 0) + noise * noise;
+    if (innovationCovariance <= 0) return;
+    const Vector<STATES> gain = ph * (1 / innovationCovariance);
+    const float innovation = reading - (h * state)(0, 0);
+    state = state + gain * innovation;
+    covariance = covariance - gain * ph.transpose();
+}
+
+void lemlib::OdomFilter::integrate() {
+    const float deltaHeading = state(OMEGA, 0) * dt;
+    const float avgHeading = state(THETA, 0) + deltaHeading / 2;
+    // the robot moves along an arc, so the distance between the start and end is a chord
+    const float chord = deltaHeading == 0 ? 1 : 2 * std::sin(deltaHeading / 2) / deltaHeading;
+    const float localY = state(FORWARD, 0) * dt * chord;
+    const float localX = state(LATERAL, 0) * dt * chord;
+    const float s = std::sin(avgHeading);
+    const float c = std::cos(avgHeading);
+
+    // jacobian of the motion, treating the chord correction as constant
+    Matrix<STATES, STATES> f = Matrix<STATES, STATES>::identity();
+    const float dxdTheta = localY * c + localX * s;
+    const float dydTheta = -localY * s + localX * c;
+    f(X, THETA) = dxdTheta;
+    f(Y, THETA) = dydTheta;
+    f(X, FORWARD) = dt * chord * s;
+    f(X, LATERAL) = -dt * chord * c;
+    f(Y, FORWARD) = dt * chord * c;
+    f(Y, LATERAL) = dt * chord * s;
+    f(X, OMEGA) = dxdTheta * dt / 2;
+    f(Y, OMEGA) = dydTheta * dt / 2;
+    f(THETA, OMEGA) = dt;
+
+    // same motion model as classic odom
+    state(X, 0) += localY * s - localX * c;
+    state(Y, 0) += localY * c + localX * s;
+    state(THETA, 0) += deltaHeading;
+    covariance = f * covariance * f.transpose();
+}
+
+lemlib::Pose lemlib::OdomFilter::getPose() const { return Pose(state(X, 0), state(Y, 0), state(THETA, 0)); }
+
+lemlib::Pose lemlib::OdomFilter::getLocalSpeed() const {
+    return Pose(state(LATERAL, 0), state(FORWARD, 0), state(OMEGA, 0));
+}
@@ -0,0 +1,54 @@
+#include <cmath>
+#include "lemlib/chassis/chassis.hpp"
+
+void lemlib::Chassis::tank(int left, int right, bool disableDriveCurve) {
+    // use drive curves if they are enabled
+    if (!disableDriveCurve) {
+        left = throttleCurve->curve(left);
+        right = throttleCurve->curve(right);
+    }
+    // move the motors
+    drivetrain.leftMotors->move(left);
+    drivetrain.rightMotors->move(right);
+}
+
+void lemlib::Chassis::arcade(int throttle, int turn, bool disableDriveCurve, float desaturateBias) {
+    // use drive curves if they are enabled
+    if (!disableDriveCurve) {
+        throttle = throttleCurve->curve(throttle);
+        turn = steerCurve->curve(turn);
+    }
+    // desaturate motors based on joyBias
+    if (std::abs(throttle) + std::abs(turn) > 127) {
+        int oldThrottle = throttle;
+        int oldTurn = turn;
+        throttle *= (1 - desaturateBias * std::abs(oldTurn / 127.0));
+        turn *= (1 - (1 - desaturateBias) * std::abs(oldThrottle / 127.0));
+    }
+    // calculate and move the motors
+    int leftPower = throttle + turn;
+    int rightPower = throttle - turn;
+    drivetrain.leftMotors->move(leftPower);
+    drivetrain.rightMotors->move(rightPower);
+}
+
+void lemlib::Chassis::curvature(int throttle, int turn, bool disableDriveCurve) {
+    // If we're not moving forwards change to arcade drive
+    if (throttle == 0) {
+        arcade(throttle, turn, disableDriveCurve);
+        return;
+    }
+
+    float leftPower = throttle + (std::abs(throttle) * turn) / 127.0;
+    float rightPower = throttle - (std::abs(throttle) * turn) / 127.0;
+
+    // use drive curves if they are enabled
+    if (!disableDriveCurve) {
+        leftPower = throttleCurve->curve(leftPower);
+        rightPower = throttleCurve->curve(rightPower);
+    }
+
+    // move the motors
+    drivetrain.leftMotors->move(leftPower);
+    drivetrain.rightMotors->move(rightPower);
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include "lemlib/chassis/poseHistory.hpp"
+
+uint32_t lemlib::PoseHistory::write(const Pose& pose, uint32_t time) {
+    const uint32_t index = next.load(std::memory_order_relaxed);
+    // only this task writes slots, so the write can't fail
+    slots[index % CAPACITY].tryWrite({pose, time, index});
+    return index;
+}
+
+bool lemlib::PoseHistory::push(const Pose& pose, uint32_t time) {
+    if (writing.exchange(true, std::memory_order_acquire)) return false;
+    const uint32_t index = write(pose, time);
+    next.store(index + 1, std::memory_order_release);
+    writing.store(false, std::memory_order_release);
+    return true;
+}
+
+bool lemlib::PoseHistory::reset(const Pose& pose, uint32_t time) {
+    if (writing.exchange(true, std::memory_order_acquire)) return false;
+    const uint32_t index = write(pose, time);
+    // first is stored before next, so a lookup that sees the new pose also sees the old ones dropped
+    first.store(index, std::memory_order_release);
+    next.store(index + 1, std::memory_order_release);
+    writing.store(false, std::memory_order_release);
+    return true;
+}
+
+std::optional<lemlib::PoseHistory::Sample> lemlib::PoseHistory::at(uint32_t index) const {
+    const Sample sample = slots[index % CAPACITY].read();
+    if (sample.index != index) return std::nullopt;
+    return sample;
+}
+
+bool lemlib::PoseHistory::find(uint32_t time, std::optional<Pose>& pose) const {
+    pose = std::nullopt;
+    const uint32_t end = next.load(std::memory_order_acquire);
+    const uint32_t start = std::max(first.load(std::memory_order_acquire), end > CAPACITY ? end - uint32_t(CAPACITY) : 0u);
+    if (start >= end) return true;
+
+    // out of range
+    const std::optional<Sample> oldest = at(start);
+    const std::optional<Sample> latest = at(end - 1);
+    if (!oldest || !latest) return false;
+    if (time < oldest->time) return true;
+    if (time >= latest->time) {
+        pose = latest->pose;
+        return true;
+    }
+
+    // binary search for the first sample newer than the time
+    uint32_t low = start + 1;
+    uint32_t high = end - 1;
+    while (low < high) {
+        const uint32_t mid = low + (high - low) / 2;
+        const std::optional<Sample> sample = at(mid);
+        if (!sample) return false;
+        if (sample->time > time) high = mid;
+        else low = mid + 1;
+    }
+    const std::optional<Sample> before = at(low - 1);
+    const std::optional<Sample> after = at(low);
+    if (!before || !after) return false;
+
+    // interpolate between the samples either side. Pose::lerp keeps theta constant, but odom heading is never
+    // wrapped so it can be interpolated the same way as x and y
+    const float t = float(time - before->time) / float(after->time - before->time);
+    pose = before->pose.lerp(after->pose, t);
+    pose->theta = before->pose.theta + (after->pose.theta - before->pose.theta) * t;
+    return true;
+}
+
+std::optional<lemlib::Pose> lemlib::PoseHistory::get(uint32_t time) const {
+    std::optional<Pose> pose;
+    while (!find(time, pose));
+    return pose;
+}
+
+size_t lemlib::PoseHistory::size() const {
+    const uint32_t end = next.load(std::memory_order_acquire);
+    const uint32_t start = std::max(first.load(std::memory_order_acquire), end > CAPACITY ? end - uint32_t(CAPACITY) : 0u);
+    return start >= end ? 0 : end - start;
+}
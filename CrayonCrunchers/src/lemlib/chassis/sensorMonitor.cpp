@@ -0,0 +1,86 @@
+#include <cmath>
+#include "lemlib/chassis/sensorMonitor.hpp"
+
+const char* lemlib::toString(SensorFault fault) {
+    switch (fault) {
+        case SensorFault::NONE: return "none";
+        case SensorFault::DISCONNECTED: return "disconnected";
+        case SensorFault::STUCK: return "stuck";
+        case SensorFault::DISAGREES: return "disagrees with drivetrain";
+    }
+    return "unknown";
+}
+
+lemlib::SensorMonitor::SensorMonitor(float maxDelta, float stuckTravel, float minTravel, float tolerance)
+    : maxDelta(maxDelta),
+      stuckTravel(stuckTravel),
+      minTravel(minTravel),
+      tolerance(tolerance) {}
+
+lemlib::SensorFault lemlib::SensorMonitor::update(float delta, float expected, bool moving) {
+    // PROS returns PROS_ERR or infinity when a device is unplugged, which turns into a huge or non finite change
+    if (!std::isfinite(delta) || std::fabs(delta) > maxDelta) {
+        if (fault == SensorFault::NONE) {
+            fault = SensorFault::DISCONNECTED;
+            streak = 0;
+        }
+        // a sensor being plugged back in jumps too, so it has to agree for whole windows after its last bad reading
+        clearWindow();
+        return fault;
+    }
+
+    if (delta != 0) {
+        stillTravel = 0;
+        stillReadings = 0;
+    }
+    // while the robot isn't moving, the drivetrain turning says nothing about the sensor
+    if (!moving) return fault;
+    if (delta == 0) {
+        stillTravel += std::fabs(expected);
+        stillReadings++;
+    }
+    if (fault == SensorFault::NONE && stillReadings >= STUCK_READINGS && stillTravel > stuckTravel) {
+        fault = SensorFault::STUCK;
+        streak = 0;
+        clearWindow();
+        return fault;
+    }
+
+    travel += delta;
+    expectedTravel += expected;
+    drivetrainTravel += std::fabs(expected);
+    if (++readings < WINDOW) return fault;
+
+    // judge the window. Only when the drivetrain moved enough for the difference to mean anything
+    const bool judged = drivetrainTravel > minTravel;
+    const bool disagrees = judged && std::fabs(travel - expectedTravel) > tolerance + 0.5 * drivetrainTravel;
+    clearWindow();
+    if (fault == SensorFault::NONE) {
+        streak = disagrees ? streak + 1 : 0;
+        if (streak < 2) return fault;
+        fault = SensorFault::DISAGREES;
+    } else {
+        streak = judged && !disagrees ? streak + 1 : 0;
+        if (streak < 2) return fault;
+        fault = SensorFault::NONE;
+        stillTravel = 0;
+        stillReadings = 0;
+    }
+    streak = 0;
+    return fault;
+}
+
+void lemlib::SensorMonitor::clearWindow() {
+    travel = 0;
+    expectedTravel = 0;
+    drivetrainTravel = 0;
+    readings = 0;
+}
+
+void lemlib::SensorMonitor::reset() {
+    fault = SensorFault::NONE;
+    streak = 0;
+    stillTravel = 0;
+    stillReadings = 0;
+    clearWindow();
+}
@@ -0,0 +1,71 @@
+#include "pros/rtos.hpp"
+#include "lemlib/controllerBindings.hpp"
+
+namespace lemlib {
+ControllerBindings::ControllerBindings(pros::Controller* controller, std::initializer_list<Binding> bindings,
+                                       std::initializer_list<pros::controller_analog_e_t> channels,
+                                       std::initializer_list<pros::controller_digital_e_t> buttons,
+                                       uint32_t doubleTapTime)
+    : controller(controller),
+      bindings(bindings),
+      doubleTapTime(doubleTapTime) {
+    for (const Binding& binding : bindings) buttonMask |= ControllerSnapshot::bit(binding.button);
+    for (pros::controller_digital_e_t button : buttons) buttonMask |= ControllerSnapshot::bit(button);
+    for (pros::controller_analog_e_t channel : channels) channelMask |= 1u << channel;
+}
+
+const ControllerSnapshot& ControllerBindings::update() {
+    ControllerSnapshot next;
+    next.time = pros::millis();
+    // only what is used, since each read takes time
+    for (int channel = 0; channel < int(next.analog.size()); channel++) {
+        if (!(channelMask & (1u << channel))) continue;
+        next.analog[channel] = controller->get_analog(static_cast<pros::controller_analog_e_t>(channel));
+    }
+    for (int i = 0; i < ControllerSnapshot::BUTTONS; i++) {
+        const auto button = static_cast<pros::controller_digital_e_t>(pros::E_CONTROLLER_DIGITAL_L1 + i);
+        if (!(buttonMask & ControllerSnapshot::bit(button))) continue;
+        if (controller->get_digital(button)) next.held |= ControllerSnapshot::bit(button);
+    }
+    next.pressed = next.held & ~snapshot.held;
+    next.released = snapshot.held & ~next.held;
+    snapshot = next;
+
+    for (Binding& binding : bindings) {
+        const bool pressed = snapshot.isPressed(binding.button);
+        switch (binding.trigger) {
+            case Trigger::PRESS:
+                if (pressed) binding.action(true);
+                break;
+            case Trigger::RELEASE:
+                if (snapshot.isReleased(binding.button)) binding.action(false);
+                break;
+            case Trigger::HOLD: binding.action(snapshot.isHeld(binding.button)); break;
+            case Trigger::TOGGLE:
+                if (pressed) {
+                    binding.state = !binding.state;
+                    binding.action(binding.state);
+                }
+                break;
+            case Trigger::DOUBLE_TAP:
+                if (!pressed) break;
+                // a third press starts a new double tap, rather than finishing another
+                if (binding.lastPress != 0 && snapshot.time - binding.lastPress <= doubleTapTime) {
+                    binding.lastPress = 0;
+                    binding.action(true);
+                } else {
+                    binding.lastPress = snapshot.time;
+                }
+                break;
+        }
+    }
+    return snapshot;
+}
+
+bool ControllerBindings::isToggled(pros::controller_digital_e_t button) const {
+    for (const Binding& binding : bindings) {
+        if (binding.button == button && binding.trigger == Trigger::TOGGLE) return binding.state;
+    }
+    return false;
+}
+} // namespace lemlib
@@ -0,0 +1,105 @@
+#include <cstring>
+#include "lemlib/logger/baseSink.hpp"
+
+namespace lemlib {
+BaseSink::BaseSink(std::initializer_list<std::shared_ptr<BaseSink>> sinks)
+    : sinks(sinks) {}
+
+void BaseSink::setLowestLevel(Level level) {
+    // if there are sinks, set the lowest level for all of them
+    if (!sinks.empty()) {
+        for (const std::shared_ptr<BaseSink>& sink : sinks) { sink->setLowestLevel(level); }
+        return;
+    }
+
+    lowestLevel = level;
+}
+
+void BaseSink::setFormat(const std::string& format) {
+    // if there are sinks, set the format for all of them
+    if (!sinks.empty()) {
+        for (const std::shared_ptr<BaseSink>& sink : sinks) { sink->setFormat(format); }
+        return;
+    }
+
+    logFormat = format;
+    // split the format into literal text and fields once, so logging doesn't have to parse it
+    formatSegments.clear();
+    formatLiterals.clear();
+    simpleFormat = true;
+    auto addLiteral = [&](char c) {
+        if (formatSegments.empty() || formatSegments.back().field != Field::LITERAL)
+            formatSegments.push_back({Field::LITERAL, formatLiterals.size(), 0});
+        formatLiterals.push_back(c);
+        formatSegments.back().length++;
+    };
+    for (size_t i = 0; i < format.size(); i++) {
+        const char c = format.at(i);
+        // double brackets are single brackets
+        if ((c == '{' || c == '}') && i + 1 < format.size() && format.at(i + 1) == c) {
+            addLiteral(c);
+            i++;
+        } else if (c == '{') {
+            const size_t end = format.find('}', i);
+            const std::string_view name = end == std::string::npos
+                                              ? std::string_view()
+                                              : std::string_view(format).substr(i + 1, end - i - 1);
+            if (name == "time") formatSegments.push_back({Field::TIME, 0, 0});
+            else if (name == "level") formatSegments.push_back({Field::LEVEL, 0, 0});
+            else if (name == "message") formatSegments.push_back({Field::MESSAGE, 0, 0});
+            else {
+                // extra named arguments or format specs, leave it to fmt
+                simpleFormat = false;
+                return;
+            }
+            i = end;
+        } else {
+            addLiteral(c);
+        }
+    }
+}
+
+void BaseSink::sendFormatted(Level level, std::string_view text) {
+    Message message = Message {.level = level, .time = pros::millis()};
+
+    if (!simpleFormat) {
+        // get the arguments. This path allocates, but only sinks with custom arguments take it
+        fmt::dynamic_format_arg_store<fmt::format_context> formattingArgs = getExtraFormattingArgs(message);
+
+        formattingArgs.push_back(fmt::arg("time", message.time));
+        formattingArgs.push_back(fmt::arg("level", message.level));
+        formattingArgs.push_back(fmt::arg("message", text));
+
+        const std::string formattedString = fmt::vformat(logFormat, std::move(formattingArgs));
+        message.message = formattedString;
+        sendMessage(message);
+        return;
+    }
+
+    char* out = outputBuffer.data();
+    char* const end = outputBuffer.data() + outputBuffer.size();
+    auto append = [&](std::string_view string) {
+        const size_t length = std::min(string.size(), size_t(end - out));
+        std::memcpy(out, string.data(), length);
+        out += length;
+    };
+    for (const FormatSegment& segment : formatSegments) {
+        switch (segment.field) {
+            case Field::LITERAL:
+                append(std::string_view(formatLiterals).substr(segment.start, segment.length));
+                break;
+            case Field::TIME: out = fmt::format_to_n(out, end - out, "{}", message.time).out; break;
+            case Field::LEVEL: append(format_as(level)); break;
+            case Field::MESSAGE: append(text); break;
+        }
+    }
+    message.message = std::string_view(outputBuffer.data(), out - outputBuffer.data());
+    sendMessage(message);
+}
+
+void BaseSink::sendMessage(const Message& message) {}
+
+fmt::dynamic_format_arg_store<fmt::format_context> BaseSink::getExtraFormattingArgs(const Message& messageInfo) {
+    return {};
+}
+} // namespace lemlib
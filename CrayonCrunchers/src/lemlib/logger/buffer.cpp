@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cstring>
+#include "lemlib/logger/buffer.hpp"
+
+namespace lemlib {
+Buffer::Buffer(std::function<void(std::string_view)> bufferFunc, const char* name)
+    : bufferFunc(bufferFunc),
+      task(name, 50, [this]() { drain(); }) {}
+
+Buffer::~Buffer() {}
+
+Buffer::Ring* Buffer::acquireRing() {
+    const uintptr_t self = reinterpret_cast<uintptr_t>(pros::c::task_get_current());
+    // the ring this task already has
+    for (Ring& ring : rings) {
+        uintptr_t owner = ring.owner.load(std::memory_order_relaxed);
+        if ((owner & ~uintptr_t(1)) != self) continue;
+        owner = self;
+        if (ring.owner.compare_exchange_strong(owner, self | 1, std::memory_order_acquire)) return &ring;
+        // the buffer's task is checking if it can free the ring. Taking another ring could reorder this task's
+        // strings, so give up on this one
+        if (owner == (self | 1)) return nullptr;
+        // it freed the ring, which means it was empty, so any ring will do. Another task may even have claimed it
+        // already
+        break;
+    }
+    // otherwise claim a free one
+    for (Ring& ring : rings) {
+        uintptr_t owner = 0;
+        if (ring.owner.compare_exchange_strong(owner, self | 1, std::memory_order_acquire)) return &ring;
+    }
+    return nullptr;
+}
+
+bool Buffer::pushToBuffer(std::string_view bufferData) {
+    Ring* ring = acquireRing();
+    if (ring == nullptr) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    const bool full = tail - ring->head.load(std::memory_order_acquire) >= SLOTS;
+    if (full) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        if (bufferData.size() > SLOT_SIZE) truncated.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = ring->slots[tail % SLOTS];
+        slot.length = std::min(bufferData.size(), SLOT_SIZE);
+        std::memcpy(slot.data.data(), bufferData.data(), slot.length);
+        ring->tail.store(tail + 1, std::memory_order_release);
+    }
+    // not busy anymore
+    ring->owner.store(reinterpret_cast<uintptr_t>(pros::c::task_get_current()), std::memory_order_release);
+    return !full;
+}
+
+void Buffer::drain() {
+    // take up to burst strings, going around the rings so one busy task can't starve the others
+    for (size_t taken = 0; taken < burst; taken++) {
+        bool found = false;
+        for (size_t i = 0; i < rings.size() && !found; i++) {
+            Ring& ring = rings[(nextRing + i) % rings.size()];
+            const uint32_t head = ring.head.load(std::memory_order_relaxed);
+            if (ring.tail.load(std::memory_order_acquire) == head) continue;
+            const Slot& slot = ring.slots[head % SLOTS];
+            bufferFunc(std::string_view(slot.data.data(), slot.length));
+            ring.head.store(head + 1, std::memory_order_release);
+            nextRing = (nextRing + i + 1) % rings.size();
+            found = true;
+        }
+        if (!found) break;
+    }
+    // free empty rings, so tasks that ended don't keep theirs. Strings from a task stay in order, since its ring
+    // is only freed once everything in it has been processed
+    for (Ring& ring : rings) {
+        uintptr_t owner = ring.owner.load(std::memory_order_relaxed);
+        if (owner == 0 || (owner & 1)) continue;
+        // hold the busy bit while checking, so the producer can't push in between
+        if (!ring.owner.compare_exchange_strong(owner, owner | 1, std::memory_order_acquire)) continue;
+        const bool empty = ring.tail.load(std::memory_order_acquire) == ring.head.load(std::memory_order_relaxed);
+        ring.owner.store(empty ? 0 : owner, std::memory_order_release);
+    }
+}
+
+bool Buffer::buffersEmpty() {
+    for (const Ring& ring : rings) {
+        if (ring.tail.load(std::memory_order_acquire) != ring.head.load(std::memory_order_relaxed)) return false;
+    }
+    return true;
+}
+
+uint32_t Buffer::getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+uint32_t Buffer::getTruncated() const { return truncated.load(std::memory_order_relaxed); }
+
+void Buffer::setRate(uint32_t rate) { task.setPeriod(rate); }
+
+void Buffer::setBurst(size_t burst) { this->burst = std::max(burst, size_t(1)); }
+} // namespace lemlib
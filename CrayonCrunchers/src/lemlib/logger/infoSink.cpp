@@ -0,0 +1,16 @@
+#include "lemlib/logger/infoSink.hpp"
+#include "lemlib/logger/stdout.hpp"
+
+namespace lemlib {
+InfoSink::InfoSink() { setFormat("[LemLib] {level}: {message}"); }
+
+void InfoSink::sendMessage(const Message& message) {
+    switch (message.level) {
+        case Level::DEBUG: bufferedStdout().print("\033[0;36m{}\033[0m\n", message.message); break;
+        case Level::INFO: bufferedStdout().print("\033[0;32m{}\033[0m\n", message.message); break;
+        case Level::WARN: bufferedStdout().print("\033[0;33m{}\033[0m\n", message.message); break;
+        case Level::ERROR: bufferedStdout().print("\033[0;31m{}\033[0m\n", message.message); break;
+        case Level::FATAL: bufferedStdout().print("\033[0;31;2m{}\033[0m\n", message.message); break;
+    }
+}
+} // namespace lemlib
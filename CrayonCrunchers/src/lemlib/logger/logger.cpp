@@ -0,0 +1,19 @@
+#include "lemlib/logger/logger.hpp"
+
+namespace lemlib {
+// returned by reference, so logging doesn't copy the shared_ptr
+const std::shared_ptr<InfoSink>& infoSink() {
+    static std::shared_ptr<InfoSink> infoSink = std::make_shared<InfoSink>();
+    return infoSink;
+}
+
+const std::shared_ptr<TelemetrySink>& telemetrySink() {
+    static std::shared_ptr<TelemetrySink> telemetrySink = std::make_shared<TelemetrySink>();
+    return telemetrySink;
+}
+
+const std::shared_ptr<RecorderSink>& recorderSink() {
+    static std::shared_ptr<RecorderSink> recorderSink = std::make_shared<RecorderSink>();
+    return recorderSink;
+}
+} // namespace lemlib
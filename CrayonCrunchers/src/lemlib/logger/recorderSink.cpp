@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstring>
+#include "pros/misc.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/logger/recorderSink.hpp"
+
+namespace lemlib {
+namespace {
+// written after partly full chunks, to pad them to a whole sector. Decoders skip the empty frames the 0s make
+const std::array<uint8_t, RecorderSink::SECTOR_SIZE> zeros {};
+} // namespace
+
+RecorderSink::RecorderSink() {
+    setFormat("{message}");
+    encodeSchema(LOG_CHANNEL, "log", {"level", "message"});
+}
+
+bool RecorderSink::start(const char* directory) {
+    if (!pros::usd::is_installed()) return false;
+    if (frameBuffer == nullptr) {
+        this->directory = directory;
+        frameBuffer = std::make_unique<Buffer>([this](std::string_view data) { record(data); }, "recorder");
+        // copying a frame into a chunk is quick, so take a lot of them at once
+        frameBuffer->setRate(5);
+        frameBuffer->setBurst(32);
+        // the card can take tens of milliseconds to write, so it waits for everything else
+        writer = std::make_unique<PeriodicTask>("sd writer", 20, [this]() { writePending(); }, TASK_PRIORITY_MIN + 1);
+    }
+    recording.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool RecorderSink::pushCommand(Command command) {
+    if (!isRecording()) return false;
+    const char byte = static_cast<char>(command);
+    // the ring fills up when a task sends a burst, like the messages disabled() logs before it flushes. The buffer's
+    // task empties it every period, so try again after one
+    for (int tries = 0; tries < COMMAND_RETRIES; tries++) {
+        if (frameBuffer->pushToBuffer(std::string_view(&byte, 1))) return true;
+        pros::delay(5);
+    }
+    return false;
+}
+
+bool RecorderSink::rotate() { return pushCommand(Command::ROTATE); }
+
+bool RecorderSink::flush() { return pushCommand(Command::FLUSH); }
+
+void RecorderSink::encodeSchema(uint8_t channel, std::string_view name,
+                                std::initializer_list<std::string_view> fields) {
+    TelemetryFrame frame(TelemetryFrame::SCHEMA_CHANNEL, pros::millis());
+    frame.add(channel);
+    frame.add(name);
+    for (std::string_view field : fields) frame.add(field);
+    schemaMutex.take();
+    schemaSizes[channel] = frame.encode(schemas[channel].data());
+    schemaMutex.give();
+}
+
+void RecorderSink::defineChannel(uint8_t channel, std::string_view name,
+                                 std::initializer_list<std::string_view> fields) {
+    if (channel == TelemetryFrame::SCHEMA_CHANNEL || channel >= LOG_CHANNEL) return;
+    encodeSchema(channel, name, fields);
+}
+
+void RecorderSink::sendMessage(const Message& message) {
+    if (!isRecording()) return;
+    TelemetryFrame frame(LOG_CHANNEL, message.time);
+    frame.add(format_as(message.level));
+    // cut long messages short, so the message isn't left out of the frame
+    frame.add(message.message.substr(0, TelemetryFrame::MAX_PAYLOAD - 16));
+    sendFrame(frame);
+}
+
+void RecorderSink::sendFrame(const TelemetryFrame& frame) {
+    std::array<uint8_t, TelemetryFrame::MAX_ENCODED_SIZE> encoded;
+    const size_t size = frame.encode(encoded.data());
+    if (!frameBuffer->pushToBuffer(std::string_view(reinterpret_cast<const char*>(encoded.data()), size))) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void RecorderSink::record(std::string_view data) {
+    const uint32_t pending = filled.load(std::memory_order_relaxed) - written.load(std::memory_order_acquire);
+    if (data.size() == 1) {
+        if (data[0] == static_cast<char>(Command::ROTATE)) {
+            // the writer still has every chunk, so end the file with the next one
+            if (pending < CHUNKS) handOver(true);
+            else endPending = true;
+        } else if (fill > 0 && pending < CHUNKS) {
+            handOver(false);
+        }
+        return;
+    }
+    // frames fill chunks right to the end and carry on into the next one, so the card only gets whole sectors. Drop
+    // the frame if it doesn't fit, rather than write part of it
+    if ((CHUNKS - pending) * CHUNK_SIZE - fill < data.size()) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (fill == 0) chunkStart = pros::millis();
+    while (!data.empty()) {
+        Chunk& chunk = chunks[filled.load(std::memory_order_relaxed) % CHUNKS];
+        const size_t size = std::min(CHUNK_SIZE - fill, data.size());
+        std::memcpy(&chunk.data[fill], data.data(), size);
+        fill += size;
+        data.remove_prefix(size);
+        if (fill == CHUNK_SIZE) handOver(false);
+    }
+    // write a partly full chunk every so often, so little is lost if the robot is turned off
+    if (fill > 0 && pros::millis() - chunkStart >= FLUSH_PERIOD) handOver(false);
+}
+
+void RecorderSink::handOver(bool endsFile) {
+    const uint32_t index = filled.load(std::memory_order_relaxed);
+    Chunk& chunk = chunks[index % CHUNKS];
+    const size_t padded = (fill + SECTOR_SIZE - 1) / SECTOR_SIZE * SECTOR_SIZE;
+    std::memset(&chunk.data[fill], 0, padded - fill);
+    chunk.size = padded;
+    chunk.endsFile = endsFile || endPending;
+    endPending = false;
+    fill = 0;
+    filled.store(index + 1, std::memory_order_release);
+}
+
+void RecorderSink::openFile() {
+    char path[64];
+    // find the first name that isn't taken, so files from earlier runs are kept
+    for (; fileIndex < MAX_FILES; fileIndex++) {
+        std::snprintf(path, sizeof(path), "%srec_%03d.bin", directory, fileIndex);
+        FILE* existing = std::fopen(path, "rb");
+        if (existing == nullptr) break;
+        std::fclose(existing);
+    }
+    if (fileIndex == MAX_FILES) {
+        // never write over a recording from an earlier run
+        if (recording.exchange(false, std::memory_order_relaxed))
+            infoSink()->error("Recorder stopped, every file name in {} is taken", directory);
+        return;
+    }
+    file = std::fopen(path, "wb");
+    fileIndex++;
+    fileSize = 0;
+    if (file == nullptr) return;
+    size_t headerSize = 0;
+    schemaMutex.take();
+    for (size_t channel = 0; channel < MAX_CHANNELS; channel++) {
+        std::memcpy(&header[headerSize], schemas[channel].data(), schemaSizes[channel]);
+        headerSize += schemaSizes[channel];
+    }
+    schemaMutex.give();
+    fileSize += std::fwrite(header.data(), 1, headerSize, file);
+    fileSize += std::fwrite(zeros.data(), 1, (SECTOR_SIZE - fileSize % SECTOR_SIZE) % SECTOR_SIZE, file);
+    bytesWritten.fetch_add(fileSize, std::memory_order_relaxed);
+}
+
+void RecorderSink::writePending() {
+    for (uint32_t index = written.load(std::memory_order_relaxed); index != filled.load(std::memory_order_acquire);
+         index++) {
+        const Chunk& chunk = chunks[index % CHUNKS];
+        if (chunk.size > 0) {
+            if (file == nullptr) openFile();
+            if (file != nullptr) {
+                const size_t size = std::fwrite(chunk.data.data(), 1, chunk.size, file);
+                std::fflush(file);
+                fileSize += size;
+                bytesWritten.fetch_add(size, std::memory_order_relaxed);
+            }
+        }
+        if (file != nullptr && (chunk.endsFile || fileSize >= MAX_FILE_SIZE)) {
+            std::fclose(file);
+            file = nullptr;
+        }
+        written.store(index + 1, std::memory_order_release);
+    }
+}
+
+uint32_t RecorderSink::getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+uint32_t RecorderSink::getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+} // namespace lemlib
@@ -0,0 +1,14 @@
+#include <iostream>
+#include "lemlib/logger/stdout.hpp"
+
+namespace lemlib {
+BufferedStdout::BufferedStdout()
+    : Buffer([](std::string_view text) { std::cout << text << std::flush; }, "stdout") {
+    setRate(50);
+}
+
+BufferedStdout& bufferedStdout() {
+    static BufferedStdout bufferedStdout;
+    return bufferedStdout;
+}
+} // namespace lemlib
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstring>
+#include "lemlib/logger/telemetryFrame.hpp"
+
+namespace lemlib {
+namespace {
+// CRC-16/CCITT-FALSE
+uint16_t crc16(const uint8_t* data, size_t size) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= uint16_t(data[i]) << 8;
+        for (int bit = 0; bit < 8; bit++) crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+// the brain and every host we decode on are little endian, so values are copied as they are
+uint32_t readU32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, 4);
+    return value;
+}
+} // namespace
+
+TelemetryFrame::TelemetryFrame(uint8_t channel, uint32_t time) {
+    data[0] = channel;
+    std::memcpy(&data[1], &time, 4);
+}
+
+void TelemetryFrame::addField(TelemetryType type, const void* value, size_t size) {
+    if (this->size + 1 + size > data.size()) {
+        truncated = true;
+        return;
+    }
+    data[this->size++] = static_cast<uint8_t>(type);
+    std::memcpy(&data[this->size], value, size);
+    this->size += size;
+}
+
+void TelemetryFrame::addString(std::string_view string) {
+    const uint8_t length = std::min(string.size(), size_t(255));
+    if (size + 2 + length > data.size()) {
+        truncated = true;
+        return;
+    }
+    data[size++] = static_cast<uint8_t>(TelemetryType::STRING);
+    data[size++] = length;
+    std::memcpy(&data[size], string.data(), length);
+    size += length;
+}
+
+size_t TelemetryFrame::encode(uint8_t* out) const {
+    const uint16_t crc = crc16(data.data(), size);
+    const uint8_t crcBytes[2] = {uint8_t(crc & 0xFF), uint8_t(crc >> 8)};
+    // COBS: every 0 is replaced by the distance to the next one, with a code byte in front of each run
+    size_t codeIndex = 0;
+    size_t written = 1;
+    uint8_t code = 1;
+    auto put = [&](uint8_t byte) {
+        if (byte != 0) {
+            out[written++] = byte;
+            code++;
+        }
+        if (byte == 0 || code == 0xFF) {
+            out[codeIndex] = code;
+            codeIndex = written++;
+            code = 1;
+        }
+    };
+    for (size_t i = 0; i < size; i++) put(data[i]);
+    put(crcBytes[0]);
+    put(crcBytes[1]);
+    out[codeIndex] = code;
+    out[written++] = 0;
+    return written;
+}
+
+bool decodeTelemetryFrame(const uint8_t* encoded, size_t size, uint8_t* scratch, DecodedTelemetryFrame& frame) {
+    // undo the COBS encoding
+    size_t length = 0;
+    for (size_t i = 0; i < size;) {
+        const uint8_t code = encoded[i++];
+        if (code == 0 || i + code - 1 > size) return false;
+        for (int j = 1; j < code; j++) {
+            if (encoded[i] == 0) return false;
+            scratch[length++] = encoded[i++];
+        }
+        if (code != 0xFF && i < size) scratch[length++] = 0;
+    }
+    // channel, timestamp and CRC at least
+    if (length < 7) return false;
+    const uint16_t crc = scratch[length - 2] | uint16_t(scratch[length - 1]) << 8;
+    length -= 2;
+    if (crc16(scratch, length) != crc) return false;
+
+    frame.channel = scratch[0];
+    frame.time = readU32(&scratch[1]);
+    frame.fieldCount = 0;
+    for (size_t i = 5; i < length;) {
+        if (frame.fieldCount == int(frame.fields.size())) return false;
+        TelemetryField& field = frame.fields[frame.fieldCount++];
+        field.type = static_cast<TelemetryType>(scratch[i++]);
+        switch (field.type) {
+            case TelemetryType::FLOAT:
+                if (i + 4 > length) return false;
+                std::memcpy(&field.number, &scratch[i], 4);
+                i += 4;
+                break;
+            case TelemetryType::INT:
+                if (i + 4 > length) return false;
+                std::memcpy(&field.integer, &scratch[i], 4);
+                i += 4;
+                break;
+            case TelemetryType::BOOL:
+                if (i + 1 > length) return false;
+                field.integer = scratch[i++];
+                break;
+            case TelemetryType::STRING: {
+                if (i + 1 > length || i + 1 + scratch[i] > length) return false;
+                const uint8_t stringLength = scratch[i++];
+                field.string = std::string_view(reinterpret_cast<const char*>(&scratch[i]), stringLength);
+                i += stringLength;
+                break;
+            }
+            default: return false;
+        }
+    }
+    return true;
+}
+} // namespace lemlib
@@ -0,0 +1,60 @@
+#include <cstdio>
+#include "pros/apix.h"
+#include "lemlib/logger/telemetrySink.hpp"
+#include "lemlib/logger/stdout.hpp"
+
+namespace lemlib {
+TelemetrySink::TelemetrySink() { setFormat("TELE_START{message}TELE_END"); }
+
+void TelemetrySink::sendMessage(const Message& message) {
+    bufferedStdout().print("\033[s{}\033[u\033[0J", message.message);
+}
+
+void TelemetrySink::setBinary(bool binary) {
+    if (binary && frameBuffer == nullptr) {
+        frameBuffer = std::make_unique<Buffer>([](std::string_view frame) {
+            std::fwrite(frame.data(), 1, frame.size(), stdout);
+            std::fflush(stdout);
+        }, "frames");
+        // 100 Hz on a few channels is a few hundred frames a second
+        frameBuffer->setRate(5);
+        frameBuffer->setBurst(16);
+    }
+    // frames have 0s in them, which the PROS stream framing would mangle
+    if (binary) pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+    else pros::c::serctl(SERCTL_ENABLE_COBS, nullptr);
+    this->binary = binary;
+}
+
+void TelemetrySink::defineChannel(uint8_t channel, std::string_view name,
+                                  std::initializer_list<std::string_view> fields) {
+    if (channel == TelemetryFrame::SCHEMA_CHANNEL || channel >= MAX_CHANNELS) return;
+    TelemetryFrame frame(TelemetryFrame::SCHEMA_CHANNEL, pros::millis());
+    frame.add(channel);
+    frame.add(name);
+    for (std::string_view field : fields) frame.add(field);
+    schemaSizes[channel] = frame.encode(schemas[channel].data());
+    if (binary) frameBuffer->pushToBuffer(
+        std::string_view(reinterpret_cast<const char*>(schemas[channel].data()), schemaSizes[channel]));
+}
+
+void TelemetrySink::sendFrame(const TelemetryFrame& frame) {
+    std::array<uint8_t, TelemetryFrame::MAX_ENCODED_SIZE> encoded;
+    const size_t size = frame.encode(encoded.data());
+    frameBuffer->pushToBuffer(std::string_view(reinterpret_cast<const char*>(encoded.data()), size));
+    // send one channel definition every 250ms, so a decoder that starts late learns every channel's name
+    // frames are sent from several tasks, so only the one that moves the time on sends the definition
+    const uint32_t now = pros::millis();
+    uint32_t last = lastSchemaTime.load(std::memory_order_relaxed);
+    if (now - last < 250 || !lastSchemaTime.compare_exchange_strong(last, now, std::memory_order_acq_rel)) return;
+    const size_t first = nextSchema.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < MAX_CHANNELS; i++) {
+        const size_t channel = (first + i) % MAX_CHANNELS;
+        if (schemaSizes[channel] == 0) continue;
+        frameBuffer->pushToBuffer(
+            std::string_view(reinterpret_cast<const char*>(schemas[channel].data()), schemaSizes[channel]));
+        nextSchema.store(channel + 1, std::memory_order_relaxed);
+        break;
+    }
+}
+} // namespace lemlib
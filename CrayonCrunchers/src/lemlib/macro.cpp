@@ -0,0 +1,105 @@
+#include "pros/rtos.hpp"
+#include "lemlib/macro.hpp"
+
+namespace lemlib {
+Macro::Macro(const char* name, uint32_t resources, int priority)
+    : name(name),
+      resources(resources),
+      priority(priority) {}
+
+Macro& Macro::then(std::function<void()> action) {
+    steps.push_back({action, nullptr, 0});
+    return *this;
+}
+
+Macro& Macro::wait(uint32_t time) {
+    steps.push_back({nullptr, nullptr, time});
+    return *this;
+}
+
+Macro& Macro::waitUntil(std::function<bool()> condition, uint32_t timeout) {
+    steps.push_back({nullptr, condition, timeout});
+    return *this;
+}
+
+Macro& Macro::onCancel(std::function<void()> action) {
+    cancelAction = action;
+    return *this;
+}
+
+bool MacroScheduler::start(Macro& macro) {
+    // check every conflict before cancelling any, so a macro that can't start changes nothing
+    for (size_t i = 0; i < count; i++) {
+        if (running[i] != &macro && (running[i]->resources & macro.resources) != 0 &&
+            running[i]->priority > macro.priority)
+            return false;
+    }
+    cancel(macro);
+    cancel(macro.resources);
+    if (count == MAX_RUNNING) return false;
+    macro.step = 0;
+    macro.stepStarted = false;
+    running[count++] = &macro;
+    owned |= macro.resources;
+    return true;
+}
+
+void MacroScheduler::cancel(Macro& macro) {
+    for (size_t i = 0; i < count; i++) {
+        if (running[i] != &macro) continue;
+        remove(i);
+        if (macro.cancelAction) macro.cancelAction();
+        return;
+    }
+}
+
+void MacroScheduler::cancel(uint32_t resources) {
+    for (size_t i = 0; i < count;) {
+        Macro* macro = running[i];
+        if ((macro->resources & resources) == 0) {
+            i++;
+            continue;
+        }
+        remove(i);
+        if (macro->cancelAction) macro->cancelAction();
+    }
+}
+
+void MacroScheduler::cancelAll() { cancel(UINT32_MAX); }
+
+void MacroScheduler::update() {
+    const uint32_t now = pros::millis();
+    for (size_t i = 0; i < count;) {
+        Macro& macro = *running[i];
+        // steps that don't wait all run this update
+        while (macro.step < macro.steps.size()) {
+            const Macro::Step& step = macro.steps[macro.step];
+            if (!macro.stepStarted) {
+                macro.stepStarted = true;
+                macro.stepStart = now;
+                if (step.action) step.action();
+            }
+            const bool met = step.condition ? step.condition() : false;
+            if (!met && now - macro.stepStart < step.timeout) break;
+            macro.step++;
+            macro.stepStarted = false;
+        }
+        if (macro.step == macro.steps.size()) remove(i);
+        else i++;
+    }
+}
+
+bool MacroScheduler::isRunning(const Macro& macro) const {
+    for (size_t i = 0; i < count; i++) {
+        if (running[i] == &macro) return true;
+    }
+    return false;
+}
+
+void MacroScheduler::remove(size_t index) {
+    for (size_t i = index; i + 1 < count; i++) running[i] = running[i + 1];
+    running[--count] = nullptr;
+    owned = 0;
+    for (size_t i = 0; i < count; i++) owned |= running[i]->resources;
+}
+} // namespace lemlib
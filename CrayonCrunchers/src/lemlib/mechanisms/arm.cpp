@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cmath>
+#include "pros/rtos.hpp"
+#include "lemlib/mechanisms/arm.hpp"
+
+const char* lemlib::toString(ArmPreset preset) {
+    switch (preset) {
+        case ArmPreset::STOWED: return "stowed";
+        case ArmPreset::PRIMED: return "primed";
+        case ArmPreset::SCORE: return "score";
+        case ArmPreset::MANUAL: return "manual";
+    }
+    return "unknown";
+}
+
+lemlib::Arm::Arm(pros::Motor* motor, ArmSettings settings)
+    : motor(motor),
+      settings(settings),
+      pid(settings.kP, settings.kI, settings.kD),
+      settle(settings.tolerance, settings.settleTime) {}
+
+void lemlib::Arm::initialize() {
+    motor->tare_position();
+    task = std::make_unique<PeriodicTask>("arm", PERIOD, [this]() { update(); });
+}
+
+void lemlib::Arm::moveTo(ArmPreset preset) {
+    this->preset.store(preset, std::memory_order_relaxed);
+    moves.fetch_add(1, std::memory_order_release);
+}
+
+void lemlib::Arm::resetPosition(ArmPreset preset) {
+    // the arm's task zeroes the encoder, so it never reads a position from before with the new offset
+    reset.store(true, std::memory_order_relaxed);
+    moveTo(preset);
+}
+
+void lemlib::Arm::move(float power) {
+    manualPower.store(power, std::memory_order_relaxed);
+    moveTo(ArmPreset::MANUAL);
+}
+
+bool lemlib::Arm::isSettled() const {
+    return settledMove.load(std::memory_order_acquire) == moves.load(std::memory_order_acquire);
+}
+
+bool lemlib::Arm::waitUntilSettled(uint32_t timeout) const {
+    const uint32_t start = pros::millis();
+    while (!isSettled()) {
+        if (pros::millis() - start >= timeout) return false;
+        pros::delay(PERIOD);
+    }
+    return true;
+}
+
+float lemlib::Arm::getTarget(ArmPreset preset) const {
+    switch (preset) {
+        case ArmPreset::PRIMED: return settings.primedPosition;
+        case ArmPreset::SCORE: return settings.scorePosition;
+        case ArmPreset::MANUAL: return holdPosition.load(std::memory_order_relaxed);
+        default: return 0;
+    }
+}
+
+void lemlib::Arm::update() {
+    // the move is read before the preset, so the preset is never older than the move
+    const uint32_t move = moves.load(std::memory_order_acquire);
+    const ArmPreset preset = this->preset.load(std::memory_order_relaxed);
+    if (move != lastMove && reset.exchange(false, std::memory_order_relaxed)) {
+        motor->tare_position();
+        offset = getTarget(preset);
+    }
+    const float current = float(motor->get_position()) / settings.gearRatio + offset;
+    position.store(current, std::memory_order_relaxed);
+    // leave the arm alone until it is first told to move
+    if (move == 0) return;
+    if (move != lastMove) {
+        if (lastMove == 0) motor->set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
+        lastMove = move;
+        pid.reset();
+        settle.reset();
+        holdPosition.store(current, std::memory_order_relaxed);
+    }
+
+    // run by hand, the arm is held wherever its power was last set to 0
+    const float manual = manualPower.load(std::memory_order_relaxed);
+    if (preset == ArmPreset::MANUAL && manual != 0) {
+        holdPosition.store(current, std::memory_order_relaxed);
+        motor->move(manual);
+        power.store(manual, std::memory_order_relaxed);
+        return;
+    }
+
+    const float error = getTarget(preset) - current;
+    // gravity pulls hardest on the arm when it sticks out level
+    const float angle = (settings.stowedAngle + current) * float(M_PI) / 180;
+    const float output = std::clamp(pid.update(error) + settings.gravity * std::cos(angle), -127.0f, 127.0f);
+    motor->move(output);
+
+    power.store(output, std::memory_order_relaxed);
+    if (settle.update(error)) settledMove.store(move, std::memory_order_release);
+}
@@ -0,0 +1,97 @@
+#include <cmath>
+#include "pros/misc.hpp"
+#include "lemlib/mechanisms/colorSort.hpp"
+
+namespace lemlib {
+ColorSort::ColorSort(pros::Optical* optical, pros::Motor* conveyor, ColorSortSettings settings)
+    : optical(optical),
+      conveyor(conveyor),
+      settings(settings) {}
+
+void ColorSort::initialize() {
+    optical->set_led_pwm(100);
+    optical->set_integration_time(SAMPLE_PERIOD);
+    if (pros::usd::is_installed()) {
+        classifierMutex.take();
+        classifier.load(MODEL_PATH);
+        classifierMutex.give();
+    }
+}
+
+bool ColorSort::update(RingColor rejected) {
+    const uint32_t now = pros::millis();
+    const float position = conveyor->get_position();
+
+    if (now - lastSample >= SAMPLE_PERIOD) {
+        lastSample = now;
+        // each value is its own read from the sensor, so read each once
+        ColorReading latest;
+        latest.sample = OpticalSample::read(*optical);
+        latest.time = now;
+        classifierMutex.take();
+        latest.ring = classifier.classify(latest.sample);
+        latest.label = calibrating;
+        if (calibrating != -1) classifier.addSample(static_cast<RingColor>(calibrating), latest.sample);
+        classifierMutex.give();
+        reading.tryWrite(latest);
+        seen = latest.ring.confidence >= settings.minConfidence ? latest.ring.color : RingColor::NONE;
+        // only mark rings on their way up. Ones carried back past the sensor while reversing are marked already
+        const float velocity = conveyor->get_actual_velocity() * 6 / 1000; // degrees per millisecond
+        if (rejected != RingColor::NONE && seen == rejected && velocity > 0 && latest.label == -1) {
+            // the reading is a little old, so the ring passed the sensor a little further back along the conveyor
+            mark(position - velocity * settings.latency);
+        }
+    }
+
+    if (reversing) {
+        if (position > reverseEnd && now - reverseStart < settings.reverseTimeout) return true;
+        reversing = false;
+    }
+    // start throwing off the oldest ring once it has been carried to the top
+    if (pending > 0 && position >= marks[first] + settings.ejectDistance) {
+        first = (first + 1) % MAX_PENDING;
+        pending--;
+        ejected++;
+        reversing = true;
+        reverseEnd = position - settings.reverseDistance;
+        reverseStart = now;
+    }
+    return reversing;
+}
+
+void ColorSort::mark(float position) {
+    // a ring is seen over several readings, and again if the conveyor reverses it past the sensor
+    if (marked && std::fabs(position - lastMark) < settings.ringLength) return;
+    for (size_t i = 0; i < pending; i++) {
+        if (std::fabs(position - marks[(first + i) % MAX_PENDING]) < settings.ringLength) return;
+    }
+    lastMark = position;
+    marked = true;
+    if (pending == MAX_PENDING) return;
+    marks[(first + pending) % MAX_PENDING] = position;
+    pending++;
+}
+
+void ColorSort::calibrate(RingColor color) {
+    classifierMutex.take();
+    calibrating = static_cast<int>(color);
+    classifierMutex.give();
+}
+
+bool ColorSort::finishCalibration() {
+    classifierMutex.take();
+    calibrating = -1;
+    const bool fitted = classifier.fit();
+    // start over next time, whether it worked or not
+    classifier.clearSamples();
+    if (fitted && pros::usd::is_installed()) classifier.save(MODEL_PATH);
+    classifierMutex.give();
+    return fitted;
+}
+
+void ColorSort::reset() {
+    pending = 0;
+    marked = false;
+    reversing = false;
+}
+} // namespace lemlib
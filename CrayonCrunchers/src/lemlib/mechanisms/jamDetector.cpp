@@ -0,0 +1,120 @@
+#include <algorithm>
+#include "pros/rtos.hpp"
+#include "lemlib/mechanisms/jamDetector.hpp"
+
+const char* lemlib::toString(JamState state) {
+    switch (state) {
+        case JamState::RUNNING: return "running";
+        case JamState::REVERSING: return "reversing";
+        case JamState::PAUSED: return "paused";
+        case JamState::RETRYING: return "retrying";
+        case JamState::GAVE_UP: return "gave up";
+    }
+    return "unknown";
+}
+
+lemlib::JamDetector::JamDetector(pros::Motor* motor, JamDetectorSettings settings)
+    : motor(motor),
+      settings(settings) {}
+
+int lemlib::JamDetector::update(int power) {
+    const uint32_t now = pros::millis();
+    if (maxRpm == 0) {
+        switch (motor->get_gearing()) {
+            case pros::MotorGears::red: maxRpm = 100; break;
+            case pros::MotorGears::blue: maxRpm = 600; break;
+            default: maxRpm = 200; break;
+        }
+    }
+
+    // low pass filter the readings, so a ring catching for a moment doesn't look like a jam
+    const float dt = lastUpdate == 0 ? 10 : now - lastUpdate;
+    lastUpdate = now;
+    const float alpha = dt / (settings.filterTime + dt);
+    const float expected = power / 127.0f * maxRpm;
+    const float error = expected == 0 ? 0 : (expected - float(motor->get_actual_velocity())) / expected;
+    current += (float(motor->get_current_draw()) - current) * alpha;
+    torque += (float(motor->get_torque()) - torque) * alpha;
+    velocityError += (error - velocityError) * alpha;
+
+    // a motor changing direction strains and is slow for a moment too, so give it time first
+    const int direction = power > 0 ? 1 : power < 0 ? -1 : 0;
+    if (direction != commandDirection) {
+        commandDirection = direction;
+        commandStart = now;
+    }
+    const bool straining = current > settings.stallCurrent || torque > settings.stallTorque;
+    const bool stalledNow = direction != 0 && now - commandStart >= settings.jamTime && straining &&
+                            velocityError > 1 - settings.stallSpeed;
+    if (!stalledNow) stallStart = now;
+    const bool jammed = now - stallStart >= settings.jamTime;
+
+    switch (state) {
+        case JamState::RUNNING:
+            if (!jammed) return power;
+            stats.jams++;
+            jamStart = now;
+            attempts = 0;
+            startReversing(now);
+            break;
+        case JamState::REVERSING:
+            if (now - stateStart < settings.reverseTime) break;
+            state = JamState::PAUSED;
+            stateStart = now;
+            break;
+        case JamState::PAUSED:
+            if (now - stateStart < settings.pauseTime) break;
+            // the motor starting up again shouldn't count as a jam
+            state = JamState::RETRYING;
+            stateStart = now;
+            commandStart = now;
+            stallStart = now;
+            return power;
+        case JamState::RETRYING:
+            if (direction == 0) {
+                state = JamState::RUNNING;
+            } else if (jammed) {
+                // still the same jam
+                if (attempts < settings.maxAttempts) {
+                    stats.retries++;
+                    startReversing(now);
+                    break;
+                }
+                state = JamState::GAVE_UP;
+                stateStart = now;
+                stats.gaveUp++;
+                break;
+            } else if (now - stateStart >= settings.retryTime) {
+                state = JamState::RUNNING;
+                stats.cleared++;
+                stats.maxClearTime = std::max(stats.maxClearTime, now - jamStart);
+            }
+            return power;
+        case JamState::GAVE_UP:
+            // rest rather than fight the jam, until whatever commands the motor stops it or the cooldown ends.
+            // Starting up again after the cooldown shouldn't count as a jam
+            if (direction != 0 && now - stateStart < settings.cooldownTime) break;
+            state = JamState::RUNNING;
+            commandStart = now;
+            stallStart = now;
+            return power;
+    }
+    return state == JamState::REVERSING ? -jamDirection * settings.reversePower : 0;
+}
+
+void lemlib::JamDetector::startReversing(uint32_t now) {
+    attempts++;
+    state = JamState::REVERSING;
+    stateStart = now;
+    jamDirection = commandDirection;
+}
+
+void lemlib::JamDetector::reset() {
+    state = JamState::RUNNING;
+    attempts = 0;
+    lastUpdate = 0;
+    current = 0;
+    torque = 0;
+    velocityError = 0;
+    commandDirection = 0;
+}
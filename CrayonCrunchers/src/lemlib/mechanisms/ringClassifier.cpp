@@ -0,0 +1,161 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "lemlib/mechanisms/ringClassifier.hpp"
+
+namespace lemlib {
+namespace {
+// smallest variance of a feature, so a feature that barely changed while fitting can't outweigh the others
+constexpr float MIN_VARIANCE = 1e-4;
+// first line of a saved model, so anything else isn't loaded by mistake
+constexpr const char* MODEL_HEADER = "ringClassifier 1";
+} // namespace
+
+const char* toString(RingColor color) {
+    switch (color) {
+        case RingColor::NONE: return "none";
+        case RingColor::RED: return "red";
+        case RingColor::BLUE: return "blue";
+    }
+    return "unknown";
+}
+
+OpticalSample OpticalSample::read(pros::Optical& optical) {
+    OpticalSample sample;
+    // the rgb reading comes with brightness
+    const pros::c::optical_rgb_s_t rgb = optical.get_rgb();
+    sample.red = rgb.red;
+    sample.green = rgb.green;
+    sample.blue = rgb.blue;
+    sample.brightness = rgb.brightness;
+    sample.hue = optical.get_hue();
+    sample.saturation = optical.get_saturation();
+    sample.proximity = optical.get_proximity();
+    return sample;
+}
+
+RingClassifier::RingClassifier() {
+    // the hue windows color sorting used before, red around 0 degrees and blue around 220, with a saturation of
+    // about 0.6, and no ring being grey
+    const float blueHue = 220 * M_PI / 180;
+    setClass(RingColor::NONE, {0, 0, 1.0f / 3, 1.0f / 3, 0.1, 0.1}, {0.01, 0.01, 0.0225, 0.0225, 0.09, 0.16});
+    setClass(RingColor::RED, {0.6, 0, 0.55, 0.2, 0.3, 0.5}, {0.0225, 0.0225, 0.0225, 0.0225, 0.09, 0.16});
+    setClass(RingColor::BLUE, {0.6f * std::cos(blueHue), 0.6f * std::sin(blueHue), 0.2, 0.55, 0.3, 0.5},
+             {0.0225, 0.0225, 0.0225, 0.0225, 0.09, 0.16});
+}
+
+std::array<float, RingClassifier::FEATURES> RingClassifier::getFeatures(const OpticalSample& sample) {
+    // the hue wraps around, so use it as a point on the color wheel. Grey readings have a meaningless hue, and
+    // scaling by saturation puts them all near the middle
+    const float hue = sample.hue * float(M_PI) / 180;
+    // shares of the rgb reading don't change with how bright the light is
+    const float total = sample.red + sample.green + sample.blue;
+    const float redShare = total > 0 ? sample.red / total : 1.0f / 3;
+    const float blueShare = total > 0 ? sample.blue / total : 1.0f / 3;
+    return {sample.saturation * std::cos(hue),
+            sample.saturation * std::sin(hue),
+            redShare,
+            blueShare,
+            sample.brightness,
+            sample.proximity / 255.0f};
+}
+
+RingClassification RingClassifier::classify(const OpticalSample& sample) const {
+    const std::array<float, FEATURES> features = getFeatures(sample);
+    std::array<float, CLASSES> logLikelihood;
+    int best = 0;
+    for (int c = 0; c < CLASSES; c++) {
+        const Gaussian& gaussian = model[c];
+        float sum = gaussian.logScale;
+        for (int f = 0; f < FEATURES; f++) {
+            const float error = features[f] - gaussian.mean[f];
+            sum -= 0.5f * error * error * gaussian.inverseVariance[f];
+        }
+        logLikelihood[c] = sum;
+        if (sum > logLikelihood[best]) best = c;
+    }
+    // every color is as likely as the others beforehand, so the probability of the best is its share of the
+    // likelihood
+    float total = 0;
+    for (int c = 0; c < CLASSES; c++) total += std::exp(logLikelihood[c] - logLikelihood[best]);
+    return {static_cast<RingColor>(best), 1 / total};
+}
+
+void RingClassifier::addSample(RingColor color, const OpticalSample& sample) {
+    const std::array<float, FEATURES> features = getFeatures(sample);
+    Accumulator& accumulator = samples[static_cast<int>(color)];
+    accumulator.count++;
+    for (int f = 0; f < FEATURES; f++) {
+        const double delta = features[f] - accumulator.mean[f];
+        accumulator.mean[f] += delta / accumulator.count;
+        accumulator.m2[f] += delta * (features[f] - accumulator.mean[f]);
+    }
+}
+
+int RingClassifier::getSampleCount(RingColor color) const { return samples[static_cast<int>(color)].count; }
+
+bool RingClassifier::fit() {
+    for (const Accumulator& accumulator : samples) {
+        if (accumulator.count < MIN_SAMPLES) return false;
+    }
+    for (int c = 0; c < CLASSES; c++) {
+        const Accumulator& accumulator = samples[c];
+        std::array<float, FEATURES> mean;
+        std::array<float, FEATURES> variance;
+        for (int f = 0; f < FEATURES; f++) {
+            mean[f] = accumulator.mean[f];
+            variance[f] = accumulator.m2[f] / (accumulator.count - 1);
+        }
+        setClass(static_cast<RingColor>(c), mean, variance);
+    }
+    clearSamples();
+    return true;
+}
+
+void RingClassifier::clearSamples() { samples = {}; }
+
+void RingClassifier::setClass(RingColor color, const std::array<float, FEATURES>& mean,
+                              const std::array<float, FEATURES>& variance) {
+    Gaussian& gaussian = model[static_cast<int>(color)];
+    gaussian.mean = mean;
+    gaussian.logScale = 0;
+    for (int f = 0; f < FEATURES; f++) {
+        const float clamped = std::fmax(variance[f], MIN_VARIANCE);
+        gaussian.inverseVariance[f] = 1 / clamped;
+        gaussian.logScale -= 0.5f * std::log(clamped);
+    }
+}
+
+bool RingClassifier::save(const char* path) const {
+    FILE* file = std::fopen(path, "w");
+    if (file == nullptr) return false;
+    std::fprintf(file, "%s\n", MODEL_HEADER);
+    // a line per color, the mean of each feature then its variance
+    for (const Gaussian& gaussian : model) {
+        for (float mean : gaussian.mean) std::fprintf(file, "%.6g ", mean);
+        for (float inverseVariance : gaussian.inverseVariance) std::fprintf(file, "%.6g ", 1 / inverseVariance);
+        std::fprintf(file, "\n");
+    }
+    return std::fclose(file) == 0;
+}
+
+bool RingClassifier::load(const char* path) {
+    FILE* file = std::fopen(path, "r");
+    if (file == nullptr) return false;
+    char header[32] = {};
+    bool valid = std::fgets(header, sizeof(header), file) != nullptr &&
+                 std::strncmp(header, MODEL_HEADER, std::strlen(MODEL_HEADER)) == 0;
+    std::array<std::array<float, FEATURES>, CLASSES> means;
+    std::array<std::array<float, FEATURES>, CLASSES> variances;
+    for (int c = 0; c < CLASSES && valid; c++) {
+        for (float& mean : means[c]) valid = valid && std::fscanf(file, "%f", &mean) == 1 && std::isfinite(mean);
+        for (float& variance : variances[c]) {
+            valid = valid && std::fscanf(file, "%f", &variance) == 1 && std::isfinite(variance) && variance > 0;
+        }
+    }
+    std::fclose(file);
+    if (!valid) return false;
+    for (int c = 0; c < CLASSES; c++) setClass(static_cast<RingColor>(c), means[c], variances[c]);
+    return true;
+}
+} // namespace lemlib
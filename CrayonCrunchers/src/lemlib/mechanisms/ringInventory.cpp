@@ -0,0 +1,130 @@
+#include <cmath>
+#include "pros/rtos.hpp"
+#include "lemlib/mechanisms/ringInventory.hpp"
+
+namespace lemlib {
+namespace {
+// how quickly the usual current draw follows the current, per update. About half a second at 10 ms
+constexpr float BASELINE_RATE = 0.02;
+// how quickly it follows during a spike, so a spike is still seen but a lasting rise in current stops being one.
+// About five seconds at 10 ms
+constexpr float SPIKE_BASELINE_RATE = 0.002;
+} // namespace
+
+RingInventory::RingInventory(pros::Motor* conveyor, const ColorSort* colorSort, RingInventorySettings settings)
+    : conveyor(conveyor),
+      colorSort(colorSort),
+      settings(settings) {
+    ejected = colorSort->getEjected();
+}
+
+void RingInventory::update() {
+    const float position = conveyor->get_position();
+    const float current = conveyor->get_current_draw();
+    const bool movingUp = position > lastPosition;
+    lastPosition = position;
+    if (goalReset.exchange(false, std::memory_order_relaxed)) counts.onGoal = 0;
+
+    // a new ring, unless it is one already followed. Rings carried back past the sensor are followed already
+    const ColorReading reading = colorSort->getReading();
+    if (reading.time != lastReading) {
+        lastReading = reading.time;
+        bool known = reading.label != -1 || colorSort->getSeen() == RingColor::NONE || !movingUp ||
+                     (entered && std::fabs(position - lastEntry) < settings.ringLength);
+        for (size_t i = 0; i < count && !known; i++) {
+            known = std::fabs(position - rings[i].entry) < settings.ringLength;
+        }
+        if (!known && count < MAX_RINGS) {
+            rings[count++] = {position, false};
+            counts.intaken++;
+            lastEntry = position;
+            entered = true;
+        }
+    }
+
+    // the color sorter throws off a ring once it has been carried its eject distance, which isn't always the ring
+    // furthest up. A right colored ring can be above it
+    const uint32_t ejectedNow = colorSort->getEjected();
+    for (; ejected != ejectedNow; ejected++) {
+        if (count == 0) continue;
+        size_t closest = 0;
+        for (size_t i = 1; i < count; i++) {
+            if (std::fabs(position - rings[i].entry - colorSort->getEjectDistance()) <
+                std::fabs(position - rings[closest].entry - colorSort->getEjectDistance()))
+                closest = i;
+        }
+        remove(closest);
+        counts.ejected++;
+    }
+
+    // the conveyor strains to push a ring over the top, so look for a jump in current while one is near it
+    const bool spike = current - baseline > settings.spikeCurrent;
+    baseline += (current - baseline) * (spike ? SPIKE_BASELINE_RATE : BASELINE_RATE);
+    for (size_t i = 0; i < count;) {
+        Ring& ring = rings[i];
+        const float travel = position - ring.entry;
+        if (spike && travel >= settings.scoreDistance - settings.spikeWindow) ring.spiked = true;
+        if (travel >= settings.scoreDistance) {
+            counts.scored++;
+            counts.onGoal++;
+            if (ring.spiked) counts.confirmed++;
+            remove(i);
+        } else if (travel <= -settings.outtakeDistance) {
+            counts.outtaken++;
+            remove(i);
+        } else {
+            i++;
+        }
+    }
+
+    counts.held = count;
+    State published;
+    published.counts = counts;
+    published.position = position;
+    for (size_t i = 0; i < count; i++) published.entries[i] = rings[i].entry;
+    published.rings = count;
+    state.tryWrite(published);
+}
+
+void RingInventory::remove(size_t index) {
+    // keep the rings in the order they entered, so the first is the one furthest up
+    for (size_t i = index; i + 1 < count; i++) rings[i] = rings[i + 1];
+    count--;
+}
+
+bool RingInventory::isRingBetween(float from, float to) const {
+    const State current = state.read();
+    for (size_t i = 0; i < current.rings; i++) {
+        const float travel = current.position - current.entries[i];
+        if (travel >= from && travel <= to) return true;
+    }
+    return false;
+}
+
+bool RingInventory::waitUntilScored(int scored, uint32_t timeout) const {
+    const uint32_t start = pros::millis();
+    while (getCounts().scored < scored) {
+        if (pros::millis() - start >= timeout) return false;
+        pros::delay(10);
+    }
+    return true;
+}
+
+bool RingInventory::waitUntilHeld(int held, uint32_t timeout) const {
+    const uint32_t start = pros::millis();
+    while (getCounts().held < held) {
+        if (pros::millis() - start >= timeout) return false;
+        pros::delay(10);
+    }
+    return true;
+}
+
+bool RingInventory::waitUntilIntaken(int intaken, uint32_t timeout) const {
+    const uint32_t start = pros::millis();
+    while (getCounts().intaken < intaken) {
+        if (pros::millis() - start >= timeout) return false;
+        pros::delay(10);
+    }
+    return true;
+}
+} // namespace lemlib
@@ -0,0 +1,79 @@
+#include <cmath>
+#include "lemlib/motionProfile.hpp"
+
+lemlib::MotionProfile::MotionProfile(float distance, float maxVelocity, float maxAcceleration, float maxJerk) {
+    direction = distance < 0 ? -1 : 1;
+    distance = std::fabs(distance);
+    if (distance == 0 || maxVelocity <= 0 || maxAcceleration <= 0) return;
+
+    float velocity = maxVelocity;
+    float acceleration = maxAcceleration;
+    float jerkTime = 0; // length of each jerk phase
+    float accelTime; // length of each constant acceleration phase
+    if (maxJerk > 0) {
+        // acceleration can't be reached before it would have to ramp down again
+        if (velocity * maxJerk < acceleration * acceleration) acceleration = std::sqrt(velocity * maxJerk);
+        jerkTime = acceleration / maxJerk;
+        accelTime = velocity / acceleration - jerkTime;
+        // speeding up and slowing down takes velocity * (2 * jerkTime + accelTime). Lower the top speed if that's
+        // further than the move
+        if (velocity * (2 * jerkTime + accelTime) > distance) {
+            if (distance < 2 * std::pow(acceleration, 3) / (maxJerk * maxJerk)) {
+                // too short to reach full acceleration either
+                velocity = std::pow(distance * std::sqrt(maxJerk) / 2, 2.0f / 3);
+                acceleration = std::sqrt(velocity * maxJerk);
+                jerkTime = acceleration / maxJerk;
+                accelTime = 0;
+            } else {
+                velocity = acceleration / 2 *
+                           (std::sqrt(std::pow(acceleration / maxJerk, 2) + 4 * distance / acceleration) -
+                            acceleration / maxJerk);
+                accelTime = velocity / acceleration - jerkTime;
+            }
+        }
+    } else {
+        accelTime = velocity / acceleration;
+        if (velocity * accelTime > distance) {
+            velocity = std::sqrt(distance * acceleration);
+            accelTime = velocity / acceleration;
+        }
+    }
+    accelTime = std::fmax(accelTime, 0.0f);
+    const float cruiseTime = std::fmax(distance - velocity * (2 * jerkTime + accelTime), 0.0f) / velocity;
+
+    phaseTime = {jerkTime, accelTime, jerkTime, cruiseTime, jerkTime, accelTime, jerkTime};
+    phaseJerk = {maxJerk, 0, -maxJerk, 0, -maxJerk, 0, maxJerk};
+    // acceleration at the start of each phase. Without a jerk limit the jerk phases have no length, so acceleration
+    // jumps straight to these
+    const std::array<float, 7> startAcceleration {0, acceleration, acceleration, 0, 0, -acceleration, -acceleration};
+    for (int i = 0; i < 7; i++) {
+        const State& start = phaseStart[i];
+        const float t = phaseTime[i];
+        const float a = startAcceleration[i];
+        phaseStart[i].acceleration = a;
+        phaseStart[i + 1].position =
+            start.position + start.velocity * t + a * t * t / 2 + phaseJerk[i] * t * t * t / 6;
+        phaseStart[i + 1].velocity = start.velocity + a * t + phaseJerk[i] * t * t / 2;
+        duration += t;
+    }
+    // rounding leaves the end a hair off
+    phaseStart[7] = {distance, 0, 0};
+}
+
+lemlib::MotionProfile::State lemlib::MotionProfile::sample(float time) const {
+    State state = phaseStart[7];
+    if (time < duration) {
+        int i = 0;
+        while (i < 6 && time >= phaseTime[i]) time -= phaseTime[i++];
+        const State& start = phaseStart[i];
+        const float jerk = phaseJerk[i];
+        state.position = start.position + start.velocity * time + start.acceleration * time * time / 2 +
+                         jerk * time * time * time / 6;
+        state.velocity = start.velocity + start.acceleration * time + jerk * time * time / 2;
+        state.acceleration = start.acceleration + jerk * time;
+    }
+    state.position *= direction;
+    state.velocity *= direction;
+    state.acceleration *= direction;
+    return state;
+}
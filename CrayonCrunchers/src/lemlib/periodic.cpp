@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include "lemlib/periodic.hpp"
+#include "lemlib/logger/logger.hpp"
+
+namespace lemlib {
+namespace {
+// loops are only added and removed when they are made and destroyed, so a mutex is fine
+pros::Mutex& registryMutex() {
+    static pros::Mutex mutex;
+    return mutex;
+}
+
+std::array<const PeriodicLoop*, PeriodicLoop::MAX_LOOPS>& registry() {
+    static std::array<const PeriodicLoop*, PeriodicLoop::MAX_LOOPS> loops {};
+    return loops;
+}
+
+void record(std::array<uint32_t, PeriodicStats::BUCKETS>& histogram, uint32_t& max, uint32_t value) {
+    int bucket = 0;
+    while (bucket < PeriodicStats::BUCKETS - 1 && value >> bucket != 0) bucket++;
+    histogram[bucket]++;
+    max = std::max(max, value);
+}
+} // namespace
+
+PeriodicLoop::PeriodicLoop(const char* name, uint32_t period)
+    : name(name),
+      period(period) {
+    restart();
+    bool listed = false;
+    registryMutex().take();
+    for (const PeriodicLoop*& loop : registry()) {
+        if (loop != nullptr) continue;
+        loop = this;
+        listed = true;
+        break;
+    }
+    registryMutex().give();
+    if (listed) return;
+    // the first message makes the stdout buffer, whose loop won't be listed either, so don't report that one too
+    static std::atomic<bool> reporting = false;
+    if (reporting.exchange(true)) return;
+    infoSink()->error("Too many periodic loops, {} isn't monitored", name);
+    reporting = false;
+}
+
+PeriodicLoop::~PeriodicLoop() {
+    registryMutex().take();
+    std::array<const PeriodicLoop*, MAX_LOOPS>& loops = registry();
+    // keep the listed loops together, so the first nullptr ends the list
+    auto end = std::remove(loops.begin(), loops.end(), this);
+    std::fill(end, loops.end(), nullptr);
+    registryMutex().give();
+}
+
+void PeriodicLoop::restart() {
+    time = pros::millis();
+    cycleStart = pros::micros();
+}
+
+void PeriodicLoop::wait() {
+    const uint32_t execution = pros::micros() - cycleStart;
+    // if the cycle ran past the start of the next one, skip the ones it missed instead of catching up
+    const uint32_t late = pros::millis() - time;
+    if (late > period) {
+        const uint32_t missed = (late - 1) / period;
+        current.missed += missed;
+        time += missed * period;
+    }
+    pros::Task::delay_until(&time, period);
+    cycleStart = pros::micros();
+    const uint64_t due = uint64_t(time) * 1000;
+    record(current.execution, current.maxExecution, execution);
+    current.busy += execution;
+    record(current.jitter, current.maxJitter, cycleStart > due ? cycleStart - due : 0);
+    current.runs++;
+    stats.tryWrite(current);
+}
+
+namespace {
+// what FreeRTOS fills stacks with
+constexpr uint32_t STACK_PATTERN = 0xA5A5A5A5;
+// left alone below the stack pointer while painting, since interrupts save registers there
+constexpr size_t STACK_MARGIN = 512;
+} // namespace
+
+// not inlined, so its own frame is below the caller's and painting can't reach anything the caller uses
+__attribute__((noinline)) void PeriodicLoop::watchStack(uint16_t depth) {
+    const uintptr_t top = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+    const size_t size = size_t(depth) * sizeof(uint32_t);
+    if (size <= STACK_GUARD + STACK_MARGIN) return;
+    // the task function and what called it take a few hundred bytes above this, so the real bottom is somewhat
+    // higher than top - size. The guard keeps painting clear of whatever is below the stack
+    const uintptr_t bottom = (top - size + STACK_GUARD + 3) & ~uintptr_t(3);
+    const uintptr_t end = (top - STACK_MARGIN) & ~uintptr_t(3);
+    volatile uint32_t* word = reinterpret_cast<volatile uint32_t*>(bottom);
+    for (; reinterpret_cast<uintptr_t>(word) < end; word++) *word = STACK_PATTERN;
+    stackWords = (end - bottom) / sizeof(uint32_t);
+    stackBottom.store(reinterpret_cast<const uint32_t*>(bottom), std::memory_order_release);
+}
+
+int32_t PeriodicLoop::getStackFree() const {
+    const volatile uint32_t* word = stackBottom.load(std::memory_order_acquire);
+    if (word == nullptr) return -1;
+    // the stack grows down, so everything below the lowest word it reached still has the pattern
+    size_t untouched = 0;
+    while (untouched < stackWords && word[untouched] == STACK_PATTERN) untouched++;
+    return untouched * sizeof(uint32_t);
+}
+
+std::array<const PeriodicLoop*, PeriodicLoop::MAX_LOOPS> PeriodicLoop::getLoops() {
+    registryMutex().take();
+    const std::array<const PeriodicLoop*, MAX_LOOPS> loops = registry();
+    registryMutex().give();
+    return loops;
+}
+
+const PeriodicLoop* PeriodicLoop::find(const char* name) {
+    for (const PeriodicLoop* loop : getLoops()) {
+        if (loop != nullptr && std::strcmp(loop->getName(), name) == 0) return loop;
+    }
+    return nullptr;
+}
+
+PeriodicTask::PeriodicTask(const char* name, uint32_t period, std::function<void()> body, uint32_t priority,
+                           uint16_t stack)
+    : loop(name, period),
+      body(std::move(body)),
+      task(
+          [this, stack]() {
+              loop.watchStack(stack);
+              loop.restart();
+              while (true) {
+                  this->body();
+                  loop.wait();
+              }
+          },
+          priority, stack, name) {}
+
+PeriodicTask::~PeriodicTask() { task.remove(); }
+} // namespace lemlib
@@ -0,0 +1,53 @@
+#include <cmath>
+#define FMT_HEADER_ONLY
+#include "fmt/core.h"
+#include "lemlib/pose.hpp"
+
+lemlib::Pose::Pose(float x, float y, float theta) {
+    this->x = x;
+    this->y = y;
+    this->theta = theta;
+}
+
+lemlib::Pose lemlib::Pose::operator+(const lemlib::Pose& other) const {
+    return lemlib::Pose(this->x + other.x, this->y + other.y, this->theta);
+}
+
+lemlib::Pose lemlib::Pose::operator-(const lemlib::Pose& other) const {
+    return lemlib::Pose(this->x - other.x, this->y - other.y, this->theta);
+}
+
+float lemlib::Pose::operator*(const lemlib::Pose& other) const { return this->x * other.x + this->y * other.y; }
+
+lemlib::Pose lemlib::Pose::operator*(const float& other) const {
+    return lemlib::Pose(this->x * other, this->y * other, this->theta);
+}
+
+lemlib::Pose lemlib::Pose::operator/(const float& other) const {
+    return lemlib::Pose(this->x / other, this->y / other, this->theta);
+}
+
+lemlib::Pose lemlib::Pose::lerp(lemlib::Pose other, float t) const {
+    return lemlib::Pose(this->x + (other.x - this->x) * t, this->y + (other.y - this->y) * t, this->theta);
+}
+
+float lemlib::Pose::distance(lemlib::Pose other) const { return std::hypot(this->x - other.x, this->y - other.y); }
+
+float lemlib::Pose::angle(lemlib::Pose other) const { return std::atan2(other.y - this->y, other.x - this->x); }
+
+lemlib::Pose lemlib::Pose::rotate(float angle) const {
+    return lemlib::Pose(this->x * std::cos(angle) - this->y * std::sin(angle),
+                        this->x * std::sin(angle) + this->y * std::cos(angle), this->theta);
+}
+
+fmt::format_context::iterator fmt::formatter<lemlib::Pose>::format(const lemlib::Pose& pose,
+                                                                    fmt::format_context& ctx) const {
+    // the double brackets become single brackets
+    ctx.advance_to(fmt::format_to(ctx.out(), "lemlib::Pose {{ x: "));
+    ctx.advance_to(formatter<float>::format(pose.x, ctx));
+    ctx.advance_to(fmt::format_to(ctx.out(), ", y: "));
+    ctx.advance_to(formatter<float>::format(pose.y, ctx));
+    ctx.advance_to(fmt::format_to(ctx.out(), ", theta: "));
+    ctx.advance_to(formatter<float>::format(pose.theta, ctx));
+    return fmt::format_to(ctx.out(), " }}");
+}
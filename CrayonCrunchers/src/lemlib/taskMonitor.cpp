@@ -0,0 +1,28 @@
+#include "lemlib/taskMonitor.hpp"
+
+namespace lemlib {
+void TaskMonitor::sample() {
+    const uint64_t now = pros::micros();
+    const uint32_t elapsed = now - previousTime;
+    const std::array<const PeriodicLoop*, PeriodicLoop::MAX_LOOPS> current = PeriodicLoop::getLoops();
+    std::array<PeriodicStats, PeriodicLoop::MAX_LOOPS> stats {};
+    count = 0;
+    for (size_t i = 0; i < current.size() && current[i] != nullptr; i++) {
+        stats[i] = current[i]->getStats();
+        // loops can come and go between samples, so find this one's last sample by address. A new loop is measured
+        // from its first cycle
+        PeriodicStats before {};
+        for (size_t j = 0; j < loops.size() && loops[j] != nullptr; j++) {
+            if (loops[j] == current[i]) before = previous[j];
+        }
+        TaskUsage& task = usage[count++];
+        task.name = current[i]->getName();
+        task.busy = previousTime == 0 || elapsed == 0 ? 0 : float(stats[i].busy - before.busy) / elapsed;
+        task.stackFree = current[i]->getStackFree();
+        task.missed = stats[i].missed - before.missed;
+    }
+    loops = current;
+    previous = stats;
+    previousTime = now;
+}
+} // namespace lemlib
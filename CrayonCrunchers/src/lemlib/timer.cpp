@@ -0,0 +1,64 @@
+#include "lemlib/timer.hpp"
+#include "pros/rtos.hpp"
+
+lemlib::Timer::Timer(uint32_t time)
+    : period(time) {
+    lastTime = pros::millis();
+}
+
+uint32_t lemlib::Timer::getTimeSet() {
+    const uint32_t time = pros::millis(); // get time from RTOS
+    if (!paused) timeWaited += time - lastTime; // don't update if paused
+    lastTime = time; // update last time
+    return period;
+}
+
+uint32_t lemlib::Timer::getTimeLeft() {
+    const uint32_t time = pros::millis(); // get time from RTOS
+    if (!paused) timeWaited += time - lastTime; // don't update if paused
+    lastTime = time; // update last time
+    const int delta = period - timeWaited; // calculate how much time is left
+    return (delta > 0) ? delta : 0; // return 0 if timer is done
+}
+
+uint32_t lemlib::Timer::getTimePassed() {
+    const uint32_t time = pros::millis(); // get time from RTOS
+    if (!paused) timeWaited += time - lastTime; // don't update if paused
+    lastTime = time; // update last time;
+    return timeWaited;
+}
+
+bool lemlib::Timer::isDone() {
+    const uint32_t time = pros::millis(); // get time from RTOS
+    if (!paused) timeWaited += time - lastTime; // don't update if paused
+    lastTime = time; // update last time
+    const int delta = period - timeWaited; // calculate how much time is left
+    return delta <= 0;
+}
+
+bool lemlib::Timer::isPaused() { return paused; }
+
+void lemlib::Timer::set(uint32_t time) {
+    period = time; // set how long to wait
+    reset();
+}
+
+void lemlib::Timer::reset() {
+    timeWaited = 0;
+    lastTime = pros::millis();
+}
+
+void lemlib::Timer::pause() {
+    if (!paused) lastTime = pros::millis();
+    paused = true;
+}
+
+void lemlib::Timer::resume() {
+    if (paused) lastTime = pros::millis();
+    paused = false;
+}
+
+void lemlib::Timer::waitUntilDone() {
+    do pros::delay(5);
+    while (!this->isDone());
+}
@@ -1,5 +1,6 @@
 #include "main.h"
 #include "lemlib/api.hpp" // IWYU pragma: keep
+#include "lemlib/chassis/odom.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
 #include "pros/adi.hpp"
 #include "pros/llemu.hpp"
@@ -34,11 +35,11 @@ int autonSide = 2; // 1 is positive, -1 is negative, 0 is skills
 int autonRoute = 5;
 
 bool colorSorting = true;
-bool activated = false;
 bool detectBlockage = false;
 bool allianceStake = true;
 bool touchLadder = true;
-bool primed = false;
+bool binaryTelemetry = false; // stream binary telemetry at 100 Hz, see telemetryTask
+bool recordMatches = true; // record the same telemetry to the microSD card, a file per match
 
 // Tracking wheels
 
@@ -84,12 +85,22 @@ lemlib::ControllerSettings angularController(2, // proportional gain (kP) 4
                                              5 // maximum acceleration (slew)
 );
 
+// motion profile limits and feedforward, used by motions with .profiled = true
+lemlib::ProfileSettings profileSettings(64, // maximum velocity, in inches per second
+                                        250, // maximum acceleration, in inches per second squared
+                                        2500, // maximum jerk, in inches per second cubed
+                                        0, // static feedforward (kS)
+                                        1.84, // velocity feedforward (kV), 127 / 69 in/s top speed
+                                        0.18 // acceleration feedforward (kA)
+);
+
 // sensors for odometry
 lemlib::OdomSensors sensors(&vertical1, // vertical tracking wheel
-                            nullptr, // vertical tracking wheel 2, set to nullptr as we don't have a second one
+                            &vertical2, // vertical tracking wheel 2
                             &horizontal, // horizontal tracking wheel
                             nullptr, // horizontal tracking wheel 2, set to nullptr as we don't have a second one
-                            &imu // inertial sensor
+                            &imu, // inertial sensor
+                            lemlib::OdomMode::EKF // fuse every sensor, including the drivetrain encoders
 );
 
 // input curve for throttle input during driver control
@@ -105,7 +116,59 @@ lemlib::ExpoDriveCurve steerCurve(3, // joystick deadband out of 127
 );
 
 // create the chassis
-lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors, &throttleCurve, &steerCurve);
+lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors, &throttleCurve, &steerCurve,
+                        profileSettings);
+
+// color sorting, measured along the conveyor so it doesn't depend on its speed. The distances are what the old
+// 170 ms wait and 390 ms reverse covered at maxSpeed
+lemlib::ColorSortSettings colorSortSettings(190, // eject distance, in degrees
+                                            360, // reverse distance, in degrees
+                                            120, // ring length, in degrees
+                                            20, // optical sensor latency, in milliseconds
+                                            400, // reverse timeout, in milliseconds
+                                            0.9 // minimum confidence of the ring classifier
+);
+lemlib::ColorSort colorSort(&optical, &conveyor, colorSortSettings);
+
+// conveyor jam detection and recovery
+lemlib::JamDetectorSettings conveyorJamSettings(1800, // stall current, in mA
+                                                1.5, // stall torque, in Nm
+                                                0.15, // stall speed, out of the commanded speed
+                                                120, // jam time, in milliseconds
+                                                30, // filter time constant, in milliseconds
+                                                80, // reverse power, out of 127
+                                                300, // reverse time, in milliseconds
+                                                100, // pause time, in milliseconds
+                                                400, // retry time, in milliseconds
+                                                3, // attempts before giving up
+                                                1000 // cooldown after giving up, in milliseconds
+);
+lemlib::JamDetector conveyorJam(&conveyor, conveyorJamSettings);
+
+// rings on the conveyor, so routes can wait for them to be scored
+lemlib::RingInventorySettings ringInventorySettings(260, // score distance, in degrees
+                                                    200, // outtake distance, in degrees
+                                                    120, // ring length, in degrees
+                                                    600, // current spike, in mA
+                                                    90, // spike window, in degrees
+                                                    6 // rings a goal holds
+);
+lemlib::RingInventory rings(&conveyor, &colorSort, ringInventorySettings);
+
+// Lady Brown, held at its presets by its own task. The gear ratio, angles and positions are estimates, not yet measured
+// on the robot: score is about where the old 700 ms at full power took it. Route 3 and the driver's jog don't use them
+lemlib::ArmSettings armSettings(8, // proportional gain (kP)
+                                0, // integral gain (kI)
+                                30, // derivative gain (kD)
+                                12, // gravity feedforward, out of 127
+                                5, // gear ratio, motor turns per arm turn
+                                -60, // stowed angle, in degrees
+                                22, // primed position, in degrees
+                                150, // score position, in degrees
+                                3, // tolerance, in degrees
+                                100 // settle time, in milliseconds
+);
+lemlib::Arm ladyBrown(&arm, armSettings);
 
 /**
  * Runs initialization code. This occurs as soon as the program is started.
@@ -116,96 +179,34 @@ lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors
 
  int maxSpeed = 120;
  int conveyorSpeed = maxSpeed;
- int speedUp = -700;
- int speedUp2 = 0;
  int spinConveyor = 0;
+ // the driver raised the arm to catch a ring
+ bool primed = false;
  
- int Clock = 100;
- int counter = 0;
- 
+ // runs every 10 ms, see conveyorTask
  void conveyorChecking() {
-     while (true) {
-         conveyorSpeed = maxSpeed;
- 
-         // fix conveyor if stuck
-         if (detectBlockage && !primed) {
-             if (Clock > 0) {
-                 Clock --;
-             } else {
-                 Clock = 500;
-                 counter = 0;
-             }
- 
-             if (abs(conveyor.get_target_velocity()) > 0 && abs(conveyor.get_actual_velocity()) < 10) {
-                 counter ++;
-             }
- 
-             //controller.print(0,0, ": %8.2f", counter);
- 
-             if (counter > 12) {
-                 controller.rumble(".");
-                 conveyor.move(-80);
-                 pros::delay(500);
-                 conveyor.move(0);
-                 Clock = 0;
-             }
-         }
- 
-         // Optical Sensing
-         if (speedUp > -100) {
-             speedUp --;
-         }
+     conveyorSpeed = maxSpeed;
  
-         if (speedUp < 0 && speedUp > -40) {
-             conveyorSpeed = -100;
-         }
-         if (speedUp < -80) {
-            activated = false;
-        }
- 
-         if (speedUp2 > 0) {
-             speedUp2 --;
-             conveyorSpeed = maxSpeed;
-         }
- 
-         optical.set_led_pwm(100);
-         if (colorSorting && !activated && optical.get_saturation() > 0.2) {
-             // color sorting
-             if (alliance && ((optical.get_hue() > 345) || (optical.get_hue() < 15))) {
-                 speedUp = 17;
-                 activated = true;
-             }
-             if (!alliance && ((optical.get_hue() > 210) && (optical.get_hue() < 230))) {
-                 speedUp = 17;
-                 activated = true;
-             }
-             
-             // speed up
-             /*if (!alliance && ((optical.get_hue() > 345) || (optical.get_hue() < 15))) {
-                 speedUp2 = 23;
-             }
-             if (alliance && ((optical.get_hue() > 210) && (optical.get_hue() < 230))) {
-                 speedUp2 = 23;
-             }*/
-         }
+     // Optical Sensing, throw off rings of the other alliance's color
+     const lemlib::RingColor rejected = alliance ? lemlib::RingColor::RED : lemlib::RingColor::BLUE;
+     if (colorSort.update(colorSorting ? rejected : lemlib::RingColor::NONE)) {
+         conveyorSpeed = -100;
+     }
+     rings.update();
  
-         // Spin conveyor
-         switch (spinConveyor) {
-             case 1:
-                 conveyor.move(conveyorSpeed);
-                 intake.move(conveyorSpeed);
-                 break;
-             case -1:
-                 conveyor.move(-conveyorSpeed);
-                 intake.move(-conveyorSpeed);
-                 break;
-             case 0:
-                 conveyor.move(0);
-                 intake.move(0);
-                 break;
-         }
+     // Spin conveyor
+     const int power = spinConveyor * conveyorSpeed;
+     intake.move(power);
  
-         pros::delay(10);
+     // fix conveyor if stuck. Clearing a jam takes a step each cycle, so color sorting keeps going
+     // a primed arm holds the ring back on purpose, so it isn't a jam
+     if (detectBlockage && !primed && ladyBrown.getPreset() != lemlib::ArmPreset::PRIMED) {
+         const uint32_t jams = conveyorJam.getStats().jams;
+         conveyor.move(conveyorJam.update(power));
+         if (conveyorJam.getStats().jams != jams) controller.rumble(".");
+     } else {
+         conveyorJam.reset();
+         conveyor.move(power);
      }
  }
 
@@ -266,7 +267,10 @@ void initialize() {
     chassis.calibrate(); // calibrate sensors
     pros::delay(3000);
 
-    pros::Task conveyor_task(conveyorChecking);
+    // static, so the tasks outlive initialize
+    colorSort.initialize();
+    ladyBrown.initialize();
+    static lemlib::PeriodicTask conveyorTask("conveyor", 10, conveyorChecking);
 
     pros::lcd::register_btn0_cb(on_left_button); // alliance color
     pros::lcd::register_btn1_cb(on_center_button); // auton path
@@ -285,25 +289,121 @@ void initialize() {
     // works, refer to the fmtlib docs
 
     // thread to for brain screen and position logging
-    pros::Task screenTask([&]() {
-        while (true) {
-            // print robot location to the brain screen
-            pros::lcd::print(0, "X: %.3f", chassis.getPose().x); // x
-            pros::lcd::print(1, "Y: %.3f", chassis.getPose().y); // y
-            pros::lcd::print(2, "Theta: %.3f", chassis.getPose().theta); // heading
-
-            // log position telemetry
-            lemlib::telemetrySink()->info("Chassis pose: {}", chassis.getPose());
-            // delay to save resources
-            pros::delay(50);
-        }
+    // every 50 ms to save resources
+    static lemlib::PeriodicTask screenTask("screen", 50, []() {
+        // read the pose once so x, y and theta all come from the same odom update
+        const lemlib::Pose pose = lemlib::getPoseSnapshot().pose;
+
+        // print robot location to the brain screen
+        pros::lcd::print(0, "X: %.3f", pose.x); // x
+        pros::lcd::print(1, "Y: %.3f", pose.y); // y
+        pros::lcd::print(2, "Theta: %.3f", pose.theta); // heading
+
+        // log position telemetry
+        lemlib::telemetrySink()->info("Chassis pose: {}", pose);
     });
+
+    // binary telemetry for plotting. Capture the serial output, or copy the files off the microSD card, and decode
+    // them with sim/app/telemetry_decode
+    if (binaryTelemetry) lemlib::telemetrySink()->setBinary(true);
+    const bool recording = recordMatches && lemlib::recorderSink()->start();
+    // the same channels go to both sinks. Each does nothing unless it is on
+    auto define = [](uint8_t channel, std::string_view name, std::initializer_list<std::string_view> fields) {
+        lemlib::telemetrySink()->defineChannel(channel, name, fields);
+        lemlib::recorderSink()->defineChannel(channel, name, fields);
+    };
+    auto send = [](uint8_t channel, const auto&... values) {
+        lemlib::telemetrySink()->send(channel, values...);
+        lemlib::recorderSink()->send(channel, values...);
+    };
+    if (binaryTelemetry || recording) {
+        define(1, "pose", {"x", "y", "theta"});
+        define(2, "current",
+               {"left1", "left2", "left3", "right1", "right2", "right3", "conveyor", "intake", "arm"});
+        define(3, "conveyor", {"state", "velocity"});
+        define(4, "pid", {"lateralP", "lateralI", "lateralD", "angularP", "angularI", "angularD"});
+        define(6, "jam", {"state", "current", "velocityError", "jams", "retries", "cleared", "gaveUp"});
+        define(8, "rings", {"held", "intaken", "scored", "confirmed", "ejected", "outtaken", "onGoal"});
+        define(9, "arm", {"preset", "target", "position", "power"});
+        // every optical sensor reading, labelled while calibrating, for sim/app/ring_classifier
+        define(7, "optical", {"red", "green", "blue", "brightness", "hue", "saturation", "proximity", "color",
+                              "confidence", "label"});
+        static lemlib::PeriodicTask telemetryTask("telemetry", 10, [=]() {
+            const lemlib::Pose pose = lemlib::getPoseSnapshot().pose;
+            send(1, pose.x, pose.y, pose.theta);
+            send(2, leftMotors.get_current_draw(0), leftMotors.get_current_draw(1), leftMotors.get_current_draw(2),
+                 rightMotors.get_current_draw(0), rightMotors.get_current_draw(1), rightMotors.get_current_draw(2),
+                 conveyor.get_current_draw(), intake.get_current_draw(), arm.get_current_draw());
+            send(3, spinConveyor, conveyor.get_actual_velocity());
+            const lemlib::PID::Terms lateral = chassis.lateralPID.getTerms();
+            const lemlib::PID::Terms angular = chassis.angularPID.getTerms();
+            send(4, lateral.proportional, lateral.integral, lateral.derivative, angular.proportional,
+                 angular.integral, angular.derivative);
+            const lemlib::JamStats& jamStats = conveyorJam.getStats();
+            send(6, lemlib::toString(conveyorJam.getState()), conveyorJam.getCurrent(), conveyorJam.getVelocityError(),
+                 jamStats.jams, jamStats.retries, jamStats.cleared, jamStats.gaveUp);
+            const lemlib::RingCounts ringCounts = rings.getCounts();
+            send(8, ringCounts.held, ringCounts.intaken, ringCounts.scored, ringCounts.confirmed, ringCounts.ejected,
+                 ringCounts.outtaken, ringCounts.onGoal);
+            const lemlib::ArmPreset armPreset = ladyBrown.getPreset();
+            send(9, lemlib::toString(armPreset), ladyBrown.getTarget(armPreset), ladyBrown.getPosition(),
+                 ladyBrown.getPower());
+            // the sensor reports every 20 ms, so only send new readings
+            static uint32_t lastReading = 0;
+            const lemlib::ColorReading reading = colorSort.getReading();
+            if (reading.time != lastReading) {
+                lastReading = reading.time;
+                const lemlib::OpticalSample& sample = reading.sample;
+                send(7, sample.red, sample.green, sample.blue, sample.brightness, sample.hue, sample.saturation,
+                     sample.proximity, lemlib::toString(reading.ring.color), reading.ring.confidence, reading.label);
+            }
+        });
+        define(5, "task", {"name", "busy", "stackFree"});
+    }
+
+    // how busy every task is and how much of its stack it uses, once a second. The screen shows one task at a time.
+    // Busy time counts time other tasks preempted it, so it isn't CPU use and isn't summed
+    static lemlib::TaskMonitor monitor;
+    static int shownTask = 0;
+    static lemlib::PeriodicTask monitorTask(
+        "monitor", 1000,
+        [=]() {
+            monitor.sample();
+            if (monitor.getCount() == 0) return;
+            shownTask = (shownTask + 1) % monitor.getCount();
+            const lemlib::TaskUsage& shown = monitor.getUsage()[shownTask];
+            // loops that aren't tasks of their own, like the motions, don't watch a stack
+            if (shown.stackFree < 0) {
+                pros::lcd::print(6, "%s %.1f%% busy", shown.name, shown.busy * 100);
+            } else {
+                pros::lcd::print(6, "%s %.1f%% busy | %.1fKB free", shown.name, shown.busy * 100,
+                                 shown.stackFree / 1024.0);
+            }
+            if (!binaryTelemetry && !recording) return;
+            for (int i = 0; i < monitor.getCount(); i++) {
+                const lemlib::TaskUsage& usage = monitor.getUsage()[i];
+                send(5, usage.name, usage.busy * 100, usage.stackFree);
+            }
+        },
+        TASK_PRIORITY_MIN + 1);
 }
 
 /**
  * Runs while the robot is disabled
  */
-void disabled() {}
+void disabled() {
+    // record how well every loop kept to its period, then get what was recorded onto the card before the robot is
+    // turned off, since the match may be over
+    for (const lemlib::PeriodicLoop* loop : lemlib::PeriodicLoop::getLoops()) {
+        if (loop == nullptr) break;
+        const lemlib::PeriodicStats stats = loop->getStats();
+        lemlib::recorderSink()->warn("loop {} {} ms: {} runs, {} missed, max jitter {} us, max execution {} us",
+                                     loop->getName(), loop->getPeriod(), stats.runs, stats.missed, stats.maxJitter,
+                                     stats.maxExecution);
+    }
+    if (lemlib::recorderSink()->isRecording() && !lemlib::recorderSink()->flush())
+        lemlib::infoSink()->warn("Recorder fell behind, the end of the match may not be on the card");
+}
 
 /**
  * runs after initialize if the robot is connected to field control
@@ -320,8 +420,13 @@ ASSET(example_txt); // '.' replaced with "_" to make c++ happy
  * This is an example autonomous routine which demonstrates a lot of the features LemLib has to offer
  */
 void autonomous() {
+    // every match starts with auton, so record each one in its own file
+    lemlib::recorderSink()->rotate();
+    lemlib::recorderSink()->warn("auton side {} alliance {}", autonSide, alliance ? "blue" : "red");
+
     int def = 1500;
     int pickupTime = 2500;
+    lemlib::RingCounts before; // rings counted before a grab, to tell when the ring grabbed is scored
     detectBlockage = true;
 
     conveyor.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
@@ -344,38 +449,37 @@ void autonomous() {
             //pros::delay(3000);
             elevation.set_value(true);
             chassis.setPose(54, 10.4, 90);
+            ladyBrown.resetPosition(lemlib::ArmPreset::STOWED);
             if (allianceStake) {
-                arm.move(7);
                 chassis.turnToHeading(130, def);
                 chassis.moveToPose(64, 3, 130, 2000, {.maxSpeed = 35});
                 chassis.waitUntilDone();
                 pros::delay(500);
 
-                arm.move(120);
-                pros::delay(700);
-                arm.move(0);
+                ladyBrown.moveTo(lemlib::ArmPreset::SCORE);
+                ladyBrown.waitUntilSettled(700);
                 pros::delay(200);
-                arm.move(-120);
-                pros::delay(700);
-                arm.move(0);
+                ladyBrown.moveTo(lemlib::ArmPreset::STOWED);
+                ladyBrown.waitUntilSettled(700);
             }
             
             chassis.moveToPose(20, 25, 116, 3000, {.forwards = false, .maxSpeed = 75});
-            chassis.waitUntil(38);
-            latch.set_value(true);
+            chassis.addMarker(lemlib::MarkerTrigger::DISTANCE, 38, [] { latch.set_value(true); });
             //pros::delay(50);
             chassis.turnToHeading(5, def);
             spinConveyor = 1;
 
-            // grabs
+            // grabs. The ring grabbed is scored after every ring already on the conveyor
+            before = rings.getCounts();
             chassis.moveToPose(34, 54, 0, 2000);
 
             if (touchLadder) {
                 //chassis.moveToPose(24, 48, 4, def);
-                pros::delay(2500);
+                chassis.waitUntilDone();
+                if (rings.waitUntilIntaken(before.intaken + 1, 1000))
+                    rings.waitUntilScored(before.scored + before.held + 1, 2500);
                 chassis.moveToPose(22.4, 5, 353, 2500, {.forwards = false});
-                chassis.waitUntil(15);
-                spinConveyor = 0;
+                chassis.addMarker(lemlib::MarkerTrigger::DISTANCE, 15, [] { spinConveyor = 0; });
             } else {
                 chassis.turnToHeading(50, def);
                 chassis.moveToPose(64.5, 67, 35, def);
@@ -415,16 +519,15 @@ void autonomous() {
             // alliance stake
             //pros::delay(3000);
             chassis.setPose(-50, 11.2, 242);
+            ladyBrown.resetPosition(lemlib::ArmPreset::STOWED);
             chassis.moveToPose(-69, 0, 240, 2000, {.maxSpeed = 47});
             pros::delay(900);
-            arm.move(120);
-            pros::delay(700);
-            arm.move(-120);
-            pros::delay(500);
-            arm.move(0);
+            ladyBrown.moveTo(lemlib::ArmPreset::SCORE);
+            ladyBrown.waitUntilSettled(700);
+            ladyBrown.moveTo(lemlib::ArmPreset::STOWED);
+            ladyBrown.waitUntilSettled(500);
             chassis.moveToPose(-20, 25, 244, 2500, {.forwards = false, .maxSpeed = 80});
-            chassis.waitUntil(36);
-            latch.set_value(true);
+            chassis.addMarker(lemlib::MarkerTrigger::DISTANCE, 36, [] { latch.set_value(true); });
             //pros::delay(50);
             chassis.turnToHeading(0, def);
             spinConveyor = 1;
@@ -479,16 +582,18 @@ void autonomous() {
             chassis.setPose(-50, -11.2, 298);
             chassis.moveToPose(-69, -2, 295, 2000, {.maxSpeed = 47});
             pros::delay(1000);
-            arm.move(-120);
+            // the arm starts raised, so it is driven down against its hard stop by hand, and zeroed there
+            ladyBrown.move(-120);
             pros::delay(600);
-            arm.move(0);
+            ladyBrown.resetPosition(lemlib::ArmPreset::STOWED);
             pros::delay(500);
             chassis.moveToPose(-20, -24, 296, 2500, {.forwards = false, .maxSpeed = 70});
+            chassis.addMarker(lemlib::MarkerTrigger::DISTANCE, 36, [] { latch.set_value(true); });
             chassis.waitUntil(36);
-            latch.set_value(true);
-            arm.move(120);
+            // then raised by hand, and left up
+            ladyBrown.move(120);
             pros::delay(1000);
-            arm.move(0);
+            ladyBrown.move(0);
             chassis.turnToHeading(180, def);
             spinConveyor = 1;
 
@@ -523,36 +628,35 @@ void autonomous() {
             // 180deg-x
             elevation.set_value(true);
             chassis.setPose(54, -10.4, 90);
+            ladyBrown.resetPosition(lemlib::ArmPreset::STOWED);
             if (allianceStake) {
-                arm.move(7);
                 chassis.turnToHeading(50, def);
                 chassis.moveToPose(71, -1, 50, 2000, {.maxSpeed = 45});
                 chassis.waitUntilDone();
                 pros::delay(300);
 
-                arm.move(120);
-                pros::delay(700);
-                arm.move(0);
+                ladyBrown.moveTo(lemlib::ArmPreset::SCORE);
+                ladyBrown.waitUntilSettled(700);
                 pros::delay(200);
-                arm.move(-120);
-                pros::delay(700);
-                arm.move(0);
+                ladyBrown.moveTo(lemlib::ArmPreset::STOWED);
+                ladyBrown.waitUntilSettled(700);
             }
             chassis.moveToPose(20, -25, 64, 3000, {.forwards = false, .maxSpeed = 75});
-            chassis.waitUntil(38);
-            latch.set_value(true);
+            chassis.addMarker(lemlib::MarkerTrigger::DISTANCE, 38, [] { latch.set_value(true); });
             //pros::delay(50);
             chassis.turnToHeading(175, def);
             spinConveyor = 1;
 
-            // grabs
+            // grabs. The ring grabbed is scored after every ring already on the conveyor
+            before = rings.getCounts();
             chassis.moveToPose(14, -48, 180, 2000);
 
             if (touchLadder) {
-                pros::delay(2500);
+                chassis.waitUntilDone();
+                if (rings.waitUntilIntaken(before.intaken + 1, 1000))
+                    rings.waitUntilScored(before.scored + before.held + 1, 2500);
                 chassis.moveToPose(6, 2, 175, 2500, {.forwards = false});
-                chassis.waitUntil(15);
-                spinConveyor = 0;
+                chassis.addMarker(lemlib::MarkerTrigger::DISTANCE, 15, [] { spinConveyor = 0; });
             } else {
                 chassis.turnToHeading(290, def);
                 chassis.moveToPose(48, -54, 280, def, {.forwards = false});
@@ -570,11 +674,11 @@ void autonomous() {
         case 5:
             def = 2000;
             chassis.setPose(-60.7, 0, 270);
-            arm.move(120);
-            pros::delay(850);
-            arm.move(-120);
-            pros::delay(500);
-            arm.move(0);
+            ladyBrown.resetPosition(lemlib::ArmPreset::STOWED);
+            ladyBrown.moveTo(lemlib::ArmPreset::SCORE);
+            ladyBrown.waitUntilSettled(850);
+            ladyBrown.moveTo(lemlib::ArmPreset::STOWED);
+            ladyBrown.waitUntilSettled(500);
             chassis.moveToPose(-47, -17, 0, 2500, {.forwards = false});
             chassis.waitUntilDone();
             latch.set_value(true);
@@ -606,9 +710,7 @@ void autonomous() {
             chassis.moveToPose(-53, -8, 0, 3000);
             chassis.turnToHeading(180, def);
             chassis.moveToPose(-46, 20, 180, 3000, {.forwards = false, .maxSpeed = 70});
-            chassis.waitUntil(27);
-            latch.set_value(true);
-            pros::delay(100);
+            chassis.addMarker(lemlib::MarkerTrigger::DISTANCE, 27, [] { latch.set_value(true); });
             
             chassis.turnToHeading(0, def);
             spinConveyor = 1;
@@ -706,12 +808,100 @@ void autonomous() {
  * Runs in driver control
  */
 
-bool toggle = false;
-bool toggle2 = false;
-bool toggle3 = true;
-bool toggle4 = false;
-bool toggle5 = false;
-bool toggle6 = false;
+// what driver control macros drive, as bit flags, so two can't drive the same thing at once
+constexpr uint32_t ARM_RESOURCE = 1 << 0;
+constexpr uint32_t CONVEYOR_RESOURCE = 1 << 1;
+
+// macros run a step each loop, so driving never waits for them
+lemlib::MacroScheduler macros;
+lemlib::Macro stowMacro = lemlib::Macro("stow", ARM_RESOURCE).then([] { ladyBrown.moveTo(lemlib::ArmPreset::STOWED); });
+// the conveyor runs backwards for a moment while the arm scores, to let go of the ring. The driver's controls take
+// it back once the macro ends or is cancelled
+lemlib::Macro scoreMacro = lemlib::Macro("score", ARM_RESOURCE | CONVEYOR_RESOURCE)
+                               .then([] {
+                                   ladyBrown.moveTo(lemlib::ArmPreset::SCORE);
+                                   spinConveyor = -1;
+                               })
+                               .wait(600);
+
+// letting go of a jog holds the arm, unless a preset was picked while it was held
+void stopJog() {
+    if (ladyBrown.getPreset() == lemlib::ArmPreset::MANUAL) ladyBrown.move(0);
+}
+
+int calibrationStep = 0;
+
+// Ring color calibration, off the field. Each press moves on: nothing in front of the sensor, a red ring, a blue ring,
+// then fit and save
+void calibrateRingColors() {
+    if (pros::competition::is_connected()) return;
+    switch (calibrationStep) {
+        case 0:
+            colorSort.calibrate(lemlib::RingColor::NONE);
+            controller.print(0, 0, "cal: nothing      ");
+            break;
+        case 1:
+            colorSort.calibrate(lemlib::RingColor::RED);
+            controller.print(0, 0, "cal: red ring     ");
+            break;
+        case 2:
+            colorSort.calibrate(lemlib::RingColor::BLUE);
+            controller.print(0, 0, "cal: blue ring    ");
+            break;
+        case 3: {
+            const bool fitted = colorSort.finishCalibration();
+            controller.print(0, 0, fitted ? "cal: saved        " : "cal: failed       ");
+            break;
+        }
+    }
+    calibrationStep = (calibrationStep + 1) % 4;
+}
+
+// every control of driver control but the joysticks and the conveyor, in one place to remap per driver. The conveyor
+// is driven in opcontrol, from R1, R2 and the Y toggle
+lemlib::ControllerBindings driverControls(&controller, {
+    // mogo latch, open while held
+    {DIGITAL_L2, lemlib::Trigger::HOLD, [](bool held) {
+        latch.set_value(!held);
+        if (held) rings.resetGoal();
+    }},
+    // flag
+    {DIGITAL_L1, lemlib::Trigger::TOGGLE, [](bool on) { elevation.set_value(on); }},
+    // Lady Brown. LEFT and DOWN jog it while held, and it holds where it is let go, until the presets are measured on
+    // the robot. Jogging or a new preset cancels scoring, and the conveyor with it
+    {DIGITAL_LEFT, lemlib::Trigger::PRESS, [] {
+        macros.cancel(ARM_RESOURCE);
+        primed = true;
+        ladyBrown.move(50);
+    }},
+    {DIGITAL_LEFT, lemlib::Trigger::RELEASE, stopJog},
+    {DIGITAL_DOWN, lemlib::Trigger::PRESS, [] {
+        macros.cancel(ARM_RESOURCE);
+        primed = false;
+        ladyBrown.move(-50);
+    }},
+    {DIGITAL_DOWN, lemlib::Trigger::RELEASE, stopJog},
+    {DIGITAL_RIGHT, lemlib::Trigger::PRESS, [] {
+        primed = false;
+        macros.start(stowMacro);
+    }},
+    {DIGITAL_UP, lemlib::Trigger::PRESS, [] {
+        primed = false;
+        macros.start(scoreMacro);
+    }},
+    // elevation mech
+    {DIGITAL_A, lemlib::Trigger::TOGGLE, [](bool on) { pto.set_value(on); }},
+    // color sorting, on to start with
+    {DIGITAL_X, lemlib::Trigger::TOGGLE, [](bool on) {
+        colorSorting = on;
+        controller.rumble(on ? "-" : "..");
+    }, true},
+    {DIGITAL_B, lemlib::Trigger::PRESS, calibrateRingColors},
+    // the driver takes the conveyor back from a macro by using it. Y toggles the intake & conveyor on
+    {DIGITAL_R1, lemlib::Trigger::PRESS, [] { macros.cancel(CONVEYOR_RESOURCE); }},
+    {DIGITAL_R2, lemlib::Trigger::PRESS, [] { macros.cancel(CONVEYOR_RESOURCE); }},
+    {DIGITAL_Y, lemlib::Trigger::TOGGLE, [](bool) { macros.cancel(CONVEYOR_RESOURCE); }},
+}, {pros::E_CONTROLLER_ANALOG_LEFT_Y, pros::E_CONTROLLER_ANALOG_RIGHT_X}); // the joysticks opcontrol drives with
 
 void opcontrol() {
     // set up
@@ -720,127 +910,35 @@ void opcontrol() {
     elevation.set_value(false);
 
     conveyor.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-    arm.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-
-    while (true) {
-        // get joystick positions
-        int leftY = controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
-        int rightX = controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X);
-
-        chassis.arcade(leftY, rightX, 2.7);
-
-        // Pneumatics (Press to activate)
-        if (controller.get_digital(DIGITAL_L2)) {
-            latch.set_value(false);
-        } else {
-            latch.set_value(true);
-        }
-
-        // Flag
-        if (controller.get_digital_new_press(DIGITAL_L1)) {
-            elevation.set_value(!toggle5);    // When false go to true and in reverse
-            toggle5 = !toggle5;    // Flip the toggle to match piston state
-        }
-
-        // Primer
-
-        /*if (controller.get_digital_new_press(DIGITAL_LEFT)) {
-            primed = !primed;
-            arm.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-
-            if (primed) {
-                //int desired_position = -310;
-                //arm.move_absolute(desired_position, 40); // Moves 100 units forward
-                //while (!((arm.get_position() < desired_position+5) && (arm.get_position() > desired_position-5))) {
-                //    pros::delay(2);
-                //}
-                //arm = -50;
-                //pros::delay(500);
-            } else {
-                arm = 50;
-                pros::delay(500);
-                arm = 0;
-            }
-            
-        }
-        if (primed) {
-            arm = -5;
-        }*/
-
-        // Lady Brown
-        if (controller.get_digital(DIGITAL_LEFT)) {
-            primed = true;
-            arm.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-            arm.move(50);
-        } else if (controller.get_digital(DIGITAL_DOWN)) {
-            primed = false;
-            arm.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
-            arm.move(-50);
-        } else {
-            if (primed) {
-                arm.move(5);
-            } else {
-                arm.move(0);
-            }
-        }
-        if (controller.get_digital_new_press(DIGITAL_UP)) {
-            primed = false;
-            arm.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
+    // hold the arm wherever autonomous left it
+    ladyBrown.move(0);
 
-            spinConveyor = -1;
-            arm.move(120);
-            pros::delay(600);
-            spinConveyor = 0;
-            arm.move(0);
-            //arm = 80;
-            //pros::delay(300);
-        }
-        if (controller.get_digital_new_press(DIGITAL_RIGHT)) {
-            primed = false;
-            arm.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
+    // static, since PROS deletes this task when the mode changes
+    static lemlib::PeriodicLoop loop("opcontrol", 10);
+    // one left over from the last time driver control ran, cut off by PROS, is cancelled
+    macros.cancelAll();
 
-            arm.move(-120);
-            pros::delay(400);
-            arm.move(0);
-        }
+    loop.restart();
+    while (true) {
+        // every button and joystick in use is read once, and the bindings they trigger run
+        const lemlib::ControllerSnapshot& input = driverControls.update();
 
-        // Elevation Mech
-        if (controller.get_digital_new_press(DIGITAL_A)) {
-            pto.set_value(!toggle6);
-            toggle6 = !toggle6;
-        }
+        chassis.arcade(input.get(pros::E_CONTROLLER_ANALOG_LEFT_Y), input.get(pros::E_CONTROLLER_ANALOG_RIGHT_X), 2.7);
 
-        // Disable color sorting (inactive)
-        if (controller.get_digital_new_press(DIGITAL_X)) {
-            if (toggle3) {
-                colorSorting = false;
-                controller.rumble("..");
+        // Conveyor motor (max is ±127), unless a macro is driving it
+        if (macros.isFree(CONVEYOR_RESOURCE)) {
+            if (driverControls.isToggled(DIGITAL_Y)) {
+                spinConveyor = 1;
+            } else if (input.isHeld(DIGITAL_R1)) {
+                spinConveyor = -1;
+            } else if (input.isHeld(DIGITAL_R2)) {
+                spinConveyor = 1;
             } else {
-                colorSorting = true;
-                controller.rumble("-");
+                spinConveyor = 0;
             }
-            toggle3 = !toggle3;
-        }
-
-        // Conveyor motor (max is ±127)
-        if (controller.get_digital(DIGITAL_R1)) {
-            spinConveyor = -1;
-        } else if (controller.get_digital(DIGITAL_R2)) {
-            spinConveyor = 1;
         }
 
-        // intake & conveyor toggle
-        if (controller.get_digital_new_press(DIGITAL_Y)) {
-            toggle2 = !toggle2;
-        }
-        if (toggle2) {
-            spinConveyor = 1;
-        }
-
-        if (!toggle2 && !controller.get_digital(DIGITAL_R1) && !controller.get_digital(DIGITAL_R2)) {
-            spinConveyor = 0;
-        }
-        
-        pros::delay(10);
+        macros.update();
+        loop.wait();
     }
 }